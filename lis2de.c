@@ -1,9 +1,8 @@
 #include "lib/lis2de-driver/include/lis2de.h"
-#include "lib/i2cmaster/include/i2cmaster.h"
-#include "CException.h"
 
-/* I2C device slave adddress of LIS2DE: */
-static const uint8_t LIS2DE_ADDR = 0x50U;
+#if LIS2DE_USE_CEXCEPTION
+#include "CException.h"
+#endif
 
 typedef struct reg
 {
@@ -13,6 +12,10 @@ typedef struct reg
 
 static const reg_t STATUS_AUX_REG   = {0x07, 1};
 static const reg_t OUT_TEMP_REG     = {0x0C, 2};
+
+/* STATUS_AUX up to OUT_TEMP_H, the reserved registers 0x08..0x0B in
+ * between are read and dropped */
+static const reg_t TEMP_BURST_REG   = {0x07, 7};
 static const reg_t INT_COUNTER_REG  = {0x0E, 1};
 static const reg_t WHO_AM_I_REG     = {0x0F, 1};
 static const reg_t TEMP_CFG_REG     = {0x1F, 1};
@@ -31,6 +34,13 @@ static const reg_t OUT_REG_X        = {0x29, 1};
 static const reg_t OUT_REG_Y        = {0x2B, 1};
 static const reg_t OUT_REG_Z        = {0x2D, 1};
 
+/* The unused low bytes 0x28, 0x2A and 0x2C sit between the axis
+ * registers, reading 0x28..0x2D in one burst yields a full frame */
+static const reg_t OUT_REG_XYZ      = {0x28, 6};
+
+// STATUS_REG2 followed by a full frame
+static const reg_t STATUS_XYZ_REG   = {0x27, 7};
+
 static const reg_t FIFO_CTRL_REG    = {0x2E, 1};
 static const reg_t FIFO_SRC_REG     = {0x2F, 1};
 
@@ -70,7 +80,6 @@ static const bitmask_t BITMASK_5       = {0b00100000, 5};
 static const bitmask_t BITMASK_6       = {0b01000000, 6};
 static const bitmask_t BITMASK_7       = {0b10000000, 7};
 
-static const bitmask_t BITMASK_765     = {0b11100000, 5};
 static const bitmask_t BITMASK_7654    = {0b11110000, 4};
 static const bitmask_t BITMASK_6543210 = {0b01111111, 0};
 static const bitmask_t BITMASK_76      = {0b11000000, 6};
@@ -88,188 +97,1044 @@ static const uint8_t HPF_MODE_NORMAL     = 0b00;
 static const uint8_t HPF_MODE_REFERENCE  = 0b01;
 static const uint8_t HPF_MODE_AUTO_RESET = 0b11;
 
+uint32_t
+lis2de_query_micros(lis2de_dev_t *dev)
+{
+    uint32_t res = 0;
+
+    if (dev->bus->ops->micros)
+    {
+        res = dev->bus->ops->micros(dev->bus->ctx);
+    }
+    return res;
+}
+
 static void
-lis2de_read_bytes(uint8_t bytes_to_read,
+lis2de_account(lis2de_dev_t *dev,
+               const uint8_t reg,
+               const uint8_t bytes_read,
+               const uint8_t bytes_written,
+               const uint32_t start,
+               const uint8_t err)
+{
+#if LIS2DE_STATS
+    lis2de_stats_t *stats = &dev->stats;
+
+    stats->transactions++;
+    stats->bytes_read += bytes_read;
+    stats->bytes_written += bytes_written;
+    stats->bus_time_us += lis2de_query_micros(dev) - start;
+    if (err)
+    {
+        stats->errors++;
+    }
+    stats->reg_accesses[reg & 0x3F]++;
+#else
+    (void) dev;
+    (void) reg;
+    (void) bytes_read;
+    (void) bytes_written;
+    (void) start;
+    (void) err;
+#endif
+}
+
+/* Report a failure. The first error of a device is kept; with
+ * CException it is thrown right away, otherwise it parks the device
+ * until lis2de_clear_error(). Returns err for status returns. */
+static uint8_t
+lis2de_fail(lis2de_dev_t *dev,
+            const uint8_t err)
+{
+    if (!dev->error)
+    {
+        dev->error = err;
+    }
+#if LIS2DE_USE_CEXCEPTION
+    Throw(err);
+#endif
+    return err;
+}
+
+// Without CException a failed device skips all further bus traffic
+static uint8_t
+lis2de_failed(lis2de_dev_t *dev)
+{
+    return !LIS2DE_USE_CEXCEPTION && dev->error;
+}
+
+/* A timed out transfer may leave a slave driving SDA, so the bus is
+ * recovered before the error is raised. */
+static uint8_t
+lis2de_bus_failed(lis2de_dev_t *dev,
+                  const uint8_t err)
+{
+    if (err == E_LIS2DE_I2C_TIMEOUT)
+    {
+#if LIS2DE_STATS
+        dev->stats.timeouts++;
+#endif
+        if (dev->bus->ops->recover)
+        {
+            dev->bus->ops->recover(dev->bus->ctx);
+        }
+    }
+    return lis2de_fail(dev, err);
+}
+
+static uint8_t
+lis2de_bus_read(lis2de_dev_t *dev,
+                const uint8_t reg,
+                uint8_t *buf,
+                const uint8_t len)
+{
+    uint32_t start;
+    uint8_t err;
+
+    if (lis2de_failed(dev))
+    {
+        for (uint8_t i = 0; i < len; i++)
+        {
+            buf[i] = 0;
+        }
+        return dev->error;
+    }
+
+    start = LIS2DE_STATS ? lis2de_query_micros(dev) : 0;
+    err = dev->bus->ops->read(dev->bus->ctx, dev->addr, reg,
+                              buf, len, dev->timeout_us);
+
+    lis2de_account(dev, reg, len, 0, start, err);
+    if (err)
+    {
+        return lis2de_bus_failed(dev, err);
+    }
+    return 0;
+}
+
+static uint8_t
+lis2de_bus_write(lis2de_dev_t *dev,
+                 const uint8_t reg,
+                 const uint8_t *buf,
+                 const uint8_t len)
+{
+    uint32_t start;
+    uint8_t err;
+
+    if (lis2de_failed(dev))
+    {
+        return dev->error;
+    }
+
+    start = LIS2DE_STATS ? lis2de_query_micros(dev) : 0;
+    err = dev->bus->ops->write(dev->bus->ctx, dev->addr, reg,
+                               buf, len, dev->timeout_us);
+
+    lis2de_account(dev, reg, 0, len, start, err);
+    if (err)
+    {
+        return lis2de_bus_failed(dev, err);
+    }
+    return 0;
+}
+
+static uint8_t
+lis2de_read_bytes(lis2de_dev_t *dev,
+                  uint8_t bytes_to_read,
                   const uint8_t reg,
                   uint8_t *res)
 {
     if (bytes_to_read > 0)
     {
-        i2c_start_wait(LIS2DE_ADDR + I2C_WRITE);
-
         // In order to read multiple bytes, MSB of reg must be 1
         uint8_t reg_multi_bytes_read = (reg | (1 << 7));
-        if (i2c_write(reg_multi_bytes_read))
+        return lis2de_bus_read(dev, reg_multi_bytes_read, res, bytes_to_read);
+    }
+    return 0;
+}
+
+static uint8_t
+lis2de_read_byte(lis2de_dev_t *dev,
+                 const uint8_t reg)
+{
+    uint8_t res = 0;
+    lis2de_bus_read(dev, reg, &res, 1);
+    return res;
+}
+
+static uint8_t
+lis2de_write_byte(lis2de_dev_t *dev,
+                  const uint8_t reg,
+                  const uint8_t val)
+{
+    return lis2de_bus_write(dev, reg, &val, 1);
+}
+
+static uint8_t
+lis2de_write_bytes(lis2de_dev_t *dev,
+                   uint8_t bytes_to_write,
+                   const uint8_t reg,
+                   const uint8_t *val)
+{
+    if (bytes_to_write > 0)
+    {
+        // In order to write multiple bytes, MSB of reg must be 1
+        uint8_t reg_multi_bytes_write = (reg | (1 << 7));
+        return lis2de_bus_write(dev, reg_multi_bytes_write, val, bytes_to_write);
+    }
+    return 0;
+}
+
+void
+lis2de_init(lis2de_dev_t *dev,
+            const lis2de_bus_t *bus,
+            const uint8_t addr)
+{
+    dev->bus = bus;
+    dev->addr = addr;
+    dev->timeout_us = LIS2DE_DEFAULT_TIMEOUT_US;
+    dev->error = 0;
+    dev->shadow_enabled = 0;
+    dev->batch_active = 0;
+    lis2de_reset_stats(dev);
+
+    if (bus->ops->init)
+    {
+        uint8_t err = bus->ops->init(bus->ctx);
+        if (err)
         {
-           Throw(E_LIS2DE_I2C_WRITE);
+            lis2de_fail(dev, err);
         }
+    }
+}
+
+void
+lis2de_set_bus_timeout(lis2de_dev_t *dev,
+                       const uint32_t timeout_us)
+{
+    dev->timeout_us = timeout_us;
+}
+
+uint8_t
+lis2de_query_error(lis2de_dev_t *dev)
+{
+    return dev->error;
+}
+
+void
+lis2de_clear_error(lis2de_dev_t *dev)
+{
+    dev->error = 0;
+}
+
+void
+lis2de_query_stats(lis2de_dev_t *dev,
+                   lis2de_stats_t *stats)
+{
+#if LIS2DE_STATS
+    *stats = dev->stats;
+#else
+    (void) dev;
+    (void) stats;
+#endif
+}
+
+void
+lis2de_reset_stats(lis2de_dev_t *dev)
+{
+#if LIS2DE_STATS
+    lis2de_stats_t empty = {0};
+    dev->stats = empty;
+#else
+    (void) dev;
+#endif
+}
+
+/* Shadow copy of the writable configuration registers. The shadow
+ * window spans TEMP_CFG_REG (0x1F) .. Act_DUR (0x3F); only registers
+ * flagged in SHADOW_CACHED are ever served from RAM. */
+#define SHADOW_FIRST_REG 0x1F
+#define SHADOW_SIZE      LIS2DE_SHADOW_SIZE
+
+// One bit per register in the shadow window, LSB first:
+static const uint8_t SHADOW_CACHED[(SHADOW_SIZE + 7) / 8] =
+{
+    0b01111111, // 0x1F TEMP_CFG_REG, 0x20..0x25 CTRL_REG1..6
+    0b10000000, // 0x2E FIFO_CTRL_REG
+    0b10111010, // 0x30 IG1_CFG, 0x32..0x34 IG1_THS..IG2_CFG, 0x36 IG2_THS
+    0b11111011, // 0x37 IG2_DURATION, 0x38 CLICK_CFG, 0x3A..0x3E
+    0b00000001  // 0x3F Act_DUR
+};
+
+// Writable registers: the cached ones plus REFERENCE (0x26)
+static const uint8_t WINDOW_WRITABLE[(SHADOW_SIZE + 7) / 8] =
+{
+    0b11111111, // 0x1F TEMP_CFG_REG, 0x20..0x25 CTRL_REG1..6, 0x26 REFERENCE
+    0b10000000, // 0x2E FIFO_CTRL_REG
+    0b10111010, // 0x30 IG1_CFG, 0x32..0x34 IG1_THS..IG2_CFG, 0x36 IG2_THS
+    0b11111011, // 0x37 IG2_DURATION, 0x38 CLICK_CFG, 0x3A..0x3E
+    0b00000001  // 0x3F Act_DUR
+};
+
+/* Read-only source registers embedded in the writable blocks. The
+ * datasheet does not define what writing them does, so multi-byte
+ * writes are split around them. */
+static const uint8_t WINDOW_SOURCE[(SHADOW_SIZE + 7) / 8] =
+{
+    0b00000000,
+    0b00000000,
+    0b01000101, // 0x2F FIFO_SRC_REG, 0x31 IG1_SOURCE, 0x35 IG2_SOURCE
+    0b00000100, // 0x39 CLICK_SRC
+    0b00000000
+};
+
+static uint8_t
+lis2de_window_flag(const uint8_t *table,
+                   const uint8_t adr)
+{
+    uint8_t res = 0;
+
+    if (adr >= SHADOW_FIRST_REG && adr < SHADOW_FIRST_REG + SHADOW_SIZE)
+    {
+        uint8_t idx = adr - SHADOW_FIRST_REG;
+        res = (table[idx >> 3] >> (idx & 7)) & 1;
+    }
+    return res;
+}
+
+static uint8_t
+lis2de_shadow_covers(lis2de_dev_t *dev,
+                     const uint8_t adr)
+{
+    return dev->shadow_enabled && lis2de_window_flag(SHADOW_CACHED, adr);
+}
+
+static uint8_t
+lis2de_shadow_is_valid(lis2de_dev_t *dev,
+                       const uint8_t adr)
+{
+    uint8_t idx = adr - SHADOW_FIRST_REG;
+    return (dev->shadow_valid[idx >> 3] >> (idx & 7)) & 1;
+}
+
+static void
+lis2de_shadow_store(lis2de_dev_t *dev,
+                    const uint8_t adr,
+                    const uint8_t val)
+{
+    uint8_t idx = adr - SHADOW_FIRST_REG;
+
+    // Values read or written after a failure are not the device's
+    if (lis2de_failed(dev))
+    {
+        return;
+    }
+    dev->shadow[idx] = val;
+    dev->shadow_valid[idx >> 3] |= (uint8_t) (1 << (idx & 7));
+}
+
+static uint8_t
+lis2de_read_device_register(lis2de_dev_t *dev,
+                            const uint8_t adr)
+{
+    if (!lis2de_shadow_covers(dev, adr))
+    {
+        return lis2de_read_byte(dev, adr);
+    }
+    if (!lis2de_shadow_is_valid(dev, adr))
+    {
+        lis2de_shadow_store(dev, adr, lis2de_read_byte(dev, adr));
+    }
+    return dev->shadow[adr - SHADOW_FIRST_REG];
+}
+
+static uint8_t
+lis2de_batch_covers(lis2de_dev_t *dev,
+                    const uint8_t adr)
+{
+    return (dev->batch_active
+            && adr >= SHADOW_FIRST_REG
+            && adr < SHADOW_FIRST_REG + SHADOW_SIZE);
+}
+
+// Register content as it will be once pending changes are committed
+static uint8_t
+lis2de_read_register(lis2de_dev_t *dev,
+                     const uint8_t adr)
+{
+    uint8_t data;
+    uint8_t idx = adr - SHADOW_FIRST_REG;
+
+    if (lis2de_batch_covers(dev, adr) && dev->batch_mask[idx] == BITMASK_FULL.mask)
+    {
+        return dev->batch_value[idx];
+    }
+    data = lis2de_read_device_register(dev, adr);
+    if (lis2de_batch_covers(dev, adr))
+    {
+        data = (data & ((uint8_t) ~dev->batch_mask[idx])) | dev->batch_value[idx];
+    }
+    return data;
+}
+
+static void
+lis2de_write_register(lis2de_dev_t *dev,
+                      const uint8_t adr,
+                      const uint8_t val)
+{
+    lis2de_write_byte(dev, adr, val);
+    if (lis2de_shadow_covers(dev, adr))
+    {
+        lis2de_shadow_store(dev, adr, val);
+    }
+}
+
+void
+lis2de_shadow_registers_invalidate(lis2de_dev_t *dev)
+{
+    for (uint8_t i = 0; i < sizeof(dev->shadow_valid); i++)
+    {
+        dev->shadow_valid[i] = 0;
+    }
+}
+
+/* Reload every cached register, one burst per run of consecutive
+ * cached registers. Source registers are never part of a run, so
+ * latched interrupt sources are left untouched. */
+void
+lis2de_shadow_registers_resync(lis2de_dev_t *dev)
+{
+    uint8_t adr = SHADOW_FIRST_REG;
+
+    if (!dev->shadow_enabled)
+    {
+        return;
+    }
+    while (adr < SHADOW_FIRST_REG + SHADOW_SIZE)
+    {
+        uint8_t len = 0;
 
-        if (i2c_rep_start(LIS2DE_ADDR + I2C_READ))
+        while (lis2de_shadow_covers(dev, adr + len))
+        {
+            len++;
+        }
+        if (len == 0)
         {
-            Throw(E_LIS2DE_I2C_REP_START);
+            adr++;
+            continue;
         }
-        --bytes_to_read;
-        for (uint8_t pos = 0; pos < bytes_to_read; pos++)
+        if (lis2de_read_bytes(dev, len, adr, &dev->shadow[adr - SHADOW_FIRST_REG]))
         {
-            res[pos] = i2c_readAck();
+            lis2de_shadow_registers_invalidate(dev);
+            return;
         }
-        res[bytes_to_read] = i2c_readNak();
-        i2c_stop();
+        for (uint8_t i = 0; i < len; i++)
+        {
+            lis2de_shadow_store(dev, adr + i, dev->shadow[adr + i - SHADOW_FIRST_REG]);
+        }
+        adr += len;
     }
 }
 
+void
+lis2de_begin_configuration(lis2de_dev_t *dev)
+{
+    for (uint8_t i = 0; i < SHADOW_SIZE; i++)
+    {
+        dev->batch_mask[i] = 0;
+        dev->batch_value[i] = 0;
+    }
+    dev->batch_active = 1;
+}
+
+void
+lis2de_discard_configuration(lis2de_dev_t *dev)
+{
+    dev->batch_active = 0;
+}
+
 static uint8_t
-lis2de_read_byte(const uint8_t reg)
+lis2de_shadow_knows(lis2de_dev_t *dev,
+                    const uint8_t adr)
+{
+    return lis2de_shadow_covers(dev, adr) && lis2de_shadow_is_valid(dev, adr);
+}
+
+// Modified register whose untouched bits are unknown
+static uint8_t
+lis2de_batch_needs_base(lis2de_dev_t *dev,
+                        const uint8_t idx)
+{
+    return dev->batch_mask[idx]
+           && dev->batch_mask[idx] != BITMASK_FULL.mask
+           && !lis2de_shadow_knows(dev, SHADOW_FIRST_REG + idx);
+}
+
+/* Write buf[first..first+len) of the shadow window with one multi-byte
+ * write and keep the shadow in sync. */
+static void
+lis2de_write_window(lis2de_dev_t *dev,
+                    const uint8_t first,
+                    const uint8_t len,
+                    const uint8_t *buf)
+{
+    lis2de_write_bytes(dev, len, SHADOW_FIRST_REG + first, &buf[first]);
+
+    for (uint8_t idx = first; idx < first + len; idx++)
+    {
+        if (lis2de_shadow_covers(dev, SHADOW_FIRST_REG + idx))
+        {
+            lis2de_shadow_store(dev, SHADOW_FIRST_REG + idx, buf[idx]);
+        }
+    }
+}
+
+/* Merge the pending changes per register and flush them with as few
+ * multi-byte writes as possible. Registers already holding the
+ * requested value are dropped. Partially modified registers not known
+ * from the shadow are read back first, one burst per run. */
+void
+lis2de_commit_configuration(lis2de_dev_t *dev)
 {
-    i2c_start_wait(LIS2DE_ADDR + I2C_WRITE);
-    if (i2c_write(reg))
+    uint8_t buf[SHADOW_SIZE] = {0};
+    uint8_t idx;
+
+    if (!dev->batch_active)
     {
-        Throw(E_LIS2DE_I2C_WRITE);
+        return;
     }
-    if (i2c_rep_start(LIS2DE_ADDR + I2C_READ))
+    dev->batch_active = 0;
+
+    for (idx = 0; idx < SHADOW_SIZE; idx++)
     {
-        Throw(E_LIS2DE_I2C_REP_START);
+        if (dev->batch_mask[idx] && lis2de_shadow_knows(dev, SHADOW_FIRST_REG + idx))
+        {
+            buf[idx] = dev->shadow[idx];
+            if (((buf[idx] & ((uint8_t) ~dev->batch_mask[idx])) | dev->batch_value[idx])
+                == buf[idx])
+            {
+                dev->batch_mask[idx] = 0;
+            }
+        }
+    }
+
+    idx = 0;
+    while (idx < SHADOW_SIZE)
+    {
+        uint8_t len = 0;
+
+        while (idx + len < SHADOW_SIZE && lis2de_batch_needs_base(dev, idx + len))
+        {
+            len++;
+        }
+        if (len > 0)
+        {
+            lis2de_read_bytes(dev, len, SHADOW_FIRST_REG + idx, &buf[idx]);
+            idx += len;
+        }
+        else
+        {
+            idx++;
+        }
+    }
+
+    for (idx = 0; idx < SHADOW_SIZE; idx++)
+    {
+        buf[idx] = (buf[idx] & ((uint8_t) ~dev->batch_mask[idx])) | dev->batch_value[idx];
+    }
+
+    idx = 0;
+    while (idx < SHADOW_SIZE)
+    {
+        uint8_t len = 0;
+
+        if (!dev->batch_mask[idx])
+        {
+            idx++;
+            continue;
+        }
+        while (idx + len < SHADOW_SIZE && dev->batch_mask[idx + len])
+        {
+            len++;
+        }
+
+        lis2de_write_window(dev, idx, len, buf);
+        for (uint8_t i = idx; i < idx + len; i++)
+        {
+            dev->batch_mask[i] = 0;
+        }
+        idx += len;
     }
-    uint8_t res = i2c_readNak();
-    i2c_stop();
-    return res;
 }
 
+/* Cached registers read along refresh the shadow, which makes a full
+ * burst over the window a cheaper resync. */
+void
+lis2de_read_registers(lis2de_dev_t *dev,
+                      const uint8_t reg,
+                      uint8_t *val,
+                      uint8_t len)
+{
+    if (reg + len > LIS2DE_REGISTERS)
+    {
+        lis2de_fail(dev, E_INVALID_REGISTER);
+        return;
+    }
+    if (reg <= OUT_REG_Z.adr && reg + len > OUT_REG_Z.adr + 1)
+    {
+        uint8_t split = OUT_REG_Z.adr + 1 - reg;
+        uint8_t ctrl5 = CTRL_REG5.adr;
+
+        /* A FIFO enabled before the burst makes it wrap at OUT_Z, so the
+         * rest is read with a burst of its own. If CTRL_REG5 comes with
+         * the burst, its value tells whether the rest has to be read
+         * again. Past CTRL_REG5 only the shadow can tell, and a FIFO it
+         * does not know about counts as enabled. */
+        if (reg <= ctrl5)
+        {
+            if (lis2de_read_bytes(dev, len, reg, val)
+                || !(val[ctrl5 - reg] & BITMASK_6.mask))
+            {
+                split = len;
+            }
+        }
+        else if (lis2de_shadow_knows(dev, ctrl5)
+                 && !(dev->shadow[ctrl5 - SHADOW_FIRST_REG] & BITMASK_6.mask))
+        {
+            if (lis2de_read_bytes(dev, len, reg, val))
+            {
+                return;
+            }
+            split = len;
+        }
+        else if (lis2de_read_bytes(dev, split, reg, val))
+        {
+            return;
+        }
+        if (split < len
+            && lis2de_read_bytes(dev, len - split, reg + split, val + split))
+        {
+            return;
+        }
+    }
+    else if (lis2de_read_bytes(dev, len, reg, val))
+    {
+        return;
+    }
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (lis2de_shadow_covers(dev, reg + i))
+        {
+            lis2de_shadow_store(dev, reg + i, val[i]);
+        }
+    }
+}
+
+/* Every run of writable registers holding a change is written with one
+ * transaction, spanning the first to the last register to change in
+ * it. Registers in between that already hold their value are rewritten,
+ * which costs a byte each instead of another transaction. The read-only
+ * source registers separating the runs are never written. Inside an
+ * open batch the changes join it and wait for its commit. */
 static void
-lis2de_write_byte(const uint8_t reg,
-                const uint8_t val)
+lis2de_write_image(lis2de_dev_t *dev,
+                   const uint8_t *image,
+                   const uint8_t *changed)
+{
+    if (dev->batch_active)
+    {
+        for (uint8_t idx = 0; idx < SHADOW_SIZE; idx++)
+        {
+            if (changed[idx])
+            {
+                dev->batch_value[idx] = image[idx];
+                dev->batch_mask[idx] = BITMASK_FULL.mask;
+            }
+        }
+        return;
+    }
+
+    for (uint8_t idx = 0; idx < SHADOW_SIZE;)
+    {
+        uint8_t end = idx;
+        uint8_t first = idx;
+        uint8_t last;
+
+        while (end < SHADOW_SIZE && lis2de_window_flag(WINDOW_WRITABLE, SHADOW_FIRST_REG + end))
+        {
+            end++;
+        }
+        if (end == idx)
+        {
+            idx++;
+            continue;
+        }
+
+        last = end;
+        while (first < last && !changed[first])
+        {
+            first++;
+        }
+        while (last > first && !changed[last - 1])
+        {
+            last--;
+        }
+        if (first < last)
+        {
+            lis2de_write_window(dev, first, last - first, image);
+        }
+        idx = end;
+    }
+}
+
+void
+lis2de_apply_register_image(lis2de_dev_t *dev,
+                            const uint8_t *image)
+{
+    uint8_t changed[SHADOW_SIZE] = {0};
+    uint8_t ctrl2 = image[CTRL_REG2.adr - SHADOW_FIRST_REG];
+
+    for (uint8_t idx = 0; idx < SHADOW_SIZE; idx++)
+    {
+        uint8_t adr = SHADOW_FIRST_REG + idx;
+
+        if (!lis2de_window_flag(WINDOW_WRITABLE, adr))
+        {
+            continue;
+        }
+        if (adr == REFERENCE_REG.adr)
+        {
+            // Only used in reference mode, written then as it cannot be read back
+            changed[idx] = (ctrl2 & (BITMASK_7.mask | BITMASK_6.mask)) == BITMASK_6.mask;
+        }
+        else
+        {
+            changed[idx] = !lis2de_shadow_knows(dev, adr) || dev->shadow[idx] != image[idx];
+        }
+    }
+    lis2de_write_image(dev, image, changed);
+}
+
+void
+lis2de_restore_register_image(lis2de_dev_t *dev,
+                              const uint8_t *image)
 {
-    i2c_start_wait(LIS2DE_ADDR + I2C_WRITE);
-    if (i2c_write(reg) || i2c_write(val))
+    uint8_t buf[SHADOW_SIZE];
+    uint8_t all[SHADOW_SIZE];
+
+    for (uint8_t idx = 0; idx < SHADOW_SIZE; idx++)
+    {
+        buf[idx] = image[idx];
+        all[idx] = lis2de_window_flag(WINDOW_WRITABLE, SHADOW_FIRST_REG + idx);
+    }
+    // Setting BOOT would reload the register file just written
+    buf[CTRL_REG5.adr - SHADOW_FIRST_REG] &= (uint8_t) ~BITMASK_7.mask;
+    lis2de_write_image(dev, buf, all);
+}
+
+/* Program a block of consecutive registers with one transaction per
+ * run of writable registers. Every register in the block must be
+ * writable or one of the read-only source registers, whose bytes are
+ * left out. */
+void
+lis2de_write_registers(lis2de_dev_t *dev,
+                       const uint8_t reg,
+                       const uint8_t *val,
+                       uint8_t len)
+{
+    uint8_t buf[SHADOW_SIZE];
+    uint8_t first = reg - SHADOW_FIRST_REG;
+
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (!lis2de_window_flag(WINDOW_WRITABLE, reg + i)
+            && !lis2de_window_flag(WINDOW_SOURCE, reg + i))
+        {
+            lis2de_fail(dev, E_INVALID_REGISTER);
+            return;
+        }
+    }
+
+    if (dev->batch_active)
+    {
+        for (uint8_t i = 0; i < len; i++)
+        {
+            if (lis2de_window_flag(WINDOW_WRITABLE, reg + i))
+            {
+                dev->batch_value[first + i] = val[i];
+                dev->batch_mask[first + i] = BITMASK_FULL.mask;
+            }
+        }
+        return;
+    }
+
+    for (uint8_t i = 0; i < len; i++)
+    {
+        buf[first + i] = val[i];
+    }
+    for (uint8_t i = 0; i < len;)
+    {
+        uint8_t run = 0;
+
+        while (i + run < len && lis2de_window_flag(WINDOW_WRITABLE, reg + i + run))
+        {
+            run++;
+        }
+        if (run == 0)
+        {
+            i++;
+            continue;
+        }
+        lis2de_write_window(dev, first + i, run, buf);
+        i += run;
+    }
+
+    // Writing BOOT reloads the whole register file
+    if (reg <= CTRL_REG5.adr && reg + len > CTRL_REG5.adr
+        && (val[CTRL_REG5.adr - reg] & BITMASK_7.mask))
     {
-        Throw(E_LIS2DE_I2C_WRITE);
+        lis2de_shadow_registers_invalidate(dev);
     }
-    i2c_stop();
 }
 
 void
-lis2de_init(void)
+lis2de_enable_shadow_registers(lis2de_dev_t *dev)
+{
+    lis2de_shadow_registers_invalidate(dev);
+    dev->shadow_enabled = 1;
+}
+
+void
+lis2de_disable_shadow_registers(lis2de_dev_t *dev)
 {
-    i2c_init();
+    dev->shadow_enabled = 0;
+    lis2de_shadow_registers_invalidate(dev);
 }
 
 static uint8_t
-lis2de_query(const reg_t reg,
+lis2de_field(const uint8_t data,
              const bitmask_t bm)
 {
-    uint8_t data = lis2de_read_byte(reg.adr);
-    data = ((data & bm.mask) >> bm.shift);
-    return data;
+    return ((data & bm.mask) >> bm.shift);
 }
 
+static uint8_t
+lis2de_query(lis2de_dev_t *dev,
+             const reg_t reg,
+             const bitmask_t bm)
+{
+    return lis2de_field(lis2de_read_register(dev, reg.adr), bm);
+}
+
+/* Replace the bits of mask in a register. A pending configuration
+ * batch takes the change, otherwise it is a read-modify-write through
+ * the shadow; writing all bits needs no read at all. */
 static void
-lis2de_set(const reg_t reg,
+lis2de_modify(lis2de_dev_t *dev,
+              const uint8_t adr,
+              const uint8_t mask,
+              const uint8_t bits)
+{
+    uint8_t data = 0;
+
+    if (lis2de_batch_covers(dev, adr))
+    {
+        uint8_t idx = adr - SHADOW_FIRST_REG;
+
+        dev->batch_value[idx] &= (uint8_t) ~mask;
+        dev->batch_value[idx] |= (uint8_t) (bits & mask);
+        dev->batch_mask[idx] |= mask;
+        return;
+    }
+
+    if (mask != BITMASK_FULL.mask)
+    {
+        data = lis2de_read_register(dev, adr) & ((uint8_t) ~mask);
+    }
+    lis2de_write_register(dev, adr, data | (bits & mask));
+}
+
+static void
+lis2de_set(lis2de_dev_t *dev,
+           const reg_t reg,
            const bitmask_t bm,
            uint8_t val)
 {
-    uint8_t data = lis2de_read_byte(reg.adr);
-    data = data & ((uint8_t) ~bm.mask);
-    val = (val << bm.shift) + data;
+    lis2de_modify(dev, reg.adr, bm.mask, (uint8_t) (val << bm.shift));
+}
+
+uint8_t
+lis2de_query_register(lis2de_dev_t *dev,
+                      const uint8_t adr)
+{
+    if (adr >= LIS2DE_REGISTERS)
+    {
+        lis2de_fail(dev, E_INVALID_REGISTER);
+        return 0;
+    }
+    return lis2de_read_register(dev, adr);
+}
 
-    lis2de_write_byte(reg.adr, val);
+void
+lis2de_modify_register(lis2de_dev_t *dev,
+                       const uint8_t adr,
+                       const uint8_t mask,
+                       const uint8_t bits)
+{
+    if (!lis2de_window_flag(WINDOW_WRITABLE, adr))
+    {
+        lis2de_fail(dev, E_INVALID_REGISTER);
+        return;
+    }
+    lis2de_modify(dev, adr, mask, bits);
 }
 
 uint8_t
-lis2de_query_temperature_sensor_enabled(void)
+lis2de_query_temperature_sensor_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(TEMP_CFG_REG, BITMASK_7);
+    return lis2de_query(dev, TEMP_CFG_REG, BITMASK_7);
 }
 
 uint8_t
-lis2de_query_temperature_data_overrun(void)
+lis2de_query_temperature_data_overrun(lis2de_dev_t *dev)
 {
-    return lis2de_query(STATUS_AUX_REG, BITMASK_6);
+    return lis2de_query(dev, STATUS_AUX_REG, BITMASK_6);
 }
 
 uint8_t
-lis2de_query_temperature_new_data_available(void)
+lis2de_query_temperature_new_data_available(lis2de_dev_t *dev)
 {
-    return lis2de_query(STATUS_AUX_REG, BITMASK_2);
+    return lis2de_query(dev, STATUS_AUX_REG, BITMASK_2);
 }
 
-static void
-lis2de_ensure_block_data_update_is_enabled(void)
+static uint8_t
+lis2de_ensure_block_data_update_is_enabled(lis2de_dev_t *dev)
 {
-    if (!lis2de_query_block_data_update_enabled())
+    if (!lis2de_query_block_data_update_enabled(dev))
     {
-        Throw(E_BDU_NOT_ENABLED);
+        return lis2de_fail(dev, E_BDU_NOT_ENABLED);
     }
+    return 0;
 }
 
 /* Both high and low byte must be read, but the actual temperature
  * data is the high byte as two's complement */
 int8_t
-lis2de_query_temperature(void)
+lis2de_query_temperature(lis2de_dev_t *dev)
 {
     uint8_t data[2] = {0};
 
-    lis2de_ensure_block_data_update_is_enabled();
-    lis2de_read_bytes(OUT_TEMP_REG.size, OUT_TEMP_REG.adr, data);
+    if (lis2de_ensure_block_data_update_is_enabled(dev))
+    {
+        return 0;
+    }
+    lis2de_read_bytes(dev, OUT_TEMP_REG.size, OUT_TEMP_REG.adr, data);
 
-    return ((int8_t) data[0]);
+    return ((int8_t) data[1]);
+}
+
+/* BDU is only checked when CTRL_REG4 is shadowed, so after the first
+ * sample no bus transaction is spent on it. Without the shadow the
+ * caller vouches for BDU being enabled. */
+lis2de_temperature_t
+lis2de_query_temperature_data(lis2de_dev_t *dev)
+{
+    lis2de_temperature_t temperature = {0};
+    uint8_t data[7] = {0};
+
+    if (lis2de_shadow_covers(dev, CTRL_REG4.adr)
+        && lis2de_ensure_block_data_update_is_enabled(dev))
+    {
+        return temperature;
+    }
+    if (lis2de_read_bytes(dev, TEMP_BURST_REG.size, TEMP_BURST_REG.adr, data))
+    {
+        return temperature;
+    }
+
+    temperature.value    = (int8_t) data[OUT_TEMP_REG.adr + 1 - TEMP_BURST_REG.adr];
+    temperature.new_data = lis2de_field(data[0], BITMASK_2);
+    temperature.overrun  = lis2de_field(data[0], BITMASK_6);
+
+    return temperature;
 }
 
 uint8_t
-lis2de_query_int_counter(void)
+lis2de_query_int_counter(lis2de_dev_t *dev)
 {
-    return lis2de_query(INT_COUNTER_REG, BITMASK_FULL);
+    return lis2de_query(dev, INT_COUNTER_REG, BITMASK_FULL);
 }
 
 uint8_t
-lis2de_query_device_id(void)
+lis2de_query_device_id(lis2de_dev_t *dev)
 {
-    return lis2de_query(WHO_AM_I_REG, BITMASK_FULL);
+    return lis2de_query(dev, WHO_AM_I_REG, BITMASK_FULL);
 }
 
 // CTRL_REG1 (0x20):
 
 uint8_t
-lis2de_query_data_rate_selection(void)
+lis2de_query_data_rate_selection(lis2de_dev_t *dev)
+{
+    return lis2de_query(dev, CTRL_REG1, BITMASK_7654);
+}
+
+/* Nominal output data rate of an ODR[3:0] selection, 0 in power-down
+ * mode. 1.620 kHz (0b1000) is only available in low-power mode. */
+uint16_t
+lis2de_data_rate_in_hz(const uint8_t odr,
+                       const uint8_t low_power)
 {
-    return lis2de_query(CTRL_REG1, BITMASK_765);
+    static const uint16_t ODR_HZ[] = {0, 1, 10, 25, 50, 100, 200, 400, 1620, 1344};
+    uint16_t res = 0;
+
+    if (odr == 0b1001 && low_power)
+    {
+        res = 5376;
+    }
+    else if (odr < sizeof(ODR_HZ) / sizeof(ODR_HZ[0]))
+    {
+        res = ODR_HZ[odr];
+    }
+    return res;
 }
 
 uint8_t
-lis2de_query_low_power_mode_enabled(void)
+lis2de_query_low_power_mode_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG1, BITMASK_3);
+    return lis2de_query(dev, CTRL_REG1, BITMASK_3);
 }
 
 uint8_t
-lis2de_query_z_axis_enabled(void)
+lis2de_query_z_axis_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG1, BITMASK_2);
+    return lis2de_query(dev, CTRL_REG1, BITMASK_2);
 }
 
 uint8_t
-lis2de_query_y_axis_enabled(void)
+lis2de_query_y_axis_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG1, BITMASK_1);
+    return lis2de_query(dev, CTRL_REG1, BITMASK_1);
 }
 
 uint8_t
-lis2de_query_x_axis_enabled(void)
+lis2de_query_x_axis_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG1, BITMASK_0);
+    return lis2de_query(dev, CTRL_REG1, BITMASK_0);
 }
 
 // CTRL_REG2 (0x21):
 
 uint8_t
-lis2de_query_high_pass_filter_mode_selection(void)
+lis2de_query_high_pass_filter_mode_selection(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG2, BITMASK_76);
+    return lis2de_query(dev, CTRL_REG2, BITMASK_76);
 }
 
 uint8_t
-lis2de_query_high_pass_filter_in_normal_mode(void)
+lis2de_query_high_pass_filter_in_normal_mode(lis2de_dev_t *dev)
 {
-    uint8_t mode = lis2de_query_high_pass_filter_mode_selection();
+    uint8_t mode = lis2de_query_high_pass_filter_mode_selection(dev);
     uint8_t res = 0;
 
     if (mode == HPF_MODE_NORMAL)
@@ -280,9 +1145,9 @@ lis2de_query_high_pass_filter_in_normal_mode(void)
 }
 
 uint8_t
-lis2de_query_high_pass_filter_in_reference_mode(void)
+lis2de_query_high_pass_filter_in_reference_mode(lis2de_dev_t *dev)
 {
-    uint8_t mode = lis2de_query_high_pass_filter_mode_selection();
+    uint8_t mode = lis2de_query_high_pass_filter_mode_selection(dev);
     uint8_t res = 0;
     if (mode == HPF_MODE_REFERENCE)
     {
@@ -292,9 +1157,9 @@ lis2de_query_high_pass_filter_in_reference_mode(void)
 }
 
 uint8_t
-lis2de_query_high_pass_filter_in_auto_reset_mode(void)
+lis2de_query_high_pass_filter_in_auto_reset_mode(lis2de_dev_t *dev)
 {
-    uint8_t mode = lis2de_query_high_pass_filter_mode_selection();
+    uint8_t mode = lis2de_query_high_pass_filter_mode_selection(dev);
     uint8_t res = 0;
     if (mode == HPF_MODE_AUTO_RESET)
     {
@@ -304,1628 +1169,1881 @@ lis2de_query_high_pass_filter_in_auto_reset_mode(void)
 }
 
 uint8_t
-lis2de_query_high_pass_filter_cutoff_frequency_selection(void)
+lis2de_query_high_pass_filter_cutoff_frequency_selection(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG2, BITMASK_54);
+    return lis2de_query(dev, CTRL_REG2, BITMASK_54);
 }
 
 uint8_t
-lis2de_query_internal_filter_enabled(void)
+lis2de_query_internal_filter_bypassed(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG2, BITMASK_3);
+    return lis2de_query(dev, CTRL_REG2, BITMASK_3);
 }
 
 uint8_t
-lis2de_query_high_pass_filter_for_click_function_enabled(void)
+lis2de_query_high_pass_filter_for_click_function_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG2, BITMASK_2);
+    return lis2de_query(dev, CTRL_REG2, BITMASK_2);
 }
 
 uint8_t
-lis2de_query_high_pass_filter_for_ig2_enabled(void)
+lis2de_query_high_pass_filter_for_ig2_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG2, BITMASK_1);
+    return lis2de_query(dev, CTRL_REG2, BITMASK_1);
 }
 
 uint8_t
-lis2de_query_high_pass_filter_for_ig1_enabled(void)
+lis2de_query_high_pass_filter_for_ig1_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG2, BITMASK_0);
+    return lis2de_query(dev, CTRL_REG2, BITMASK_0);
 }
 
 // CTRL_REG3 (0x22):
 
 uint8_t
-lis2de_query_click_interrupt_on_int1_enabled(void)
+lis2de_query_click_interrupt_on_int1_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG3, BITMASK_7);
+    return lis2de_query(dev, CTRL_REG3, BITMASK_7);
 }
 
 uint8_t
-lis2de_query_ig1_on_int1_enabled(void)
+lis2de_query_ig1_on_int1_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG3, BITMASK_6);
+    return lis2de_query(dev, CTRL_REG3, BITMASK_6);
 }
 
 uint8_t
-lis2de_query_ig2_on_int1_enabled(void)
+lis2de_query_ig2_on_int1_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG3, BITMASK_5);
+    return lis2de_query(dev, CTRL_REG3, BITMASK_5);
 }
 
 uint8_t
-lis2de_query_drdy1_interrupt_on_int1_enabled(void)
+lis2de_query_drdy1_interrupt_on_int1_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG3, BITMASK_4);
+    return lis2de_query(dev, CTRL_REG3, BITMASK_4);
 }
 
 uint8_t
-lis2de_query_drdy2_interrupt_on_int1_enabled(void)
+lis2de_query_drdy2_interrupt_on_int1_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG3, BITMASK_3);
+    return lis2de_query(dev, CTRL_REG3, BITMASK_3);
 }
 
 uint8_t
-lis2de_query_fifo_watermark_interrupt_on_int1_enabled(void)
+lis2de_query_fifo_watermark_interrupt_on_int1_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG3, BITMASK_2);
+    return lis2de_query(dev, CTRL_REG3, BITMASK_2);
 }
 
 uint8_t
-lis2de_query_fifo_overrun_interrupt_on_int1_enabled(void)
+lis2de_query_fifo_overrun_interrupt_on_int1_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG3, BITMASK_1);
+    return lis2de_query(dev, CTRL_REG3, BITMASK_1);
 }
 
 // CTRL_REG4 (0x23):
 
 uint8_t
-lis2de_query_block_data_update_enabled(void)
+lis2de_query_block_data_update_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG4, BITMASK_7);
+    return lis2de_query(dev, CTRL_REG4, BITMASK_7);
 }
 
 uint8_t
-lis2de_query_FULL_scale_selection(void)
+lis2de_query_full_scale_selection(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG4, BITMASK_54);
+    return lis2de_query(dev, CTRL_REG4, BITMASK_54);
 }
 
 uint8_t
-lis2de_query_FULL_scale_selection_is_set_to_2g(void)
+lis2de_query_full_scale_selection_is_set_to_2g(lis2de_dev_t *dev)
 {
-    return (lis2de_query(CTRL_REG4, BITMASK_54) == 0b00);
+    return (lis2de_query(dev, CTRL_REG4, BITMASK_54) == 0b00);
 }
 
 uint8_t
-lis2de_query_FULL_scale_selection_is_set_to_4g(void)
+lis2de_query_full_scale_selection_is_set_to_4g(lis2de_dev_t *dev)
 {
-    return (lis2de_query(CTRL_REG4, BITMASK_54) == 0b01);
+    return (lis2de_query(dev, CTRL_REG4, BITMASK_54) == 0b01);
 }
 
 uint8_t
-lis2de_query_FULL_scale_selection_is_set_to_8g(void)
+lis2de_query_full_scale_selection_is_set_to_8g(lis2de_dev_t *dev)
 {
-    return (lis2de_query(CTRL_REG4, BITMASK_54) == 0b10);
+    return (lis2de_query(dev, CTRL_REG4, BITMASK_54) == 0b10);
 }
 
 uint8_t
-lis2de_query_FULL_scale_selection_is_set_to_16g(void)
+lis2de_query_full_scale_selection_is_set_to_16g(lis2de_dev_t *dev)
 {
-    return (lis2de_query(CTRL_REG4, BITMASK_54) == 0b11);
+    return (lis2de_query(dev, CTRL_REG4, BITMASK_54) == 0b11);
 }
 
 uint8_t
-lis2de_query_self_test_enabled(void)
+lis2de_query_self_test_enabled(lis2de_dev_t *dev)
 {
-    return (lis2de_query(CTRL_REG4, BITMASK_21) == 0);
+    return (lis2de_query(dev, CTRL_REG4, BITMASK_21) == 0);
 }
 
 uint8_t
-lis2de_query_spi_mode_selection(void)
+lis2de_query_spi_mode_selection(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG4, BITMASK_0);
+    return lis2de_query(dev, CTRL_REG4, BITMASK_0);
 }
 
 // CTRL_REG5 (0x24):
 
 uint8_t
-lis2de_query_reboot_memory_content(void)
+lis2de_query_reboot_memory_content(lis2de_dev_t *dev)
+{
+    return lis2de_query(dev, CTRL_REG5, BITMASK_7);
+}
+
+/* BOOT is only set while a reboot is under way, so it is read from
+ * the bus: the shadow must not learn it, and the batch knows nothing
+ * about it. */
+uint8_t
+lis2de_query_boot_in_progress(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG5, BITMASK_7);
+    return lis2de_field(lis2de_read_byte(dev, CTRL_REG5.adr), BITMASK_7);
 }
 
 uint8_t
-lis2de_query_fifo_enabled(void)
+lis2de_query_fifo_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG5, BITMASK_6);
+    return lis2de_query(dev, CTRL_REG5, BITMASK_6);
 }
 
 uint8_t
-lis2de_query_latch_interruot_request_on_ig1_source_reg(void)
+lis2de_query_latch_interruot_request_on_ig1_source_reg(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG5, BITMASK_3);
+    return lis2de_query(dev, CTRL_REG5, BITMASK_3);
 }
 
 uint8_t
-lis2de_query_int1_4d_detection_enabled(void)
+lis2de_query_int1_4d_detection_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG5, BITMASK_2);
+    return lis2de_query(dev, CTRL_REG5, BITMASK_2);
 }
 
 uint8_t
-lis2de_query_latch_interruot_request_on_ig2_source_reg(void)
+lis2de_query_latch_interruot_request_on_ig2_source_reg(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG5, BITMASK_1);
+    return lis2de_query(dev, CTRL_REG5, BITMASK_1);
 }
 
 uint8_t
-lis2de_query_int2_4d_detection_enabled(void)
+lis2de_query_int2_4d_detection_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG5, BITMASK_0);
+    return lis2de_query(dev, CTRL_REG5, BITMASK_0);
 }
 
 // CTRL_REG6 (0x25):
 
 uint8_t
-lis2de_query_click_interrupt_on_int2_pin_enabled(void)
+lis2de_query_click_interrupt_on_int2_pin_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG6, BITMASK_7);
+    return lis2de_query(dev, CTRL_REG6, BITMASK_7);
 }
 
 uint8_t
-lis2de_query_ig1_on_int2_pin_enabled(void)
+lis2de_query_ig1_on_int2_pin_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG6, BITMASK_6);
+    return lis2de_query(dev, CTRL_REG6, BITMASK_6);
 }
 
 uint8_t
-lis2de_query_ig2_on_int2_pin_enabled(void)
+lis2de_query_ig2_on_int2_pin_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG6, BITMASK_5);
+    return lis2de_query(dev, CTRL_REG6, BITMASK_5);
 }
 
 uint8_t
-lis2de_query_boot_on_int2_pin_enabled(void)
+lis2de_query_boot_on_int2_pin_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG6, BITMASK_4);
+    return lis2de_query(dev, CTRL_REG6, BITMASK_4);
 }
 
 uint8_t
-lis2de_query_sleep_to_wake_function_interrupt_on_int2_pin_enabled(void)
+lis2de_query_sleep_to_wake_function_interrupt_on_int2_pin_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG6, BITMASK_3);
+    return lis2de_query(dev, CTRL_REG6, BITMASK_3);
 }
 
 uint8_t
-lis2de_query_interrupt_active_value(void)
+lis2de_query_interrupt_active_value(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG6, BITMASK_1);
+    return lis2de_query(dev, CTRL_REG6, BITMASK_1);
 }
 
 
 // REFERENCE (0x26)
 uint8_t
-lis2de_query_reference(void)
+lis2de_query_reference(lis2de_dev_t *dev)
 {
-    return lis2de_query(REFERENCE_REG, BITMASK_FULL);
+    return lis2de_query(dev, REFERENCE_REG, BITMASK_FULL);
 }
 
 
 // STATUS_REG22 (0x27)
 uint8_t
-lis2de_query_data_overrun_on_xyz_axes(void)
+lis2de_query_data_overrun_on_xyz_axes(lis2de_dev_t *dev)
 {
-    return lis2de_query(STATUS_REG2, BITMASK_7);
+    return lis2de_query(dev, STATUS_REG2, BITMASK_7);
 }
 
 uint8_t
-lis2de_query_data_overrun_on_z_axis(void)
+lis2de_query_data_overrun_on_z_axis(lis2de_dev_t *dev)
 {
-    return lis2de_query(STATUS_REG2, BITMASK_6);
+    return lis2de_query(dev, STATUS_REG2, BITMASK_6);
 }
 
 uint8_t
-lis2de_query_data_overrun_on_y_axis(void)
+lis2de_query_data_overrun_on_y_axis(lis2de_dev_t *dev)
 {
-    return lis2de_query(STATUS_REG2, BITMASK_5);
+    return lis2de_query(dev, STATUS_REG2, BITMASK_5);
 }
 
 uint8_t
-lis2de_query_data_overrun_on_x_axis(void)
+lis2de_query_data_overrun_on_x_axis(lis2de_dev_t *dev)
 {
-    return lis2de_query(STATUS_REG2, BITMASK_4);
+    return lis2de_query(dev, STATUS_REG2, BITMASK_4);
 }
 
 uint8_t
-lis2de_query_new_data_available_on_xyz_axes(void)
+lis2de_query_new_data_available_on_xyz_axes(lis2de_dev_t *dev)
 {
-    return lis2de_query(STATUS_REG2, BITMASK_3);
+    return lis2de_query(dev, STATUS_REG2, BITMASK_3);
 }
 
 uint8_t
-lis2de_query_new_data_available_on_z_axis(void)
+lis2de_query_new_data_available_on_z_axis(lis2de_dev_t *dev)
 {
-    return lis2de_query(STATUS_REG2, BITMASK_2);
+    return lis2de_query(dev, STATUS_REG2, BITMASK_2);
 }
 
 uint8_t
-lis2de_query_new_data_available_on_y_axis(void)
+lis2de_query_new_data_available_on_y_axis(lis2de_dev_t *dev)
 {
-    return lis2de_query(STATUS_REG2, BITMASK_1);
+    return lis2de_query(dev, STATUS_REG2, BITMASK_1);
 }
 
 uint8_t
-lis2de_query_new_data_available_on_x_axis(void)
+lis2de_query_new_data_available_on_x_axis(lis2de_dev_t *dev)
 {
-    return lis2de_query(STATUS_REG2, BITMASK_0);
+    return lis2de_query(dev, STATUS_REG2, BITMASK_0);
+}
+
+static lis2de_status_t
+lis2de_decode_status(const uint8_t data)
+{
+    lis2de_status_t status = {0};
+
+    status.zyx_overrun  = lis2de_field(data, BITMASK_7);
+    status.z_overrun    = lis2de_field(data, BITMASK_6);
+    status.y_overrun    = lis2de_field(data, BITMASK_5);
+    status.x_overrun    = lis2de_field(data, BITMASK_4);
+    status.zyx_new_data = lis2de_field(data, BITMASK_3);
+    status.z_new_data   = lis2de_field(data, BITMASK_2);
+    status.y_new_data   = lis2de_field(data, BITMASK_1);
+    status.x_new_data   = lis2de_field(data, BITMASK_0);
+
+    return status;
+}
+
+lis2de_status_t
+lis2de_query_status(lis2de_dev_t *dev)
+{
+    return lis2de_decode_status(lis2de_read_byte(dev, STATUS_REG2.adr));
 }
 
 lis2de_data_t
-lis2de_query_accel_data(void)
+lis2de_query_accel_data(lis2de_dev_t *dev)
 {
     lis2de_data_t data = {0};
+    uint8_t frame[6] = {0};
+
+    lis2de_read_bytes(dev, OUT_REG_XYZ.size, OUT_REG_XYZ.adr, frame);
 
-    data.x = lis2de_read_byte(OUT_REG_X.adr);
-    data.y = lis2de_read_byte(OUT_REG_Y.adr);
-    data.z = lis2de_read_byte(OUT_REG_Z.adr);
+    data.x = (int8_t) frame[OUT_REG_X.adr - OUT_REG_XYZ.adr];
+    data.y = (int8_t) frame[OUT_REG_Y.adr - OUT_REG_XYZ.adr];
+    data.z = (int8_t) frame[OUT_REG_Z.adr - OUT_REG_XYZ.adr];
 
     return data;
 }
 
+uint8_t
+lis2de_try_read_sample(lis2de_dev_t *dev,
+                       lis2de_data_t *sample,
+                       lis2de_status_t *status)
+{
+    uint8_t data[7] = {0};
+    lis2de_status_t decoded;
+
+    if (lis2de_read_bytes(dev, STATUS_XYZ_REG.size, STATUS_XYZ_REG.adr, data))
+    {
+        data[0] = 0;
+    }
+    decoded = lis2de_decode_status(data[0]);
+    if (status)
+    {
+        *status = decoded;
+    }
+#if LIS2DE_STATS
+    if (decoded.zyx_overrun)
+    {
+        dev->stats.overruns++;
+    }
+#endif
+    if (!decoded.zyx_new_data)
+    {
+        return 0;
+    }
+
+    sample->x = (int8_t) data[OUT_REG_X.adr - STATUS_XYZ_REG.adr];
+    sample->y = (int8_t) data[OUT_REG_Y.adr - STATUS_XYZ_REG.adr];
+    sample->z = (int8_t) data[OUT_REG_Z.adr - STATUS_XYZ_REG.adr];
+    return 1;
+}
+
 // FIFO_CTRL_REG (0x2E):
 
 uint8_t
-lis2de_query_fifo_mode_selection(void)
+lis2de_query_fifo_mode_selection(lis2de_dev_t *dev)
 {
-    return lis2de_query(FIFO_CTRL_REG, BITMASK_76);
+    return lis2de_query(dev, FIFO_CTRL_REG, BITMASK_76);
 }
 
-uint8_t lis2de_query_in_bypass_mode(void)
+uint8_t lis2de_query_in_bypass_mode(lis2de_dev_t *dev)
 {
-    return (lis2de_query(FIFO_CTRL_REG, BITMASK_76) == 0b00);
+    return (lis2de_query(dev, FIFO_CTRL_REG, BITMASK_76) == 0b00);
 }
 
 uint8_t
-lis2de_query_in_fifo_mode(void)
+lis2de_query_in_fifo_mode(lis2de_dev_t *dev)
 {
-    return (lis2de_query(FIFO_CTRL_REG, BITMASK_76) == 0b01);
+    return (lis2de_query(dev, FIFO_CTRL_REG, BITMASK_76) == 0b01);
 }
 
 uint8_t
-lis2de_query_in_stream_mode(void)
+lis2de_query_in_stream_mode(lis2de_dev_t *dev)
 {
-    return (lis2de_query(FIFO_CTRL_REG, BITMASK_76) == 0b10);
+    return (lis2de_query(dev, FIFO_CTRL_REG, BITMASK_76) == 0b10);
 }
 
 uint8_t
-lis2de_query_in_trigger_mode(void)
+lis2de_query_in_trigger_mode(lis2de_dev_t *dev)
 {
-    return (lis2de_query(FIFO_CTRL_REG, BITMASK_76) == 0b11);
+    return (lis2de_query(dev, FIFO_CTRL_REG, BITMASK_76) == 0b11);
 }
 
 uint8_t
-lis2de_query_trigger_selection(void)
+lis2de_query_trigger_selection(lis2de_dev_t *dev)
 {
-    return lis2de_query(FIFO_CTRL_REG, BITMASK_5);
+    return lis2de_query(dev, FIFO_CTRL_REG, BITMASK_5);
 }
 
 uint8_t
-lis2de_query_fth(void)
+lis2de_query_fth(lis2de_dev_t *dev)
 {
-    return lis2de_query(FIFO_CTRL_REG, BITMASK_43210);
+    return lis2de_query(dev, FIFO_CTRL_REG, BITMASK_43210);
 }
 
 // FIFO_SRC_REG (0x2F):
 
 uint8_t
-lis2de_query_fifo_watermark_level_exceeded(void)
+lis2de_query_fifo_watermark_level_exceeded(lis2de_dev_t *dev)
+{
+    return lis2de_query(dev, FIFO_SRC_REG, BITMASK_7);
+}
+
+uint8_t
+lis2de_query_fifo_overrun(lis2de_dev_t *dev)
+{
+    return lis2de_query(dev, FIFO_SRC_REG, BITMASK_6);
+}
+
+uint8_t
+lis2de_query_fifo_empty(lis2de_dev_t *dev)
+{
+    return lis2de_query(dev, FIFO_SRC_REG, BITMASK_5);
+}
+
+uint8_t
+lis2de_query_fifo_current_number_of_unread_samples(lis2de_dev_t *dev)
+{
+    return lis2de_query(dev, FIFO_SRC_REG, BITMASK_43210);
+}
+
+lis2de_fifo_src_t
+lis2de_query_fifo_src(lis2de_dev_t *dev)
+{
+    lis2de_fifo_src_t src = {0};
+    uint8_t data = lis2de_read_byte(dev, FIFO_SRC_REG.adr);
+
+    src.watermark_exceeded = lis2de_field(data, BITMASK_7);
+    src.overrun            = lis2de_field(data, BITMASK_6);
+    src.empty              = lis2de_field(data, BITMASK_5);
+    src.unread_samples     = lis2de_field(data, BITMASK_43210);
+
+    return src;
+}
+
+// A full FIFO reports 31 unread samples plus the overrun flag
+uint8_t
+lis2de_fifo_src_frames(const lis2de_fifo_src_t *src)
+{
+    return src->overrun ? LIS2DE_FIFO_DEPTH : src->unread_samples;
+}
+
+/* All frames counted in a FIFO_SRC_REG snapshot are pulled with one
+ * auto-incrementing burst per LIS2DE_FIFO_BURST_FRAMES frames. While
+ * the FIFO is enabled the address pointer wraps from OUT_Z (0x2D) back
+ * to 0x28, so consecutive frames follow each other on the bus. Frame n
+ * is decoded stride bytes after frame n - 1, so records holding a
+ * lis2de_data_t are filled in place. Frames decoded before a failed
+ * burst are kept. */
+static uint8_t
+lis2de_read_fifo_strided(lis2de_dev_t *dev,
+                         const lis2de_fifo_src_t *src,
+                         uint8_t *head,
+                         uint8_t head_max,
+                         uint8_t *tail,
+                         uint8_t tail_max,
+                         uint8_t stride)
+{
+    uint8_t raw[LIS2DE_FIFO_BURST_FRAMES * 6];
+    uint8_t count = lis2de_fifo_src_frames(src);
+    uint16_t max = head_max + tail_max;
+    uint8_t done = 0;
+
+    if (count > max)
+    {
+        count = max;
+    }
+
+    while (done < count)
+    {
+        uint8_t chunk = count - done;
+
+        if (chunk > LIS2DE_FIFO_BURST_FRAMES)
+        {
+            chunk = LIS2DE_FIFO_BURST_FRAMES;
+        }
+        if (lis2de_read_bytes(dev, chunk * OUT_REG_XYZ.size, OUT_REG_XYZ.adr, raw))
+        {
+            break;
+        }
+
+        for (uint8_t i = 0; i < chunk; i++)
+        {
+            const uint8_t *frame = &raw[i * OUT_REG_XYZ.size];
+            uint8_t n = done + i;
+            lis2de_data_t *out = (lis2de_data_t *) ((n < head_max)
+                                 ? head + (uint16_t) n * stride
+                                 : tail + (uint16_t) (n - head_max) * stride);
+
+            out->x = (int8_t) frame[OUT_REG_X.adr - OUT_REG_XYZ.adr];
+            out->y = (int8_t) frame[OUT_REG_Y.adr - OUT_REG_XYZ.adr];
+            out->z = (int8_t) frame[OUT_REG_Z.adr - OUT_REG_XYZ.adr];
+        }
+        done += chunk;
+    }
+    return done;
+}
+
+uint8_t
+lis2de_read_fifo_frames(lis2de_dev_t *dev,
+                        const lis2de_fifo_src_t *src,
+                        lis2de_data_t *head,
+                        uint8_t head_max,
+                        lis2de_data_t *tail,
+                        uint8_t tail_max)
 {
-    return lis2de_query(FIFO_SRC_REG, BITMASK_7);
+    return lis2de_read_fifo_strided(dev, src, (uint8_t *) head, head_max,
+                                    (uint8_t *) tail, tail_max, sizeof(lis2de_data_t));
 }
 
 uint8_t
-lis2de_query_fifo_overrun(void)
+lis2de_read_fifo_frames_into(lis2de_dev_t *dev,
+                             const lis2de_fifo_src_t *src,
+                             lis2de_data_t *first,
+                             uint8_t max,
+                             uint8_t stride)
 {
-    return lis2de_query(FIFO_SRC_REG, BITMASK_6);
+    return lis2de_read_fifo_strided(dev, src, (uint8_t *) first, max, 0, 0, stride);
 }
 
 uint8_t
-lis2de_query_fifo_empty(void)
+lis2de_read_fifo_split(lis2de_dev_t *dev,
+                       lis2de_data_t *head,
+                       uint8_t head_max,
+                       lis2de_data_t *tail,
+                       uint8_t tail_max)
 {
-    return lis2de_query(FIFO_SRC_REG, BITMASK_5);
+    lis2de_fifo_src_t src = lis2de_query_fifo_src(dev);
+
+    return lis2de_read_fifo_frames(dev, &src, head, head_max, tail, tail_max);
 }
 
 uint8_t
-lis2de_query_fifo_current_number_of_unread_samples(void)
+lis2de_read_fifo(lis2de_dev_t *dev,
+                 lis2de_data_t *buf,
+                 uint8_t max)
 {
-    return lis2de_query(FIFO_SRC_REG, BITMASK_43210);
+    return lis2de_read_fifo_split(dev, buf, max, 0, 0);
 }
 
 // IG1_CFG (0x30)
 
 uint8_t
-lis2de_query_ig1_or_combination_of_interrupt_events_enabled(void)
+lis2de_query_ig1_or_combination_of_interrupt_events_enabled(lis2de_dev_t *dev)
 {
-    return (lis2de_query(IG1_CFG_REG, BITMASK_76) == 0b00);
+    return (lis2de_query(dev, IG1_CFG_REG, BITMASK_76) == 0b00);
 }
 
 uint8_t
-lis2de_query_ig1_and_combination_of_interrupt_events_enabled(void)
+lis2de_query_ig1_and_combination_of_interrupt_events_enabled(lis2de_dev_t *dev)
 {
-    return (lis2de_query(IG1_CFG_REG, BITMASK_76) == 0b10);
+    return (lis2de_query(dev, IG1_CFG_REG, BITMASK_76) == 0b10);
 }
 
 uint8_t
-lis2de_query_ig1_6_direction_movement_recognition_enabled(void)
+lis2de_query_ig1_6_direction_movement_recognition_enabled(lis2de_dev_t *dev)
 {
-    return (lis2de_query(IG1_CFG_REG, BITMASK_76) == 0b01);
+    return (lis2de_query(dev, IG1_CFG_REG, BITMASK_76) == 0b01);
 }
 
 uint8_t
-lis2de_query_ig1_6_direction_position_recognition_enabled(void)
+lis2de_query_ig1_6_direction_position_recognition_enabled(lis2de_dev_t *dev)
 {
-    return (lis2de_query(IG1_CFG_REG, BITMASK_76) == 0b11);
+    return (lis2de_query(dev, IG1_CFG_REG, BITMASK_76) == 0b11);
 }
 
 uint8_t
-lis2de_query_ig1_ig_on_z_high_event_or_dir_recognition_enabled(void)
+lis2de_query_ig1_ig_on_z_high_event_or_dir_recognition_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_CFG_REG, BITMASK_5);
+    return lis2de_query(dev, IG1_CFG_REG, BITMASK_5);
 }
 
 uint8_t
-lis2de_query_ig1_ig_on_z_low_event_or_dir_recognition_enabled(void)
+lis2de_query_ig1_ig_on_z_low_event_or_dir_recognition_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_CFG_REG, BITMASK_4);
+    return lis2de_query(dev, IG1_CFG_REG, BITMASK_4);
 }
 
 uint8_t
-lis2de_query_ig1_ig_on_y_high_event_or_dir_recognition_enabled(void)
+lis2de_query_ig1_ig_on_y_high_event_or_dir_recognition_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_CFG_REG, BITMASK_3);
+    return lis2de_query(dev, IG1_CFG_REG, BITMASK_3);
 }
 
 uint8_t
-lis2de_query_ig1_ig_on_y_low_event_or_dir_recognition_enabled(void)
+lis2de_query_ig1_ig_on_y_low_event_or_dir_recognition_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_CFG_REG, BITMASK_2);
+    return lis2de_query(dev, IG1_CFG_REG, BITMASK_2);
 }
 
 uint8_t
-lis2de_query_ig1_ig_on_x_high_event_or_dir_recognition_enabled(void)
+lis2de_query_ig1_ig_on_x_high_event_or_dir_recognition_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_CFG_REG, BITMASK_1);
+    return lis2de_query(dev, IG1_CFG_REG, BITMASK_1);
 }
 
 uint8_t
-lis2de_query_ig1_ig_on_x_low_event_or_dir_recognition_enabled(void)
+lis2de_query_ig1_ig_on_x_low_event_or_dir_recognition_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_CFG_REG, BITMASK_0);
+    return lis2de_query(dev, IG1_CFG_REG, BITMASK_0);
 }
 
 // IG1_SOURCE (0x31):
 
+static lis2de_ig_source_t
+lis2de_decode_ig_source(const uint8_t data)
+{
+    lis2de_ig_source_t src = {0};
+
+    src.interrupt_active = lis2de_field(data, BITMASK_6);
+    src.z_high           = lis2de_field(data, BITMASK_5);
+    src.z_low            = lis2de_field(data, BITMASK_4);
+    src.y_high           = lis2de_field(data, BITMASK_3);
+    src.y_low            = lis2de_field(data, BITMASK_2);
+    src.x_high           = lis2de_field(data, BITMASK_1);
+    src.x_low            = lis2de_field(data, BITMASK_0);
+
+    return src;
+}
+
+lis2de_ig_source_t
+lis2de_query_ig1_source(lis2de_dev_t *dev)
+{
+    return lis2de_decode_ig_source(lis2de_read_byte(dev, IG1_SOURCE_REG.adr));
+}
+
 uint8_t
-lis2de_query_ig1_interrupt_has_been_generated(void)
+lis2de_query_ig1_interrupt_has_been_generated(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_SOURCE_REG, BITMASK_6);
+    return lis2de_query(dev, IG1_SOURCE_REG, BITMASK_6);
 }
 
 uint8_t
-lis2de_query_ig1_z_high_event_has_occured(void)
+lis2de_query_ig1_z_high_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_SOURCE_REG, BITMASK_5);
+    return lis2de_query(dev, IG1_SOURCE_REG, BITMASK_5);
 }
 
 uint8_t
-lis2de_query_ig1_z_low_event_has_occured(void)
+lis2de_query_ig1_z_low_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_SOURCE_REG, BITMASK_4);
+    return lis2de_query(dev, IG1_SOURCE_REG, BITMASK_4);
 }
 
 uint8_t
-lis2de_query_ig1_y_high_event_has_occured(void)
+lis2de_query_ig1_y_high_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_SOURCE_REG, BITMASK_3);
+    return lis2de_query(dev, IG1_SOURCE_REG, BITMASK_3);
 }
 
 uint8_t
-lis2de_query_ig1_y_low_event_has_occured(void)
+lis2de_query_ig1_y_low_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_SOURCE_REG, BITMASK_2);
+    return lis2de_query(dev, IG1_SOURCE_REG, BITMASK_2);
 }
 
 uint8_t
-lis2de_query_ig1_x_high_event_has_occured(void)
+lis2de_query_ig1_x_high_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_SOURCE_REG, BITMASK_1);
+    return lis2de_query(dev, IG1_SOURCE_REG, BITMASK_1);
 }
 
 uint8_t
-lis2de_query_ig1_x_low_event_has_occured(void)
+lis2de_query_ig1_x_low_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_SOURCE_REG, BITMASK_0);
+    return lis2de_query(dev, IG1_SOURCE_REG, BITMASK_0);
 }
 
 // IG1_THS (0x32):
 
 uint8_t
-lis2de_query_ig1_threshold(void)
+lis2de_query_ig1_threshold(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_THS_REG, BITMASK_FULL);
+    return lis2de_query(dev, IG1_THS_REG, BITMASK_FULL);
 }
 
 // IG1_DURATION (0x33):
 
-uint8_t lis2de_query_ig1_duration(void)
+uint8_t lis2de_query_ig1_duration(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG1_DURATION_REG, BITMASK_FULL);
+    return lis2de_query(dev, IG1_DURATION_REG, BITMASK_FULL);
 }
 
 // IG2_CFG (0x34)
 
 uint8_t
-lis2de_query_ig2_or_combination_of_interrupt_events_enabled(void)
+lis2de_query_ig2_or_combination_of_interrupt_events_enabled(lis2de_dev_t *dev)
 {
-    return (lis2de_query(IG2_CFG_REG, BITMASK_76) == 0b00);
+    return (lis2de_query(dev, IG2_CFG_REG, BITMASK_76) == 0b00);
 }
 
 uint8_t
-lis2de_query_ig2_and_combination_of_interrupt_events_enabled(void)
+lis2de_query_ig2_and_combination_of_interrupt_events_enabled(lis2de_dev_t *dev)
 {
-    return (lis2de_query(IG2_CFG_REG, BITMASK_76) == 0b10);
+    return (lis2de_query(dev, IG2_CFG_REG, BITMASK_76) == 0b10);
 }
 
 uint8_t
-lis2de_query_ig2_6_direction_movement_recognition_enabled(void)
+lis2de_query_ig2_6_direction_movement_recognition_enabled(lis2de_dev_t *dev)
 {
-    return (lis2de_query(IG2_CFG_REG, BITMASK_76) == 0b01);
+    return (lis2de_query(dev, IG2_CFG_REG, BITMASK_76) == 0b01);
 }
 
 uint8_t
-lis2de_query_ig2_6_direction_position_recognition_enabled(void)
+lis2de_query_ig2_6_direction_position_recognition_enabled(lis2de_dev_t *dev)
 {
-    return (lis2de_query(IG2_CFG_REG, BITMASK_76) == 0b11);
+    return (lis2de_query(dev, IG2_CFG_REG, BITMASK_76) == 0b11);
 }
 
 uint8_t
-lis2de_query_ig2_ig_on_z_high_event_or_dir_recognition_enabled(void)
+lis2de_query_ig2_ig_on_z_high_event_or_dir_recognition_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_CFG_REG, BITMASK_5);
+    return lis2de_query(dev, IG2_CFG_REG, BITMASK_5);
 }
 
 uint8_t
-lis2de_query_ig2_ig_on_z_low_event_or_dir_recognition_enabled(void)
+lis2de_query_ig2_ig_on_z_low_event_or_dir_recognition_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_CFG_REG, BITMASK_4);
+    return lis2de_query(dev, IG2_CFG_REG, BITMASK_4);
 }
 
 uint8_t
-lis2de_query_ig2_ig_on_y_high_event_or_dir_recognition_enabled(void)
+lis2de_query_ig2_ig_on_y_high_event_or_dir_recognition_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_CFG_REG, BITMASK_3);
+    return lis2de_query(dev, IG2_CFG_REG, BITMASK_3);
 }
 
 uint8_t
-lis2de_query_ig2_ig_on_y_low_event_or_dir_recognition_enabled(void)
+lis2de_query_ig2_ig_on_y_low_event_or_dir_recognition_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_CFG_REG, BITMASK_2);
+    return lis2de_query(dev, IG2_CFG_REG, BITMASK_2);
 }
 
 uint8_t
-lis2de_query_ig2_ig_on_x_high_event_or_dir_recognition_enabled(void)
+lis2de_query_ig2_ig_on_x_high_event_or_dir_recognition_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_CFG_REG, BITMASK_1);
+    return lis2de_query(dev, IG2_CFG_REG, BITMASK_1);
 }
 
 uint8_t
-lis2de_query_ig2_ig_on_x_low_event_or_dir_recognition_enabled(void)
+lis2de_query_ig2_ig_on_x_low_event_or_dir_recognition_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_CFG_REG, BITMASK_0);
+    return lis2de_query(dev, IG2_CFG_REG, BITMASK_0);
 }
 
 // IG2_SOURCE (0x35):
 
+lis2de_ig_source_t
+lis2de_query_ig2_source(lis2de_dev_t *dev)
+{
+    return lis2de_decode_ig_source(lis2de_read_byte(dev, IG2_SOURCE_REG.adr));
+}
+
 uint8_t
-lis2de_query_ig2_interrupt_has_been_generated(void)
+lis2de_query_ig2_interrupt_has_been_generated(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_SOURCE_REG, BITMASK_6);
+    return lis2de_query(dev, IG2_SOURCE_REG, BITMASK_6);
 }
 
 uint8_t
-lis2de_query_ig2_z_high_event_has_occured(void)
+lis2de_query_ig2_z_high_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_SOURCE_REG, BITMASK_5);
+    return lis2de_query(dev, IG2_SOURCE_REG, BITMASK_5);
 }
 
 uint8_t
-lis2de_query_ig2_z_low_event_has_occured(void)
+lis2de_query_ig2_z_low_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_SOURCE_REG, BITMASK_4);
+    return lis2de_query(dev, IG2_SOURCE_REG, BITMASK_4);
 }
 
 uint8_t
-lis2de_query_ig2_y_high_event_has_occured(void)
+lis2de_query_ig2_y_high_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_SOURCE_REG, BITMASK_3);
+    return lis2de_query(dev, IG2_SOURCE_REG, BITMASK_3);
 }
 
 uint8_t
-lis2de_query_ig2_y_low_event_has_occured(void)
+lis2de_query_ig2_y_low_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_SOURCE_REG, BITMASK_2);
+    return lis2de_query(dev, IG2_SOURCE_REG, BITMASK_2);
 }
 
 uint8_t
-lis2de_query_ig2_x_high_event_has_occured(void)
+lis2de_query_ig2_x_high_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_SOURCE_REG, BITMASK_1);
+    return lis2de_query(dev, IG2_SOURCE_REG, BITMASK_1);
 }
 
 uint8_t
-lis2de_query_ig2_x_low_event_has_occured(void)
+lis2de_query_ig2_x_low_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_SOURCE_REG, BITMASK_0);
+    return lis2de_query(dev, IG2_SOURCE_REG, BITMASK_0);
 }
 
 // IG2_THS (0x36)
 
 uint8_t
-lis2de_query_ig2_threshold(void)
+lis2de_query_ig2_threshold(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_THS_REG, BITMASK_FULL);
+    return lis2de_query(dev, IG2_THS_REG, BITMASK_FULL);
 }
 
 // IG2_DURATION (0x37)
 
-uint8_t lis2de_query_ig2_duration(void)
+uint8_t lis2de_query_ig2_duration(lis2de_dev_t *dev)
 {
-    return lis2de_query(IG2_DURATION_REG, BITMASK_FULL);
+    return lis2de_query(dev, IG2_DURATION_REG, BITMASK_FULL);
 }
 
 // CLICK_CFG (0x38)
 
 uint8_t
-lis2de_query_interrupt_double_click_on_z_axis_enabled(void)
+lis2de_query_interrupt_double_click_on_z_axis_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_CFG_REG, BITMASK_5);
+    return lis2de_query(dev, CLICK_CFG_REG, BITMASK_5);
 }
 
 uint8_t
-lis2de_query_interrupt_single_click_on_z_axis_enabled(void)
+lis2de_query_interrupt_single_click_on_z_axis_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_CFG_REG, BITMASK_4);
+    return lis2de_query(dev, CLICK_CFG_REG, BITMASK_4);
 }
 
 uint8_t
-lis2de_query_interrupt_double_click_on_y_axis_enabled(void)
+lis2de_query_interrupt_double_click_on_y_axis_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_CFG_REG, BITMASK_3);
+    return lis2de_query(dev, CLICK_CFG_REG, BITMASK_3);
 }
 
 uint8_t
-lis2de_query_interrupt_single_click_on_y_axis_enabled(void)
+lis2de_query_interrupt_single_click_on_y_axis_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_CFG_REG, BITMASK_2);
+    return lis2de_query(dev, CLICK_CFG_REG, BITMASK_2);
 }
 
 uint8_t
-lis2de_query_interrupt_double_click_on_x_axis_enabled(void)
+lis2de_query_interrupt_double_click_on_x_axis_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_CFG_REG, BITMASK_1);
+    return lis2de_query(dev, CLICK_CFG_REG, BITMASK_1);
 }
 
 uint8_t
-lis2de_query_interrupt_single_click_on_x_axis_enabled(void)
+lis2de_query_interrupt_single_click_on_x_axis_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_CFG_REG, BITMASK_0);
+    return lis2de_query(dev, CLICK_CFG_REG, BITMASK_0);
 }
 
 // CLICK_SRC (0x39)
 
+lis2de_click_src_t
+lis2de_query_click_src(lis2de_dev_t *dev)
+{
+    lis2de_click_src_t src = {0};
+    uint8_t data = lis2de_read_byte(dev, CLICK_SRC_REG.adr);
+
+    src.interrupt_active = lis2de_field(data, BITMASK_6);
+    src.double_click     = lis2de_field(data, BITMASK_5);
+    src.single_click     = lis2de_field(data, BITMASK_4);
+    src.sign             = lis2de_field(data, BITMASK_3);
+    src.z_click          = lis2de_field(data, BITMASK_2);
+    src.y_click          = lis2de_field(data, BITMASK_1);
+    src.x_click          = lis2de_field(data, BITMASK_0);
+
+    return src;
+}
+
 uint8_t
-lis2de_query_interrupts_have_been_generated(void)
+lis2de_query_interrupts_have_been_generated(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_SRC_REG, BITMASK_6);
+    return lis2de_query(dev, CLICK_SRC_REG, BITMASK_6);
 }
 
 uint8_t
-lis2de_query_double_click_enabled(void)
+lis2de_query_double_click_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_SRC_REG, BITMASK_5);
+    return lis2de_query(dev, CLICK_SRC_REG, BITMASK_5);
 }
 
 uint8_t
-lis2de_query_single_click_enabled(void)
+lis2de_query_single_click_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_SRC_REG, BITMASK_4);
+    return lis2de_query(dev, CLICK_SRC_REG, BITMASK_4);
 }
 
 uint8_t
-lis2de_query_click_sign(void)
+lis2de_query_click_sign(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_SRC_REG, BITMASK_3);
+    return lis2de_query(dev, CLICK_SRC_REG, BITMASK_3);
 }
 
 uint8_t
-lis2de_query_z_click_high_event_has_occured(void)
+lis2de_query_z_click_high_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_SRC_REG, BITMASK_2);
+    return lis2de_query(dev, CLICK_SRC_REG, BITMASK_2);
 }
 
 uint8_t
-lis2de_query_y_click_high_event_has_occured(void)
+lis2de_query_y_click_high_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_SRC_REG, BITMASK_1);
+    return lis2de_query(dev, CLICK_SRC_REG, BITMASK_1);
 }
 
 uint8_t
-lis2de_query_x_click_high_event_has_occured(void)
+lis2de_query_x_click_high_event_has_occured(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_SRC_REG, BITMASK_0);
+    return lis2de_query(dev, CLICK_SRC_REG, BITMASK_0);
 }
 
 // CLICK_THS (0x3A)
 
 uint8_t
-lis2de_query_latch_interrupt_request_on_click_src_reg_enabled(void)
+lis2de_query_latch_interrupt_request_on_click_src_reg_enabled(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_THS_REG, BITMASK_7);
+    return lis2de_query(dev, CLICK_THS_REG, BITMASK_7);
 }
 
 uint8_t
-lis2de_query_click_threshold(void)
+lis2de_query_click_threshold(lis2de_dev_t *dev)
 {
-    return lis2de_query(CLICK_THS_REG, BITMASK_6543210);
+    return lis2de_query(dev, CLICK_THS_REG, BITMASK_6543210);
 }
 
 // TIME_LIMIT (0x3B)
 
 uint8_t
-lis2de_query_time_limit(void)
+lis2de_query_time_limit(lis2de_dev_t *dev)
 {
-    return lis2de_query(TIME_LIMIT_REG, BITMASK_FULL);
+    return lis2de_query(dev, TIME_LIMIT_REG, BITMASK_FULL);
 }
 
 // TIME_LATENCY (0x3C)
 
 uint8_t
-lis2de_query_time_latency(void)
+lis2de_query_time_latency(lis2de_dev_t *dev)
 {
-    return lis2de_query(TIME_LATENCY_REG, BITMASK_FULL);
+    return lis2de_query(dev, TIME_LATENCY_REG, BITMASK_FULL);
 }
 
 // TIME_WINDOW (0x3D)
 
 uint8_t
-lis2de_query_time_window(void)
+lis2de_query_time_window(lis2de_dev_t *dev)
 {
-    return lis2de_query(TIME_WINDOW_REG, BITMASK_FULL);
+    return lis2de_query(dev, TIME_WINDOW_REG, BITMASK_FULL);
 }
 
 // Act_THS (0x3E)
 
 uint8_t
-lis2de_query_act_threshold(void)
+lis2de_query_act_threshold(lis2de_dev_t *dev)
 {
-    return lis2de_query(ACT_THS_REG, BITMASK_FULL);
+    return lis2de_query(dev, ACT_THS_REG, BITMASK_FULL);
 }
 
 // Act_DUR (0x3F)
 
 uint8_t
-lis2de_query_act_duration(void)
+lis2de_query_act_duration(lis2de_dev_t *dev)
 {
-    return lis2de_query(ACT_DUR_REG, BITMASK_FULL);
+    return lis2de_query(dev, ACT_DUR_REG, BITMASK_FULL);
 }
 
 static uint8_t
-lis2de_query_operating_mode(void)
+lis2de_query_operating_mode(lis2de_dev_t *dev)
 {
-    return lis2de_query(CTRL_REG1, BITMASK_3);
+    return lis2de_query(dev, CTRL_REG1, BITMASK_3);
 }
 
 uint8_t
-lis2de_query_current_operating_mode_is_normal_mode(void)
+lis2de_query_current_operating_mode_is_normal_mode(lis2de_dev_t *dev)
 {
-    return (lis2de_query_operating_mode() == OP_MODE_NORMAL);
+    return (lis2de_query_operating_mode(dev) == OP_MODE_NORMAL);
 }
 
 uint8_t
-lis2de_query_current_operating_mode_is_low_power_mode(void)
+lis2de_query_current_operating_mode_is_low_power_mode(lis2de_dev_t *dev)
 {
-    return (lis2de_query_operating_mode() == OP_MODE_LOW_POWER);
+    return (lis2de_query_operating_mode(dev) == OP_MODE_LOW_POWER);
 }
 
 // Set-functions for all writable registers:
 
 
 void
-lis2de_set_operating_mode_to_normal_mode(void)
+lis2de_set_operating_mode_to_normal_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_3, 0b0);
+    lis2de_set(dev, CTRL_REG1, BITMASK_3, 0b0);
 }
 
 void
-lis2de_set_operating_mode_to_low_power_mode(void)
+lis2de_set_operating_mode_to_low_power_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_3, 0b1);
+    lis2de_set(dev, CTRL_REG1, BITMASK_3, 0b1);
 }
 
 void
-lis2de_set_operating_mode_to_high_resolution_mode(void)
+lis2de_set_operating_mode_to_high_resolution_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_3, 0b0);
+    lis2de_set(dev, CTRL_REG1, BITMASK_3, 0b0);
 }
 
 
 void
-lis2de_enable_temperature_sensor(void)
+lis2de_enable_temperature_sensor(lis2de_dev_t *dev)
 {
-    lis2de_set(TEMP_CFG_REG, BITMASK_76, 0b11);
+    lis2de_set(dev, TEMP_CFG_REG, BITMASK_76, 0b11);
 }
 
 void
-lis2de_disable_temperature_sensor(void)
+lis2de_disable_temperature_sensor(lis2de_dev_t *dev)
 {
-    lis2de_set(TEMP_CFG_REG, BITMASK_76, 0b00);
+    lis2de_set(dev, TEMP_CFG_REG, BITMASK_76, 0b00);
 }
 
 // CTRL_REG1 (0x20)
 
-void lis2de_set_power_down_mode(void)
+void lis2de_set_power_down_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_7654, 0b0000);
+    lis2de_set(dev, CTRL_REG1, BITMASK_7654, 0b0000);
 }
 
 void
-lis2de_set_data_rate_to_1hz(void)
+lis2de_set_data_rate_to_1hz(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_7654, 0b0001);
+    lis2de_set(dev, CTRL_REG1, BITMASK_7654, 0b0001);
 }
 
 void
-lis2de_set_data_rate_to_10hz(void)
+lis2de_set_data_rate_to_10hz(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_7654, 0b0010);
+    lis2de_set(dev, CTRL_REG1, BITMASK_7654, 0b0010);
 }
 
 void
-lis2de_set_data_rate_to_25hz(void)
+lis2de_set_data_rate_to_25hz(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_7654, 0b0011);
+    lis2de_set(dev, CTRL_REG1, BITMASK_7654, 0b0011);
 }
 
 void
-lis2de_set_data_rate_to_50hz(void)
+lis2de_set_data_rate_to_50hz(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_7654, 0b0100);
+    lis2de_set(dev, CTRL_REG1, BITMASK_7654, 0b0100);
 }
 
 void
-lis2de_set_data_rate_to_100hz(void)
+lis2de_set_data_rate_to_100hz(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_7654, 0b0101);
+    lis2de_set(dev, CTRL_REG1, BITMASK_7654, 0b0101);
 }
 
 void
-lis2de_set_data_rate_to_200hz(void)
+lis2de_set_data_rate_to_200hz(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_7654, 0b0110);
+    lis2de_set(dev, CTRL_REG1, BITMASK_7654, 0b0110);
 }
 
 void
-lis2de_set_data_rate_to_400hz(void)
+lis2de_set_data_rate_to_400hz(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_7654, 0b0111);
+    lis2de_set(dev, CTRL_REG1, BITMASK_7654, 0b0111);
 }
 
 void
-lis2de_set_low_power_mode(void)
+lis2de_set_low_power_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_7654, 0b1000);
+    lis2de_set(dev, CTRL_REG1, BITMASK_7654, 0b1000);
 }
 
 void
-lis2de_set_data_rate_to_max(void)
+lis2de_set_data_rate_to_max(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_7654, 0b1001);
+    lis2de_set(dev, CTRL_REG1, BITMASK_7654, 0b1001);
 }
 
 void
-lis2de_enable_z_axis(void)
+lis2de_enable_z_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_2, 0b1);
+    lis2de_set(dev, CTRL_REG1, BITMASK_2, 0b1);
 }
 
 void
-lis2de_disable_z_axis(void)
+lis2de_disable_z_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_2, 0b0);
+    lis2de_set(dev, CTRL_REG1, BITMASK_2, 0b0);
 }
 
 void
-lis2de_enable_y_axis(void)
+lis2de_enable_y_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_1, 0b1);
+    lis2de_set(dev, CTRL_REG1, BITMASK_1, 0b1);
 }
 
 void
-lis2de_disable_y_axis(void)
+lis2de_disable_y_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_1, 0b0);
+    lis2de_set(dev, CTRL_REG1, BITMASK_1, 0b0);
 }
 
 void
-lis2de_enable_x_axis(void)
+lis2de_enable_x_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_0, 0b1);
+    lis2de_set(dev, CTRL_REG1, BITMASK_0, 0b1);
 }
 
 void
-lis2de_disable_x_axis(void)
+lis2de_disable_x_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG1, BITMASK_0, 0b0);
+    lis2de_set(dev, CTRL_REG1, BITMASK_0, 0b0);
 }
 
 // CTRL_REG2 (0x21):
 
 void
-lis2de_set_high_pass_filter_to_normal_mode(void)
+lis2de_set_high_pass_filter_to_normal_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_76, 0b00);
+    lis2de_set(dev, CTRL_REG2, BITMASK_76, 0b00);
 }
 
 void
-lis2de_set_high_pass_filter_to_reference_mode(void)
+lis2de_set_high_pass_filter_to_reference_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_76, 0b01);
+    lis2de_set(dev, CTRL_REG2, BITMASK_76, 0b01);
 }
 
 void
-lis2de_set_high_pass_filter_to_autoreset_mode(void)
+lis2de_set_high_pass_filter_to_autoreset_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_76, 0b11);
+    lis2de_set(dev, CTRL_REG2, BITMASK_76, 0b11);
 }
 
 void
-lis2de_set_high_pass_filter_cut_off_freq_to_8()
+lis2de_set_high_pass_filter_cut_off_freq_to_8(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_54, 0b00);
+    lis2de_set(dev, CTRL_REG2, BITMASK_54, 0b00);
 }
 
 void
-lis2de_set_high_pass_filter_cut_off_freq_to_16()
+lis2de_set_high_pass_filter_cut_off_freq_to_16(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_54, 0b01);
+    lis2de_set(dev, CTRL_REG2, BITMASK_54, 0b01);
 }
 
 void
-lis2de_set_high_pass_filter_cut_off_freq_to_32()
+lis2de_set_high_pass_filter_cut_off_freq_to_32(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_54, 0b10);
+    lis2de_set(dev, CTRL_REG2, BITMASK_54, 0b10);
 }
 
 void
-lis2de_set_high_pass_filter_cut_off_freq_to_64()
+lis2de_set_high_pass_filter_cut_off_freq_to_64(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_54, 0b11);
+    lis2de_set(dev, CTRL_REG2, BITMASK_54, 0b11);
 }
 
 void
-lis2de_enable_internal_filter_bypass(void)
+lis2de_enable_internal_filter_bypass(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_3, 0b0);
+    lis2de_set(dev, CTRL_REG2, BITMASK_3, 0b0);
 }
 
 void
-lis2de_disable_internal_filter_bypass(void)
+lis2de_disable_internal_filter_bypass(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_3, 0b1);
+    lis2de_set(dev, CTRL_REG2, BITMASK_3, 0b1);
 }
 
 void
-lis2de_enable_high_pass_filter_for_click_function(void)
+lis2de_enable_high_pass_filter_for_click_function(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_2, 0b1);
+    lis2de_set(dev, CTRL_REG2, BITMASK_2, 0b1);
 }
 
 void
-lis2de_disable_high_pass_filter_for_click_function(void)
+lis2de_disable_high_pass_filter_for_click_function(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_2, 0b0);
+    lis2de_set(dev, CTRL_REG2, BITMASK_2, 0b0);
 }
 
 void
-lis2de_enable_high_pass_filter_for_aoi_function_on_int2(void)
+lis2de_enable_high_pass_filter_for_aoi_function_on_int2(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_1, 0b1);
+    lis2de_set(dev, CTRL_REG2, BITMASK_1, 0b1);
 }
 
 void
-lis2de_disable_high_pass_filter_for_aoi_function_on_int2(void)
+lis2de_disable_high_pass_filter_for_aoi_function_on_int2(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_1, 0b0);
+    lis2de_set(dev, CTRL_REG2, BITMASK_1, 0b0);
 }
 
 void
-lis2de_enable_high_pass_filter_for_aoi_function_on_int1(void)
+lis2de_enable_high_pass_filter_for_aoi_function_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_0, 0b1);
+    lis2de_set(dev, CTRL_REG2, BITMASK_0, 0b1);
 }
 
 void
-lis2de_disable_high_pass_filter_for_aoi_function_on_int1(void)
+lis2de_disable_high_pass_filter_for_aoi_function_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG2, BITMASK_0, 0b0);
+    lis2de_set(dev, CTRL_REG2, BITMASK_0, 0b0);
 }
 
 
 // CTRL_REG3 (0x22)
 
 void
-lis2de_enable_click_interrupt_on_int1(void)
+lis2de_enable_click_interrupt_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG3, BITMASK_7, 0b1);
+    lis2de_set(dev, CTRL_REG3, BITMASK_7, 0b1);
 }
 
 void
-lis2de_disable_click_interrupt_on_int1(void)
+lis2de_disable_click_interrupt_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG3, BITMASK_7, 0b0);
+    lis2de_set(dev, CTRL_REG3, BITMASK_7, 0b0);
 }
 
 void
-lis2de_enable_aoi_interrupt_on_int1(void)
+lis2de_enable_aoi_interrupt_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG3, BITMASK_6, 0b1);
+    lis2de_set(dev, CTRL_REG3, BITMASK_6, 0b1);
 }
 
 void
-lis2de_disable_aoi_interrupt_on_int1(void)
+lis2de_disable_aoi_interrupt_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG3, BITMASK_6, 0b0);
+    lis2de_set(dev, CTRL_REG3, BITMASK_6, 0b0);
 }
 
 void
-lis2de_enable_aoi_interrupt_on_int2(void)
+lis2de_enable_aoi_interrupt_on_int2(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG3, BITMASK_5, 0b1);
+    lis2de_set(dev, CTRL_REG3, BITMASK_5, 0b1);
 }
 
 void
-lis2de_disable_aoi_interrupt_on_int2(void)
+lis2de_disable_aoi_interrupt_on_int2(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG3, BITMASK_5, 0b0);
+    lis2de_set(dev, CTRL_REG3, BITMASK_5, 0b0);
 }
 
 void
-lis2de_enable_drdy1_interrupt_on_int1(void)
+lis2de_enable_drdy1_interrupt_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG3, BITMASK_4, 0b1);
+    lis2de_set(dev, CTRL_REG3, BITMASK_4, 0b1);
 }
 
 void
-lis2de_disable_drdy1_interrupt_on_int1(void)
+lis2de_disable_drdy1_interrupt_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG3, BITMASK_4, 0b0);
+    lis2de_set(dev, CTRL_REG3, BITMASK_4, 0b0);
 }
 
 void
-lis2de_enable_drdy2_interrupt_on_int1(void)
+lis2de_enable_drdy2_interrupt_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG3, BITMASK_3, 0b1);
+    lis2de_set(dev, CTRL_REG3, BITMASK_3, 0b1);
 }
 
 void
-lis2de_disable_drdy2_interrupt_on_int1(void)
+lis2de_disable_drdy2_interrupt_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG3, BITMASK_3, 0b0);
+    lis2de_set(dev, CTRL_REG3, BITMASK_3, 0b0);
 }
 
 void
-lis2de_enable_fifo_watermark_interrupt_on_int1(void)
+lis2de_enable_fifo_watermark_interrupt_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG3, BITMASK_2, 0b1);
+    lis2de_set(dev, CTRL_REG3, BITMASK_2, 0b1);
 }
 
 void
-lis2de_disable_fifo_watermark_interrupt_on_int1(void)
+lis2de_disable_fifo_watermark_interrupt_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG3, BITMASK_2, 0b0);
+    lis2de_set(dev, CTRL_REG3, BITMASK_2, 0b0);
 }
 
 void
-lis2de_enable_fifo_overrun_interrupt_on_int1(void)
+lis2de_enable_fifo_overrun_interrupt_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG3, BITMASK_1, 0b1);
+    lis2de_set(dev, CTRL_REG3, BITMASK_1, 0b1);
 }
 
 void
-lis2de_disable_fifo_overrun_interrupt_on_int1(void)
+lis2de_disable_fifo_overrun_interrupt_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG3, BITMASK_1, 0b0);
+    lis2de_set(dev, CTRL_REG3, BITMASK_1, 0b0);
 }
 
 // CTRL_REG4 (0x23)
 
 void
-lis2de_enable_continuos_block_data_update(void)
+lis2de_enable_continuos_block_data_update(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG4, BITMASK_7, 0b0);
+    lis2de_set(dev, CTRL_REG4, BITMASK_7, 0b0);
 }
 
 void
-lis2de_disable_continuos_block_data_update(void)
+lis2de_disable_continuos_block_data_update(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG4, BITMASK_7, 0b1);
+    lis2de_set(dev, CTRL_REG4, BITMASK_7, 0b1);
 }
 
 void
-lis2de_set_full_scale_to_2g(void)
+lis2de_set_full_scale_to_2g(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG4, BITMASK_54, 0b00);
+    lis2de_set(dev, CTRL_REG4, BITMASK_54, 0b00);
 }
 
 void
-lis2de_set_full_scale_to_4g(void)
+lis2de_set_full_scale_to_4g(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG4, BITMASK_54, 0b01);
+    lis2de_set(dev, CTRL_REG4, BITMASK_54, 0b01);
 }
 
 void
-lis2de_set_full_scale_to_8g(void)
+lis2de_set_full_scale_to_8g(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG4, BITMASK_54, 0b10);
+    lis2de_set(dev, CTRL_REG4, BITMASK_54, 0b10);
 }
 
 void
-lis2de_set_full_scale_to_16g(void)
+lis2de_set_full_scale_to_16g(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG4, BITMASK_54, 0b11);
+    lis2de_set(dev, CTRL_REG4, BITMASK_54, 0b11);
 }
 
 void
-lis2de_enable_self_test_mode(void)
+lis2de_enable_self_test_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG4, BITMASK_21, 0b01);
+    lis2de_set(dev, CTRL_REG4, BITMASK_21, 0b01);
 }
 
 void
-lis2de_disable_self_test_mode(void)
+lis2de_disable_self_test_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG4, BITMASK_21, 0b00);
+    lis2de_set(dev, CTRL_REG4, BITMASK_21, 0b00);
 }
 
 void
-lis2de_set_spi_4_wire_interface_mode(void)
+lis2de_set_spi_4_wire_interface_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG4, BITMASK_0, 0b0);
+    lis2de_set(dev, CTRL_REG4, BITMASK_0, 0b0);
 }
 
 void
-lis2de_set_spi_3_wire_interface_mode(void)
+lis2de_set_spi_3_wire_interface_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG4, BITMASK_0, 0b1);
+    lis2de_set(dev, CTRL_REG4, BITMASK_0, 0b1);
 }
 
 
 // CTRL_REG5 (0x24)
 void
-lis2de_reboot_memory_content(void)
+lis2de_reboot_memory_content(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG5, BITMASK_7, 0b1);
+    /* Never deferred. The device content is read from the bus, as
+     * pending batch changes must not slip in with the BOOT write, and
+     * the batch is dropped since the reboot resets what it builds on. */
+    uint8_t data = lis2de_read_byte(dev, CTRL_REG5.adr);
+    lis2de_write_byte(dev, CTRL_REG5.adr, data | BITMASK_7.mask);
+    lis2de_discard_configuration(dev);
+
+    // The reboot reloads all registers, BOOT clears itself when done
+    lis2de_shadow_registers_invalidate(dev);
 }
 
 void
-lis2de_enable_fifo(void)
+lis2de_enable_fifo(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG5, BITMASK_6, 0b1);
+    lis2de_set(dev, CTRL_REG5, BITMASK_6, 0b1);
 }
 
 void
-lis2de_disable_fifo(void)
+lis2de_disable_fifo(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG5, BITMASK_6, 0b0);
+    lis2de_set(dev, CTRL_REG5, BITMASK_6, 0b0);
 }
 
 void
-lis2de_enable_latch_interrupt_request_on_ig1_src_reg(void)
+lis2de_enable_latch_interrupt_request_on_ig1_src_reg(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG5, BITMASK_3, 0b1);
+    lis2de_set(dev, CTRL_REG5, BITMASK_3, 0b1);
 }
 
 void
-lis2de_disable_latch_interrupt_request_on_ig1_src_reg(void)
+lis2de_disable_latch_interrupt_request_on_ig1_src_reg(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG5, BITMASK_3, 0b0);
+    lis2de_set(dev, CTRL_REG5, BITMASK_3, 0b0);
 }
 
 void
-lis2de_enable_latch_interrupt_request_on_int2_src_reg(void)
+lis2de_enable_latch_interrupt_request_on_ig2_src_reg(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG5, BITMASK_1, 0b1);
+    lis2de_set(dev, CTRL_REG5, BITMASK_1, 0b1);
 }
 
 void
-lis2de_disable_latch_interrupt_request_on_int2_src_reg(void)
+lis2de_disable_latch_interrupt_request_on_ig2_src_reg(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG5, BITMASK_1, 0b0);
+    lis2de_set(dev, CTRL_REG5, BITMASK_1, 0b0);
 }
 
 // CTRL_REG6 (0x25):
 
 void
-lis2de_enable_click_interrupt_on_ig2_pin(void)
+lis2de_enable_click_interrupt_on_ig2_pin(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG6, BITMASK_7, 0b1);
+    lis2de_set(dev, CTRL_REG6, BITMASK_7, 0b1);
 }
 
 void
-lis2de_disable_click_interrupt_on_ig2_pin(void)
+lis2de_disable_click_interrupt_on_ig2_pin(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG6, BITMASK_7, 0b0);
+    lis2de_set(dev, CTRL_REG6, BITMASK_7, 0b0);
 }
 
 void
-lis2de_enable_interrupt_1_function_on_ig2_pin(void)
+lis2de_enable_interrupt_1_function_on_ig2_pin(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG6, BITMASK_6, 0b1);
+    lis2de_set(dev, CTRL_REG6, BITMASK_6, 0b1);
 }
 
 void
-lis2de_disable_interrupt_1_function_on_ig2_pin(void)
+lis2de_disable_interrupt_1_function_on_ig2_pin(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG6, BITMASK_6, 0b0);
+    lis2de_set(dev, CTRL_REG6, BITMASK_6, 0b0);
 }
 
 void
-lis2de_enable_interrupt_2_function_on_ig2_pin(void)
+lis2de_enable_interrupt_2_function_on_ig2_pin(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG6, BITMASK_5, 0b1);
+    lis2de_set(dev, CTRL_REG6, BITMASK_5, 0b1);
 }
 
 void
-lis2de_disable_interrupt_2_function_on_ig2_pin(void)
+lis2de_disable_interrupt_2_function_on_ig2_pin(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG6, BITMASK_5, 0b0);
+    lis2de_set(dev, CTRL_REG6, BITMASK_5, 0b0);
 }
 
 void
-lis2de_enable_boot_on_ig2_pin(void)
+lis2de_enable_boot_on_ig2_pin(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG6, BITMASK_4, 0b1);
+    lis2de_set(dev, CTRL_REG6, BITMASK_4, 0b1);
 }
 
 void
-lis2de_disable_boot_on_ig2_pin(void)
+lis2de_disable_boot_on_ig2_pin(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG6, BITMASK_4, 0b0);
+    lis2de_set(dev, CTRL_REG6, BITMASK_4, 0b0);
 }
 
 void
-lis2de_enable_activity_interrupt_on_ig2_pin(void)
+lis2de_enable_activity_interrupt_on_ig2_pin(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG6, BITMASK_3, 0b1);
+    lis2de_set(dev, CTRL_REG6, BITMASK_3, 0b1);
 }
 
 void
-lis2de_disable_activity_interrupt_on_ig2_pin(void)
+lis2de_disable_activity_interrupt_on_ig2_pin(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG6, BITMASK_3, 0b0);
+    lis2de_set(dev, CTRL_REG6, BITMASK_3, 0b0);
 }
 
 void
-lis2de_set_interrupt_active_high(void)
+lis2de_set_interrupt_active_high(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG6, BITMASK_1, 0b1);
+    lis2de_set(dev, CTRL_REG6, BITMASK_1, 0b1);
 }
 
 void
-lis2de_set_interrupt_active_low(void)
+lis2de_set_interrupt_active_low(lis2de_dev_t *dev)
 {
-    lis2de_set(CTRL_REG6, BITMASK_1, 0b1);
+    lis2de_set(dev, CTRL_REG6, BITMASK_1, 0b1);
 }
 
 // REFERENCE (0x26):
 
 void
-lis2de_set_reference(uint8_t value)
+lis2de_set_reference(lis2de_dev_t *dev,
+                     uint8_t value)
 {
-    lis2de_set(REFERENCE_REG, BITMASK_FULL, value);
+    lis2de_set(dev, REFERENCE_REG, BITMASK_FULL, value);
 }
 
 
 // FIFO_CTRL_REG (0x2E):
 void
-lis2de_set_fifo_mode_to_bypass_mode(void)
+lis2de_set_fifo_mode_to_bypass_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(FIFO_CTRL_REG, BITMASK_76, 0b00);
+    lis2de_set(dev, FIFO_CTRL_REG, BITMASK_76, 0b00);
 }
 
 void
-lis2de_set_fifo_mode_to_fifo_mode(void)
+lis2de_set_fifo_mode_to_fifo_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(FIFO_CTRL_REG, BITMASK_76, 0b01);
+    lis2de_set(dev, FIFO_CTRL_REG, BITMASK_76, 0b01);
 }
 
 void
-lis2de_set_fifo_mode_to_stream_mode(void)
+lis2de_set_fifo_mode_to_stream_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(FIFO_CTRL_REG, BITMASK_76, 0b10);
+    lis2de_set(dev, FIFO_CTRL_REG, BITMASK_76, 0b10);
 }
 
 void
-lis2de_set_fifo_mode_to_trigger_mode(void)
+lis2de_set_fifo_mode_to_trigger_mode(lis2de_dev_t *dev)
 {
-    lis2de_set(FIFO_CTRL_REG, BITMASK_76, 0b11);
+    lis2de_set(dev, FIFO_CTRL_REG, BITMASK_76, 0b11);
 }
 
 void
-lis2de_set_trigger_event_allows_to_trigger_signal_on_int1(void)
+lis2de_set_trigger_event_allows_to_trigger_signal_on_int1(lis2de_dev_t *dev)
 {
-    lis2de_set(FIFO_CTRL_REG, BITMASK_5, 0b0);
+    lis2de_set(dev, FIFO_CTRL_REG, BITMASK_5, 0b0);
 }
 
 void
-lis2de_set_trigger_event_allows_to_trigger_signal_on_int2(void)
+lis2de_set_trigger_event_allows_to_trigger_signal_on_int2(lis2de_dev_t *dev)
 {
-    lis2de_set(FIFO_CTRL_REG, BITMASK_5, 0b1);
+    lis2de_set(dev, FIFO_CTRL_REG, BITMASK_5, 0b1);
 }
 
 void
-lis2de_set_fth(uint8_t value)
+lis2de_set_fth(lis2de_dev_t *dev,
+               uint8_t value)
 {
-    lis2de_set(FIFO_CTRL_REG, BITMASK_43210, value);
+    lis2de_set(dev, FIFO_CTRL_REG, BITMASK_43210, value);
 }
 
 
 // IG1_CFG (0x30):
 void
-lis2de_set_ig1_or_combination_of_interrupt_events(void)
+lis2de_set_ig1_or_combination_of_interrupt_events(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_76, 0b00);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_76, 0b00);
 }
 
 void
-lis2de_set_ig1_and_combination_of_interrupt_events(void)
+lis2de_set_ig1_and_combination_of_interrupt_events(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_76, 0b10);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_76, 0b10);
 }
 
-void lis2de_set_ig1_6_direction_movement_recognition(void)
+void lis2de_set_ig1_6_direction_movement_recognition(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_76, 0b01);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_76, 0b01);
 }
 
 void
-lis2de_set_ig1_6_direction_position_recognition(void)
+lis2de_set_ig1_6_direction_position_recognition(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_76, 0b11);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_76, 0b11);
 }
 
 void
-lis2de_enable_ig1_interrupt_generation_on_z_high_event(void)
+lis2de_enable_ig1_interrupt_generation_on_z_high_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_5, 0b1);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_5, 0b1);
 }
 
 void
-lis2de_disable_ig1_interrupt_generation_on_z_high_event(void)
+lis2de_disable_ig1_interrupt_generation_on_z_high_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_5, 0b0);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_5, 0b0);
 }
 
 void
-lis2de_enable_ig1_interrupt_generation_on_z_low_event(void)
+lis2de_enable_ig1_interrupt_generation_on_z_low_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_4, 0b1);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_4, 0b1);
 }
 
 void
-lis2de_disable_ig1_interrupt_generation_on_z_low_event(void)
+lis2de_disable_ig1_interrupt_generation_on_z_low_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_4, 0b0);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_4, 0b0);
 }
 
 void
-lis2de_enable_ig1_interrupt_generation_on_y_high_event(void)
+lis2de_enable_ig1_interrupt_generation_on_y_high_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_3, 0b1);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_3, 0b1);
 }
 
 void
-lis2de_disable_ig1_interrupt_generation_on_y_high_event(void)
+lis2de_disable_ig1_interrupt_generation_on_y_high_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_3, 0b0);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_3, 0b0);
 }
 
 void
-lis2de_enable_ig1_interrupt_generation_on_y_low_event(void)
+lis2de_enable_ig1_interrupt_generation_on_y_low_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_2, 0b1);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_2, 0b1);
 }
 
 void
-lis2de_disable_ig1_interrupt_generation_on_y_low_event(void)
+lis2de_disable_ig1_interrupt_generation_on_y_low_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_2, 0b0);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_2, 0b0);
 }
 
 void
-lis2de_enable_ig1_interrupt_generation_on_x_high_event(void)
+lis2de_enable_ig1_interrupt_generation_on_x_high_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_1, 0b1);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_1, 0b1);
 }
 
 void
-lis2de_disable_ig1_interrupt_generation_on_x_high_event(void)
+lis2de_disable_ig1_interrupt_generation_on_x_high_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_1, 0b0);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_1, 0b0);
 }
 
 void
-lis2de_enable_ig1_interrupt_generation_on_x_low_event(void)
+lis2de_enable_ig1_interrupt_generation_on_x_low_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_0, 0b1);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_0, 0b1);
 }
 
 void
-lis2de_disable_ig1_interrupt_generation_on_x_low_event(void)
+lis2de_disable_ig1_interrupt_generation_on_x_low_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG1_CFG_REG, BITMASK_0, 0b0);
+    lis2de_set(dev, IG1_CFG_REG, BITMASK_0, 0b0);
 }
 
 // IG1_THS (0x32):
 
 void
-lis2de_set_ig1_threshold(uint8_t ths)
+lis2de_set_ig1_threshold(lis2de_dev_t *dev,
+                         uint8_t ths)
 {
-    lis2de_set(IG1_THS_REG, BITMASK_FULL, ths);
+    lis2de_set(dev, IG1_THS_REG, BITMASK_FULL, ths);
 }
 
 
 // IG1_DURATION (0x33):
 
 void
-lis2de_set_ig1_duration(uint8_t dur)
+lis2de_set_ig1_duration(lis2de_dev_t *dev,
+                        uint8_t dur)
 {
-    lis2de_set(IG1_DURATION_REG, BITMASK_FULL, dur);
+    lis2de_set(dev, IG1_DURATION_REG, BITMASK_FULL, dur);
 }
 
 // IG2_CFG (0x34):
 
 void
-lis2de_set_ig2_or_combination_of_interrupt_events(void)
+lis2de_set_ig2_or_combination_of_interrupt_events(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_76, 0b00);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_76, 0b00);
 }
 
 void
-lis2de_set_ig2_and_combination_of_interrupt_events(void)
+lis2de_set_ig2_and_combination_of_interrupt_events(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_76, 0b10);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_76, 0b10);
 }
 
-void lis2de_set_ig2_6_direction_movement_recognition(void)
+void lis2de_set_ig2_6_direction_movement_recognition(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_76, 0b01);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_76, 0b01);
 }
 
 void
-lis2de_set_ig2_6_direction_position_recognition(void)
+lis2de_set_ig2_6_direction_position_recognition(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_76, 0b11);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_76, 0b11);
 }
 
 void
-lis2de_enable_ig2_interrupt_generation_on_z_high_event(void)
+lis2de_enable_ig2_interrupt_generation_on_z_high_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_5, 0b1);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_5, 0b1);
 }
 
 void
-lis2de_disable_ig2_interrupt_generation_on_z_high_event(void)
+lis2de_disable_ig2_interrupt_generation_on_z_high_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_5, 0b0);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_5, 0b0);
 }
 
 void
-lis2de_enable_ig2_interrupt_generation_on_z_low_event(void)
+lis2de_enable_ig2_interrupt_generation_on_z_low_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_4, 0b1);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_4, 0b1);
 }
 
 void
-lis2de_disable_ig2_interrupt_generation_on_z_low_event(void)
+lis2de_disable_ig2_interrupt_generation_on_z_low_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_4, 0b0);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_4, 0b0);
 }
 
 void
-lis2de_enable_ig2_interrupt_generation_on_y_high_event(void)
+lis2de_enable_ig2_interrupt_generation_on_y_high_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_3, 0b1);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_3, 0b1);
 }
 
 void
-lis2de_disable_ig2_interrupt_generation_on_y_high_event(void)
+lis2de_disable_ig2_interrupt_generation_on_y_high_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_3, 0b0);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_3, 0b0);
 }
 
 void
-lis2de_enable_ig2_interrupt_generation_on_y_low_event(void)
+lis2de_enable_ig2_interrupt_generation_on_y_low_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_2, 0b1);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_2, 0b1);
 }
 
 void
-lis2de_disable_ig2_interrupt_generation_on_y_low_event(void)
+lis2de_disable_ig2_interrupt_generation_on_y_low_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_2, 0b0);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_2, 0b0);
 }
 
 void
-lis2de_enable_ig2_interrupt_generation_on_x_high_event(void)
+lis2de_enable_ig2_interrupt_generation_on_x_high_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_1, 0b1);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_1, 0b1);
 }
 
 void
-lis2de_disable_ig2_interrupt_generation_on_x_high_event(void)
+lis2de_disable_ig2_interrupt_generation_on_x_high_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_1, 0b0);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_1, 0b0);
 }
 
 void
-lis2de_enable_ig2_interrupt_generation_on_x_low_event(void)
+lis2de_enable_ig2_interrupt_generation_on_x_low_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_0, 0b1);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_0, 0b1);
 }
 
 void
-lis2de_disable_ig2_interrupt_generation_on_x_low_event(void)
+lis2de_disable_ig2_interrupt_generation_on_x_low_event(lis2de_dev_t *dev)
 {
-    lis2de_set(IG2_CFG_REG, BITMASK_0, 0b0);
+    lis2de_set(dev, IG2_CFG_REG, BITMASK_0, 0b0);
 }
 
 // IG2_THS (0x36):
 
 void
-lis2de_set_ig2_threshold(uint8_t ths)
+lis2de_set_ig2_threshold(lis2de_dev_t *dev,
+                         uint8_t ths)
 {
-    lis2de_set(IG2_THS_REG, BITMASK_FULL, ths);
+    lis2de_set(dev, IG2_THS_REG, BITMASK_FULL, ths);
 }
 
 
 // IG2_DURATION (0x37):
 
 void
-lis2de_set_ig2_duration(uint8_t dur)
+lis2de_set_ig2_duration(lis2de_dev_t *dev,
+                        uint8_t dur)
 {
-    lis2de_set(IG2_DURATION_REG, BITMASK_FULL, dur);
+    lis2de_set(dev, IG2_DURATION_REG, BITMASK_FULL, dur);
 }
 
 // CLICK_CFG (0x38):
 
 void
-lis2de_enable_interrupt_double_click_on_z_axis(void)
+lis2de_enable_interrupt_double_click_on_z_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CLICK_CFG_REG, BITMASK_5, 0b1);
+    lis2de_set(dev, CLICK_CFG_REG, BITMASK_5, 0b1);
 }
 
 void
-lis2de_disable_interrupt_double_click_on_z_axis(void)
+lis2de_disable_interrupt_double_click_on_z_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CLICK_CFG_REG, BITMASK_5, 0b0);
+    lis2de_set(dev, CLICK_CFG_REG, BITMASK_5, 0b0);
 }
 
 void
-lis2de_enable_interrupt_single_click_on_z_axis(void)
+lis2de_enable_interrupt_single_click_on_z_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CLICK_CFG_REG, BITMASK_4, 0b1);
+    lis2de_set(dev, CLICK_CFG_REG, BITMASK_4, 0b1);
 }
 
 void
-lis2de_disable_interrupt_single_click_on_z_axis(void)
+lis2de_disable_interrupt_single_click_on_z_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CLICK_CFG_REG, BITMASK_4, 0b0);
+    lis2de_set(dev, CLICK_CFG_REG, BITMASK_4, 0b0);
 }
 
 void
-lis2de_enable_interrupt_double_click_on_y_axis(void)
+lis2de_enable_interrupt_double_click_on_y_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CLICK_CFG_REG, BITMASK_3, 0b1);
+    lis2de_set(dev, CLICK_CFG_REG, BITMASK_3, 0b1);
 }
 
 void
-lis2de_disable_interrupt_double_click_on_y_axis(void)
+lis2de_disable_interrupt_double_click_on_y_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CLICK_CFG_REG, BITMASK_3, 0b0);
+    lis2de_set(dev, CLICK_CFG_REG, BITMASK_3, 0b0);
 }
 
 void
-lis2de_enable_interrupt_single_click_on_y_axis(void)
+lis2de_enable_interrupt_single_click_on_y_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CLICK_CFG_REG, BITMASK_2, 0b1);
+    lis2de_set(dev, CLICK_CFG_REG, BITMASK_2, 0b1);
 }
 
 void
-lis2de_disable_interrupt_single_click_on_y_axis(void)
+lis2de_disable_interrupt_single_click_on_y_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CLICK_CFG_REG, BITMASK_2, 0b0);
+    lis2de_set(dev, CLICK_CFG_REG, BITMASK_2, 0b0);
 }
 
 void
-lis2de_enable_interrupt_double_click_on_x_axis(void)
+lis2de_enable_interrupt_double_click_on_x_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CLICK_CFG_REG, BITMASK_1, 0b1);
+    lis2de_set(dev, CLICK_CFG_REG, BITMASK_1, 0b1);
 }
 
 void
-lis2de_disable_interrupt_double_click_on_x_axis(void)
+lis2de_disable_interrupt_double_click_on_x_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CLICK_CFG_REG, BITMASK_1, 0b0);
+    lis2de_set(dev, CLICK_CFG_REG, BITMASK_1, 0b0);
 }
 
 void
-lis2de_enable_interrupt_single_click_on_x_axis(void)
+lis2de_enable_interrupt_single_click_on_x_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CLICK_CFG_REG, BITMASK_0, 0b1);
+    lis2de_set(dev, CLICK_CFG_REG, BITMASK_0, 0b1);
 }
 
 void
-lis2de_disable_interrupt_single_click_on_x_axis(void)
+lis2de_disable_interrupt_single_click_on_x_axis(lis2de_dev_t *dev)
 {
-    lis2de_set(CLICK_CFG_REG, BITMASK_0, 0b1);
+    lis2de_set(dev, CLICK_CFG_REG, BITMASK_0, 0b1);
 }
 
 // CLICK_THS (0x3A):
 
 void
-lis2de_set_click_threshold(uint8_t threshold)
+lis2de_set_click_threshold(lis2de_dev_t *dev,
+                           uint8_t threshold)
 {
-    lis2de_set(CLICK_THS_REG, BITMASK_FULL, threshold);
+    lis2de_set(dev, CLICK_THS_REG, BITMASK_FULL, threshold);
 }
 
 // TIME_LIMIT (0x3B):
 
 void
-lis2de_set_time_limit(uint8_t limit)
+lis2de_set_time_limit(lis2de_dev_t *dev,
+                      uint8_t limit)
 {
-    lis2de_set(TIME_LIMIT_REG, BITMASK_FULL, limit);
+    lis2de_set(dev, TIME_LIMIT_REG, BITMASK_FULL, limit);
 }
 
 // TIME_LATENCY (0x3C):
 
 void
-lis2de_set_time_latency(uint8_t latency)
+lis2de_set_time_latency(lis2de_dev_t *dev,
+                        uint8_t latency)
 {
-    lis2de_set(TIME_LATENCY_REG, BITMASK_FULL, latency);
+    lis2de_set(dev, TIME_LATENCY_REG, BITMASK_FULL, latency);
 }
 
 // TIME_WINDOW (0x3D):
 
 void
-lis2de_set_time_window(uint8_t window)
+lis2de_set_time_window(lis2de_dev_t *dev,
+                       uint8_t window)
 {
-    lis2de_set(TIME_WINDOW_REG, BITMASK_FULL, window);
+    lis2de_set(dev, TIME_WINDOW_REG, BITMASK_FULL, window);
 }
 
 // Act_THS (0x3E):
 
 void
-lis2de_set_act_threshold(uint8_t threshold)
+lis2de_set_act_threshold(lis2de_dev_t *dev,
+                         uint8_t threshold)
 {
-    lis2de_set(ACT_THS_REG, BITMASK_FULL, threshold);
+    lis2de_set(dev, ACT_THS_REG, BITMASK_FULL, threshold);
 }
 
 // Act_DUR (0x3F):
 
 void
-lis2de_set_act_duration(uint8_t duration)
+lis2de_set_act_duration(lis2de_dev_t *dev,
+                        uint8_t duration)
 {
-    lis2de_set(ACT_DUR_REG, BITMASK_FULL, duration);
+    lis2de_set(dev, ACT_DUR_REG, BITMASK_FULL, duration);
 }
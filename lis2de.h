@@ -1,10 +1,68 @@
+#ifndef LIS2DE_H
+#define LIS2DE_H
+
 #include <stdint.h>
 
+#include "lis2de_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Error model. By default failures are raised with Throw() of
+ * CException. Build with LIS2DE_USE_CEXCEPTION=0 to have them recorded
+ * instead: the first error is kept in the device handle, every further
+ * bus transaction of that device is skipped and queries return 0 until
+ * lis2de_clear_error() is called. No setjmp frame is needed then, so
+ * the driver can be called from interrupt context and from C++. */
+#ifndef LIS2DE_USE_CEXCEPTION
+#define LIS2DE_USE_CEXCEPTION 1
+#endif
+
 // LIS2DE exception constants:
-static const uint8_t E_NOT_IN_HIGH_RES_MODE = 1;
-static const uint8_t E_LIS2DE_I2C_WRITE     = 2;
-static const uint8_t E_LIS2DE_I2C_REP_START = 3;
-static const uint8_t E_BDU_NOT_ENABLED      = 4;
+static const uint8_t E_NOT_IN_HIGH_RES_MODE  = 1;
+static const uint8_t E_LIS2DE_I2C_WRITE      = 2;
+static const uint8_t E_LIS2DE_I2C_REP_START  = 3;
+static const uint8_t E_BDU_NOT_ENABLED       = 4;
+static const uint8_t E_INVALID_REGISTER      = 5;
+static const uint8_t E_LIS2DE_I2C_IO         = 6;
+static const uint8_t E_LIS2DE_I2C_TIMEOUT    = 7;
+static const uint8_t E_LIS2DE_I2C_BUSY       = 8;
+static const uint8_t E_INVALID_RING_CAPACITY = 9;
+static const uint8_t E_LIS2DE_SHM_IO         = 10;
+static const uint8_t E_ACQ_LIMIT             = 11;
+static const uint8_t E_INVALID_PROFILE       = 12;
+static const uint8_t E_UNKNOWN_DEVICE        = 13;
+static const uint8_t E_STARTUP_TIMEOUT       = 14;
+
+// I2C device slave addresses of LIS2DE depending on the SA0 pin
+#define LIS2DE_ADDR_SA0_LOW  0x50U
+#define LIS2DE_ADDR_SA0_HIGH 0x52U
+
+// Content of WHO_AM_I (0x0F)
+#define LIS2DE_DEVICE_ID 0x33U
+
+// Time budget of a single bus transaction unless changed per device
+#ifndef LIS2DE_DEFAULT_TIMEOUT_US
+#define LIS2DE_DEFAULT_TIMEOUT_US 10000UL
+#endif
+
+// Size of the register address space
+#define LIS2DE_REGISTERS 0x40
+
+// Number of frames the hardware FIFO can hold
+#define LIS2DE_FIFO_DEPTH 32
+
+/* Frames pulled per burst by the FIFO drain, which decodes them from a
+ * stack buffer of 6 bytes per frame. Hosts drain the whole FIFO at
+ * once, AVR in bursts of 8 frames to keep 48 bytes of stack. */
+#ifndef LIS2DE_FIFO_BURST_FRAMES
+#ifdef __AVR__
+#define LIS2DE_FIFO_BURST_FRAMES 8
+#else
+#define LIS2DE_FIFO_BURST_FRAMES LIS2DE_FIFO_DEPTH
+#endif
+#endif
 
 typedef struct lis2de_data
 {
@@ -13,426 +71,686 @@ typedef struct lis2de_data
     int8_t z;
 } lis2de_data_t;
 
+/* Per-device bus traffic counters, updated on every transaction.
+ * Bus time is only measured when the bus backend provides micros().
+ * Build with LIS2DE_STATS=0 to drop them, e.g. to save RAM on AVR. */
+#ifndef LIS2DE_STATS
+#define LIS2DE_STATS 1
+#endif
+
+typedef struct lis2de_stats
+{
+    uint32_t transactions;
+    uint32_t bytes_read;
+    uint32_t bytes_written;
+    // Transactions failed with NAK or bus error
+    uint32_t errors;
+    // Transactions that ran out of time and needed a bus recovery
+    uint32_t timeouts;
+    // Samples seen with ZYXOR by lis2de_try_read_sample()
+    uint32_t overruns;
+    uint32_t bus_time_us;
+    // Transactions per start register
+    uint16_t reg_accesses[LIS2DE_REGISTERS];
+} lis2de_stats_t;
+
+// Registers TEMP_CFG_REG (0x1F) .. Act_DUR (0x3F)
+#define LIS2DE_SHADOW_SIZE (0x3F - 0x1F + 1)
+
+/* Device handle, one per sensor. Every query and set function takes
+ * the handle of the device it talks to. */
+typedef struct lis2de_dev
+{
+    const lis2de_bus_t *bus;
+    uint8_t addr;
+    uint32_t timeout_us;
+
+    // First error since lis2de_init() or lis2de_clear_error()
+    uint8_t error;
+
+    // Write-through shadow of the configuration registers
+    uint8_t shadow_enabled;
+    uint8_t shadow[LIS2DE_SHADOW_SIZE];
+    uint8_t shadow_valid[(LIS2DE_SHADOW_SIZE + 7) / 8];
 
+    // Field changes pending in an open configuration transaction
+    uint8_t batch_active;
+    uint8_t batch_value[LIS2DE_SHADOW_SIZE];
+    uint8_t batch_mask[LIS2DE_SHADOW_SIZE];
 
-/* The function lis2de_init() must be called first in
- * order to init I2C commuication */
-void lis2de_init(void);
+#if LIS2DE_STATS
+    lis2de_stats_t stats;
+#endif
+} lis2de_dev_t;
+
+/* Decoded register snapshots. Each one is taken with a single read, so
+ * all flags belong to the same instant and latched source registers
+ * are cleared only once. */
+
+// STATUS_REG2 (0x27)
+typedef struct lis2de_status
+{
+    uint8_t zyx_overrun;
+    uint8_t z_overrun;
+    uint8_t y_overrun;
+    uint8_t x_overrun;
+    uint8_t zyx_new_data;
+    uint8_t z_new_data;
+    uint8_t y_new_data;
+    uint8_t x_new_data;
+} lis2de_status_t;
+
+// FIFO_SRC_REG (0x2F)
+typedef struct lis2de_fifo_src
+{
+    uint8_t watermark_exceeded;
+    uint8_t overrun;
+    uint8_t empty;
+    uint8_t unread_samples;
+} lis2de_fifo_src_t;
+
+// STATUS_AUX (0x07), OUT_TEMP (0x0C, 0x0D)
+typedef struct lis2de_temperature
+{
+    int8_t value;
+    uint8_t new_data;
+    uint8_t overrun;
+} lis2de_temperature_t;
+
+// IG1_SOURCE (0x31), IG2_SOURCE (0x35)
+typedef struct lis2de_ig_source
+{
+    uint8_t interrupt_active;
+    uint8_t z_high;
+    uint8_t z_low;
+    uint8_t y_high;
+    uint8_t y_low;
+    uint8_t x_high;
+    uint8_t x_low;
+} lis2de_ig_source_t;
+
+// CLICK_SRC (0x39)
+typedef struct lis2de_click_src
+{
+    uint8_t interrupt_active;
+    uint8_t double_click;
+    uint8_t single_click;
+    uint8_t sign;
+    uint8_t z_click;
+    uint8_t y_click;
+    uint8_t x_click;
+} lis2de_click_src_t;
+
+
+
+/* The function lis2de_init() must be called first for every device
+ * in order to init I2C commuication over the given bus backend,
+ * e.g. lis2de_init(&dev, &lis2de_i2cmaster_bus, LIS2DE_ADDR_SA0_LOW)
+ * on AVR. Several devices may share one bus. */
+void lis2de_init(lis2de_dev_t *dev, const lis2de_bus_t *bus, uint8_t addr);
+
+/* Bound the time one transaction may take, 0 waits forever. A transfer
+ * running out of time fails with E_LIS2DE_I2C_TIMEOUT after the bus has
+ * been recovered, so a dead sensor cannot stall the other devices. */
+void lis2de_set_bus_timeout(lis2de_dev_t *dev, uint32_t timeout_us);
+
+/* First E_* error of the device, 0 if none. With LIS2DE_USE_CEXCEPTION=0
+ * this is how failures are reported; clearing it resumes bus traffic.
+ * Buffers filled by calls made after the error hold no valid data. */
+uint8_t lis2de_query_error(lis2de_dev_t *dev);
+void lis2de_clear_error(lis2de_dev_t *dev);
+
+// Time of the bus backend in microseconds, 0 if it has no clock
+uint32_t lis2de_query_micros(lis2de_dev_t *dev);
+
+// Snapshot and reset of the bus traffic counters of a device
+void lis2de_query_stats(lis2de_dev_t *dev, lis2de_stats_t *stats);
+void lis2de_reset_stats(lis2de_dev_t *dev);
 
 /* Query single accel data set for all three axes when in
- * bypass mode using the function lis2de_query_accel_data() */
-lis2de_data_t lis2de_query_accel_data(void);
+ * bypass mode using the function lis2de_query_accel_data().
+ * All three axes are fetched in a single I2C transaction. */
+lis2de_data_t lis2de_query_accel_data(lis2de_dev_t *dev);
+
+/* Data-ready gated fetch for polling: STATUS_REG2 and the outputs
+ * (0x27..0x2D) come in one burst. Returns 1 and fills sample when ZYXDA
+ * was set, 0 when no new sample was ready yet. status, if not NULL,
+ * receives the decoded STATUS_REG2 either way; samples lost to ZYXOR
+ * are counted in the overruns of the stats. */
+uint8_t lis2de_try_read_sample(lis2de_dev_t *dev, lis2de_data_t *sample, lis2de_status_t *status);
+
+/* Drain up to max unread frames from the FIFO into buf using a single
+ * burst read, or one per LIS2DE_FIFO_BURST_FRAMES frames. Returns the
+ * number of frames stored in buf. FIFO must be enabled and not in
+ * bypass mode. */
+uint8_t lis2de_read_fifo(lis2de_dev_t *dev, lis2de_data_t *buf, uint8_t max);
+
+/* Same as lis2de_read_fifo() for a destination split in two, e.g. the
+ * free space of a ring buffer that wraps around. head is filled first,
+ * still within the same burst read. */
+uint8_t lis2de_read_fifo_split(lis2de_dev_t *dev,
+                               lis2de_data_t *head, uint8_t head_max,
+                               lis2de_data_t *tail, uint8_t tail_max);
+
+/* Optional write-through shadow of the writable configuration
+ * registers (TEMP_CFG_REG, CTRL_REG1..6, FIFO_CTRL_REG, IG1/IG2, CLICK
+ * and Act). When enabled, setters skip the read of the read-modify-write
+ * cycle and config queries are answered from RAM once a register has
+ * been seen. lis2de_reboot_memory_content() invalidates the shadow;
+ * call lis2de_shadow_registers_invalidate() after any other reset of
+ * the device and lis2de_shadow_registers_resync() to reload it. */
+void lis2de_enable_shadow_registers(lis2de_dev_t *dev);
+void lis2de_disable_shadow_registers(lis2de_dev_t *dev);
+void lis2de_shadow_registers_invalidate(lis2de_dev_t *dev);
+void lis2de_shadow_registers_resync(lis2de_dev_t *dev);
+
+/* Configuration transaction: setter calls made between begin and commit
+ * only record the field changes. Commit merges them per register and
+ * writes each run of consecutive modified registers (e.g. CTRL_REG1..6)
+ * with a single multi-byte write. Queries issued in between already see
+ * the pending values. Discard drops everything recorded since begin,
+ * and so does lis2de_reboot_memory_content(). */
+void lis2de_begin_configuration(lis2de_dev_t *dev);
+void lis2de_commit_configuration(lis2de_dev_t *dev);
+void lis2de_discard_configuration(lis2de_dev_t *dev);
+
+/* Write len consecutive registers starting at reg with one
+ * auto-increment transaction per run of writable registers, e.g.
+ * IG1_THS..IG2_CFG (0x32..0x34) in one. Bytes at read-only source
+ * registers inside the block (IG1_SOURCE, IG2_SOURCE, CLICK_SRC,
+ * FIFO_SRC_REG) are not written; the transfer is split there instead.
+ * Fails with E_INVALID_REGISTER for any other non-writable register. */
+void lis2de_write_registers(lis2de_dev_t *dev, uint8_t reg, const uint8_t *val, uint8_t len);
+
+/* Read len consecutive registers starting at reg in a single
+ * auto-increment transaction, bypassing an open configuration batch.
+ * Every register is read like by its query: output registers pop a
+ * FIFO frame in FIFO mode and source registers clear their latch.
+ * With the FIFO enabled the pointer wraps at OUT_Z_H (0x2D), so a
+ * range past it takes a second transaction from FIFO_CTRL_REG on.
+ * Fails with E_INVALID_REGISTER past the end of the map. */
+void lis2de_read_registers(lis2de_dev_t *dev, uint8_t reg, uint8_t *val, uint8_t len);
+
+/* Bring the writable registers TEMP_CFG_REG..Act_DUR to the values of
+ * image (LIS2DE_SHADOW_SIZE bytes from 0x1F, see lis2de_profile.h) as
+ * a diff against the shadow: only the span of registers that change is
+ * written, with one transaction per run of writable registers between
+ * the read-only STATUS_REG2..OUT_Z, FIFO_SRC_REG, IG1_SOURCE,
+ * IG2_SOURCE and CLICK_SRC. Registers the shadow does not know count
+ * as changed, so enable the shadow to make profile switches cheap.
+ * REFERENCE, which cannot be read back, counts as changed only if the
+ * image selects the reference mode of the high-pass filter. BOOT must
+ * be clear. Inside an open configuration batch the changes are
+ * recorded for its commit. */
+void lis2de_apply_register_image(lis2de_dev_t *dev, const uint8_t *image);
+
+/* Write every writable register of image back with one transaction per
+ * run, whatever the shadow holds, e.g. a snapshot after the device lost
+ * its state. BOOT is never written. Inside an open configuration batch
+ * the values are recorded for its commit. */
+void lis2de_restore_register_image(lis2de_dev_t *dev, const uint8_t *image);
+
+/* Raw register access for typed front ends such as lis2de.hpp. Both go
+ * through the shadow and an open configuration batch like the query
+ * and set functions. lis2de_modify_register() replaces the bits of mask
+ * with those of bits in one read-modify-write, or a plain write when
+ * mask covers the whole register. Fails with E_INVALID_REGISTER for
+ * addresses outside the map or registers that are not writable. */
+uint8_t lis2de_query_register(lis2de_dev_t *dev, uint8_t adr);
+void lis2de_modify_register(lis2de_dev_t *dev, uint8_t adr, uint8_t mask, uint8_t bits);
 
 
 
 // STATUS_AUX (0x07)
-uint8_t lis2de_query_temperature_data_overrun(void);
-uint8_t lis2de_query_temperature_new_data_available(void);
+uint8_t lis2de_query_temperature_data_overrun(lis2de_dev_t *dev);
+uint8_t lis2de_query_temperature_new_data_available(lis2de_dev_t *dev);
 
 // OUT_TEMP (0x0C, 0x0D)
-int8_t lis2de_query_temperature(void);
+int8_t lis2de_query_temperature(lis2de_dev_t *dev);
+
+/* Temperature sample together with its flags of STATUS_AUX, read in a
+ * single burst over 0x07..0x0D. Reading OUT_TEMP_H clears new_data, so
+ * a low-rate caller interleaving it with the accel stream sees each
+ * sample once and overrun when it fell behind. Needs BDU enabled. */
+lis2de_temperature_t lis2de_query_temperature_data(lis2de_dev_t *dev);
 
 // INT_COUNTER (0x0E)
-uint8_t lis2de_query_int_counter(void);
+uint8_t lis2de_query_int_counter(lis2de_dev_t *dev);
 
 // WHO_AM_I (0x0F)
-uint8_t lis2de_query_device_id(void);
+uint8_t lis2de_query_device_id(lis2de_dev_t *dev);
 
 // TEMP_CFG_REG (0x1F)
-uint8_t lis2de_query_temperature_sensor_enabled(void);
+uint8_t lis2de_query_temperature_sensor_enabled(lis2de_dev_t *dev);
 
 // CTRL_REG1 (0x20)
-uint8_t lis2de_query_data_rate_selection(void);
-uint8_t lis2de_query_low_power_mode_enabled(void);
-uint8_t lis2de_query_z_axis_enabled(void);
-uint8_t lis2de_query_y_axis_enabled(void);
-uint8_t lis2de_query_x_axis_enabled(void);
+uint8_t lis2de_query_data_rate_selection(lis2de_dev_t *dev);
+uint16_t lis2de_data_rate_in_hz(uint8_t odr, uint8_t low_power);
+uint8_t lis2de_query_low_power_mode_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_z_axis_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_y_axis_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_x_axis_enabled(lis2de_dev_t *dev);
 
 // CTRL_REG2 (0x21)
-uint8_t lis2de_query_high_pass_filter_mode_selection(void);
-uint8_t lis2de_query_high_pass_filter_in_normal_mode(void);
-uint8_t lis2de_query_high_pass_filter_in_reference_mode(void);
-uint8_t lis2de_query_high_pass_filter_in_auto_reset_mode(void);
+uint8_t lis2de_query_high_pass_filter_mode_selection(lis2de_dev_t *dev);
+uint8_t lis2de_query_high_pass_filter_in_normal_mode(lis2de_dev_t *dev);
+uint8_t lis2de_query_high_pass_filter_in_reference_mode(lis2de_dev_t *dev);
+uint8_t lis2de_query_high_pass_filter_in_auto_reset_mode(lis2de_dev_t *dev);
 
-uint8_t lis2de_query_high_pass_filter_cutoff_frequency_selection(void);
+uint8_t lis2de_query_high_pass_filter_cutoff_frequency_selection(lis2de_dev_t *dev);
 
-uint8_t lis2de_query_internal_filter_bypassed(void);
+uint8_t lis2de_query_internal_filter_bypassed(lis2de_dev_t *dev);
 
-uint8_t lis2de_query_high_pass_filter_for_click_function_enabled(void);
-uint8_t lis2de_query_high_pass_filter_for_ig1_enabled(void);
-uint8_t lis2de_query_high_pass_filter_for_ig2_enabled(void);
+uint8_t lis2de_query_high_pass_filter_for_click_function_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_high_pass_filter_for_ig1_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_high_pass_filter_for_ig2_enabled(lis2de_dev_t *dev);
 
 // CTRL_REG3 (0x22)
-uint8_t lis2de_query_click_interrupt_on_int1_enabled(void);
-uint8_t lis2de_query_ig1_on_int1_enabled(void);
-uint8_t lis2de_query_ig2_on_int1_enabled(void);
-uint8_t lis2de_query_drdy1_interrupt_on_int1_enabled(void);
-uint8_t lis2de_query_drdy2_interrupt_on_int1_enabled(void);
-uint8_t lis2de_query_fifo_watermark_interrupt_on_int1_enabled(void);
-uint8_t lis2de_query_fifo_overrun_interrupt_on_int1_enabled(void);
+uint8_t lis2de_query_click_interrupt_on_int1_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_on_int1_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_on_int1_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_drdy1_interrupt_on_int1_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_drdy2_interrupt_on_int1_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_fifo_watermark_interrupt_on_int1_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_fifo_overrun_interrupt_on_int1_enabled(lis2de_dev_t *dev);
 
 // CTRL_REG4 (0x23)
-uint8_t lis2de_query_block_data_update_enabled(void);
-uint8_t lis2de_query_full_scale_selection(void);
-uint8_t lis2de_query_self_test_enabled(void);
-uint8_t lis2de_query_spi_mode_selection(void);
+uint8_t lis2de_query_block_data_update_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_full_scale_selection(lis2de_dev_t *dev);
+uint8_t lis2de_query_self_test_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_spi_mode_selection(lis2de_dev_t *dev);
 
 // CTRL_REG5 (0x24)
-uint8_t lis2de_query_reboot_memory_content(void);
-uint8_t lis2de_query_fifo_enabled(void);
-uint8_t lis2de_query_latch_interruot_request_on_ig1_source_reg(void);
-uint8_t lis2de_query_int1_4d_detection_enabled(void);
-uint8_t lis2de_query_latch_interruot_request_on_ig2_source_reg(void);
-uint8_t lis2de_query_int2_4d_detection_enabled(void);
+uint8_t lis2de_query_reboot_memory_content(lis2de_dev_t *dev);
+// BOOT read from the bus, past the shadow and an open batch
+uint8_t lis2de_query_boot_in_progress(lis2de_dev_t *dev);
+uint8_t lis2de_query_fifo_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_latch_interruot_request_on_ig1_source_reg(lis2de_dev_t *dev);
+uint8_t lis2de_query_int1_4d_detection_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_latch_interruot_request_on_ig2_source_reg(lis2de_dev_t *dev);
+uint8_t lis2de_query_int2_4d_detection_enabled(lis2de_dev_t *dev);
 
 // CTRL_REG6 (0x25)
-uint8_t lis2de_query_click_interrupt_on_int2_pin_enabled(void);
-uint8_t lis2de_query_ig1_on_int2_pin_enabled(void);
-uint8_t lis2de_query_ig2_on_int2_pin_enabled(void);
-uint8_t lis2de_query_boot_on_int2_pin_enabled(void);
-uint8_t lis2de_query_sleep_to_wake_function_interrupt_on_int2_pin_enabled(void);
-uint8_t lis2de_query_interrupt_active_value(void);
+uint8_t lis2de_query_click_interrupt_on_int2_pin_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_on_int2_pin_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_on_int2_pin_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_boot_on_int2_pin_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_sleep_to_wake_function_interrupt_on_int2_pin_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_interrupt_active_value(lis2de_dev_t *dev);
 
 // REFERENCE/DATACAPTURE (0x26)
-uint8_t lis2de_query_reference(void);
+uint8_t lis2de_query_reference(lis2de_dev_t *dev);
 
 // STATUS_REG2 (0x27)
-uint8_t lis2de_query_data_overrun_on_xyz_axes(void);
-uint8_t lis2de_query_data_overrun_on_z_axis(void);
-uint8_t lis2de_query_data_overrun_on_y_axis(void);
-uint8_t lis2de_query_data_overrun_on_x_axis(void);
-uint8_t lis2de_query_new_data_available_on_xyz_axes(void);
-uint8_t lis2de_query_new_data_available_on_z_axis(void);
-uint8_t lis2de_query_new_data_available_on_y_axis(void);
-uint8_t lis2de_query_new_data_available_on_x_axis(void);
+uint8_t lis2de_query_data_overrun_on_xyz_axes(lis2de_dev_t *dev);
+uint8_t lis2de_query_data_overrun_on_z_axis(lis2de_dev_t *dev);
+uint8_t lis2de_query_data_overrun_on_y_axis(lis2de_dev_t *dev);
+uint8_t lis2de_query_data_overrun_on_x_axis(lis2de_dev_t *dev);
+uint8_t lis2de_query_new_data_available_on_xyz_axes(lis2de_dev_t *dev);
+uint8_t lis2de_query_new_data_available_on_z_axis(lis2de_dev_t *dev);
+uint8_t lis2de_query_new_data_available_on_y_axis(lis2de_dev_t *dev);
+uint8_t lis2de_query_new_data_available_on_x_axis(lis2de_dev_t *dev);
+lis2de_status_t lis2de_query_status(lis2de_dev_t *dev);
 
 // FIFO_CTRL_REG (0x2E)
-uint8_t lis2de_query_fifo_mode_selection(void);
-uint8_t lis2de_query_in_bypass_mode(void);
-uint8_t lis2de_query_in_fifo_mode(void);
-uint8_t lis2de_query_in_stream_mode(void);
-uint8_t lis2de_query_in_trigger_mode(void);
-uint8_t lis2de_query_trigger_selection(void);
-uint8_t lis2de_query_fth(void);
+uint8_t lis2de_query_fifo_mode_selection(lis2de_dev_t *dev);
+uint8_t lis2de_query_in_bypass_mode(lis2de_dev_t *dev);
+uint8_t lis2de_query_in_fifo_mode(lis2de_dev_t *dev);
+uint8_t lis2de_query_in_stream_mode(lis2de_dev_t *dev);
+uint8_t lis2de_query_in_trigger_mode(lis2de_dev_t *dev);
+uint8_t lis2de_query_trigger_selection(lis2de_dev_t *dev);
+uint8_t lis2de_query_fth(lis2de_dev_t *dev);
 
 // FIFO_SRC_REG (0x2F)
-uint8_t lis2de_query_fifo_watermark_level_exceeded(void);
-uint8_t lis2de_query_fifo_overrun(void);
-uint8_t lis2de_query_fifo_empty(void);
-uint8_t lis2de_query_fifo_current_number_of_unread_samples(void);
+uint8_t lis2de_query_fifo_watermark_level_exceeded(lis2de_dev_t *dev);
+uint8_t lis2de_query_fifo_overrun(lis2de_dev_t *dev);
+uint8_t lis2de_query_fifo_empty(lis2de_dev_t *dev);
+uint8_t lis2de_query_fifo_current_number_of_unread_samples(lis2de_dev_t *dev);
+lis2de_fifo_src_t lis2de_query_fifo_src(lis2de_dev_t *dev);
+
+// Frames held by the FIFO according to a FIFO_SRC_REG snapshot
+uint8_t lis2de_fifo_src_frames(const lis2de_fifo_src_t *src);
+
+/* Burst part of lis2de_read_fifo_split() for a FIFO_SRC_REG snapshot
+ * the caller already took, e.g. to timestamp it. */
+uint8_t lis2de_read_fifo_frames(lis2de_dev_t *dev,
+                                const lis2de_fifo_src_t *src,
+                                lis2de_data_t *head, uint8_t head_max,
+                                lis2de_data_t *tail, uint8_t tail_max);
+
+/* Same for records holding a lis2de_data_t: frame n is decoded into
+ * the lis2de_data_t n * stride bytes after first, e.g.
+ * &buf[0].data with stride sizeof(buf[0]), without a frame buffer. */
+uint8_t lis2de_read_fifo_frames_into(lis2de_dev_t *dev,
+                                     const lis2de_fifo_src_t *src,
+                                     lis2de_data_t *first, uint8_t max,
+                                     uint8_t stride);
 
 // IG1_CFG (0x30)
-uint8_t lis2de_query_ig1_or_combination_of_interrupt_events_enabled(void);
-uint8_t lis2de_query_ig1_and_combination_of_interrupt_events_enabled(void);
-uint8_t lis2de_query_ig1_6_direction_movement_recognition_enabled(void);
-uint8_t lis2de_query_ig1_6_direction_position_recognition_enabled(void);
-uint8_t lis2de_query_ig1_ig_on_z_high_event_or_dir_recognition_enabled(void);
-uint8_t lis2de_query_ig1_ig_on_z_low_event_or_dir_recognition_enabled(void);
-uint8_t lis2de_query_ig1_ig_on_y_high_event_or_dir_recognition_enabled(void);
-uint8_t lis2de_query_ig1_ig_on_y_low_event_or_dir_recognition_enabled(void);
-uint8_t lis2de_query_ig1_ig_on_x_high_event_or_dir_recognition_enabled(void);
-uint8_t lis2de_query_ig1_ig_on_x_low_event_or_dir_recognition_enabled(void);
+uint8_t lis2de_query_ig1_or_combination_of_interrupt_events_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_and_combination_of_interrupt_events_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_6_direction_movement_recognition_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_6_direction_position_recognition_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_ig_on_z_high_event_or_dir_recognition_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_ig_on_z_low_event_or_dir_recognition_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_ig_on_y_high_event_or_dir_recognition_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_ig_on_y_low_event_or_dir_recognition_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_ig_on_x_high_event_or_dir_recognition_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_ig_on_x_low_event_or_dir_recognition_enabled(lis2de_dev_t *dev);
 
 // IG1_SOURCE (0x31)
-uint8_t lis2de_query_ig1_interrupt_has_been_generated(void);
-uint8_t lis2de_query_ig1_z_high_event_has_occured(void);
-uint8_t lis2de_query_ig1_z_low_event_has_occured(void);
-uint8_t lis2de_query_ig1_y_high_event_has_occured(void);
-uint8_t lis2de_query_ig1_y_low_event_has_occured(void);
-uint8_t lis2de_query_ig1_x_high_event_has_occured(void);
-uint8_t lis2de_query_ig1_x_low_event_has_occured(void);
+uint8_t lis2de_query_ig1_interrupt_has_been_generated(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_z_high_event_has_occured(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_z_low_event_has_occured(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_y_high_event_has_occured(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_y_low_event_has_occured(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_x_high_event_has_occured(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig1_x_low_event_has_occured(lis2de_dev_t *dev);
+lis2de_ig_source_t lis2de_query_ig1_source(lis2de_dev_t *dev);
 
 // IG1_THS (0x32)
-uint8_t lis2de_query_ig1_threshold(void);
+uint8_t lis2de_query_ig1_threshold(lis2de_dev_t *dev);
 
 // IG1_DURATION (0x33)
-uint8_t lis2de_query_ig1_duration(void);
+uint8_t lis2de_query_ig1_duration(lis2de_dev_t *dev);
 
 // IG2_CFG (0x34)
-uint8_t lis2de_query_ig2_or_combination_of_interrupt_events_enabled(void);
-uint8_t lis2de_query_ig2_and_combination_of_interrupt_events_enabled(void);
-uint8_t lis2de_query_ig2_6_direction_movement_recognition_enabled(void);
-uint8_t lis2de_query_ig2_6_direction_position_recognition_enabled(void);
-uint8_t lis2de_query_ig2_ig_on_z_high_event_or_dir_recognition_enabled(void);
-uint8_t lis2de_query_ig2_ig_on_z_low_event_or_dir_recognition_enabled(void);
-uint8_t lis2de_query_ig2_ig_on_y_high_event_or_dir_recognition_enabled(void);
-uint8_t lis2de_query_ig2_ig_on_y_low_event_or_dir_recognition_enabled(void);
-uint8_t lis2de_query_ig2_ig_on_x_high_event_or_dir_recognition_enabled(void);
-uint8_t lis2de_query_ig2_ig_on_x_low_event_or_dir_recognition_enabled(void);
+uint8_t lis2de_query_ig2_or_combination_of_interrupt_events_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_and_combination_of_interrupt_events_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_6_direction_movement_recognition_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_6_direction_position_recognition_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_ig_on_z_high_event_or_dir_recognition_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_ig_on_z_low_event_or_dir_recognition_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_ig_on_y_high_event_or_dir_recognition_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_ig_on_y_low_event_or_dir_recognition_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_ig_on_x_high_event_or_dir_recognition_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_ig_on_x_low_event_or_dir_recognition_enabled(lis2de_dev_t *dev);
 
 // IG2_SOURCE (0x35)
-uint8_t lis2de_query_ig2_interrupt_has_been_generated(void);
-uint8_t lis2de_query_ig2_z_high_event_has_occured(void);
-uint8_t lis2de_query_ig2_z_low_event_has_occured(void);
-uint8_t lis2de_query_ig2_y_high_event_has_occured(void);
-uint8_t lis2de_query_ig2_y_low_event_has_occured(void);
-uint8_t lis2de_query_ig2_x_high_event_has_occured(void);
-uint8_t lis2de_query_ig2_x_low_event_has_occured(void);
+uint8_t lis2de_query_ig2_interrupt_has_been_generated(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_z_high_event_has_occured(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_z_low_event_has_occured(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_y_high_event_has_occured(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_y_low_event_has_occured(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_x_high_event_has_occured(lis2de_dev_t *dev);
+uint8_t lis2de_query_ig2_x_low_event_has_occured(lis2de_dev_t *dev);
+lis2de_ig_source_t lis2de_query_ig2_source(lis2de_dev_t *dev);
 
 // IG2_THS (0x36)
-uint8_t lis2de_query_ig2_threshold(void);
+uint8_t lis2de_query_ig2_threshold(lis2de_dev_t *dev);
 
 // IG2_DURATION (0x37)
-uint8_t lis2de_query_ig2_duration(void);
+uint8_t lis2de_query_ig2_duration(lis2de_dev_t *dev);
 
 // CLICK_CFG (0x38)
-uint8_t lis2de_query_interrupt_double_click_on_z_axis_enabled(void);
-uint8_t lis2de_query_interrupt_single_click_on_z_axis_enabled(void);
-uint8_t lis2de_query_interrupt_double_click_on_y_axis_enabled(void);
-uint8_t lis2de_query_interrupt_single_click_on_y_axis_enabled(void);
-uint8_t lis2de_query_interrupt_double_click_on_x_axis_enabled(void);
-uint8_t lis2de_query_interrupt_single_click_on_x_axis_enabled(void);
+uint8_t lis2de_query_interrupt_double_click_on_z_axis_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_interrupt_single_click_on_z_axis_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_interrupt_double_click_on_y_axis_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_interrupt_single_click_on_y_axis_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_interrupt_double_click_on_x_axis_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_interrupt_single_click_on_x_axis_enabled(lis2de_dev_t *dev);
 
 // CLICK_SRC (0x39)
-uint8_t lis2de_query_interrupts_have_been_generated(void);
-uint8_t lis2de_query_double_click_enabled(void);
-uint8_t lis2de_query_single_click_enabled(void);
-uint8_t lis2de_query_click_sign(void);
-uint8_t lis2de_query_z_click_high_event_has_occured(void);
-uint8_t lis2de_query_y_click_high_event_has_occured(void);
-uint8_t lis2de_query_x_click_high_event_has_occured(void);
+uint8_t lis2de_query_interrupts_have_been_generated(lis2de_dev_t *dev);
+uint8_t lis2de_query_double_click_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_single_click_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_click_sign(lis2de_dev_t *dev);
+uint8_t lis2de_query_z_click_high_event_has_occured(lis2de_dev_t *dev);
+uint8_t lis2de_query_y_click_high_event_has_occured(lis2de_dev_t *dev);
+uint8_t lis2de_query_x_click_high_event_has_occured(lis2de_dev_t *dev);
+lis2de_click_src_t lis2de_query_click_src(lis2de_dev_t *dev);
 
 // CLICK_THS (0x3A)
-uint8_t lis2de_query_latch_interrupt_request_on_click_src_reg_enabled(void);
-uint8_t lis2de_query_click_threshold(void);
+uint8_t lis2de_query_latch_interrupt_request_on_click_src_reg_enabled(lis2de_dev_t *dev);
+uint8_t lis2de_query_click_threshold(lis2de_dev_t *dev);
 
 // TIME_LIMIT (0x3B)
-uint8_t lis2de_query_time_limit(void);
+uint8_t lis2de_query_time_limit(lis2de_dev_t *dev);
 
 // TIME_LATENCY (0x3C)
-uint8_t lis2de_query_time_latency(void);
+uint8_t lis2de_query_time_latency(lis2de_dev_t *dev);
 
 // TIME_WINDOW (0x3D)
-uint8_t lis2de_query_time_window(void);
+uint8_t lis2de_query_time_window(lis2de_dev_t *dev);
 
 // Act_THS (0x3E)
-uint8_t lis2de_query_act_threshold(void);
+uint8_t lis2de_query_act_threshold(lis2de_dev_t *dev);
 
 // Act_DUR (0x3F)
-uint8_t lis2de_query_act_duration(void);
+uint8_t lis2de_query_act_duration(lis2de_dev_t *dev);
+
+uint8_t lis2de_query_current_operating_mode_is_normal_mode(lis2de_dev_t *dev);
+uint8_t lis2de_query_current_operating_mode_is_low_power_mode(lis2de_dev_t *dev);
 
 
 // Set functions for all writable registers:
 
-void lis2de_set_operating_mode_to_normal_mode(void);
-void lis2de_set_operating_mode_to_low_power_mode(void);
+void lis2de_set_operating_mode_to_normal_mode(lis2de_dev_t *dev);
+void lis2de_set_operating_mode_to_low_power_mode(lis2de_dev_t *dev);
+void lis2de_set_operating_mode_to_high_resolution_mode(lis2de_dev_t *dev);
 
 // TEMP_CFG_REG (0x1F)
-void lis2de_enable_temperature_sensor(void);
-void lis2de_disable_temperature_sensor(void);
+void lis2de_enable_temperature_sensor(lis2de_dev_t *dev);
+void lis2de_disable_temperature_sensor(lis2de_dev_t *dev);
 
 // CTRL_REG1 (0x20)
-void lis2de_set_power_down_mode(void);
+void lis2de_set_power_down_mode(lis2de_dev_t *dev);
 // Data rates in Normal / Low-power mode:
-void lis2de_set_data_rate_to_1hz(void);
-void lis2de_set_data_rate_to_10hz(void);
-void lis2de_set_data_rate_to_25hz(void);
-void lis2de_set_data_rate_to_50hz(void);
-void lis2de_set_data_rate_to_100hz(void);
-void lis2de_set_data_rate_to_200hz(void);
-void lis2de_set_data_rate_to_400hz(void);
+void lis2de_set_data_rate_to_1hz(lis2de_dev_t *dev);
+void lis2de_set_data_rate_to_10hz(lis2de_dev_t *dev);
+void lis2de_set_data_rate_to_25hz(lis2de_dev_t *dev);
+void lis2de_set_data_rate_to_50hz(lis2de_dev_t *dev);
+void lis2de_set_data_rate_to_100hz(lis2de_dev_t *dev);
+void lis2de_set_data_rate_to_200hz(lis2de_dev_t *dev);
+void lis2de_set_data_rate_to_400hz(lis2de_dev_t *dev);
 // Data rate in Low-power mode, 1.6 kHz:
-void lis2de_set_low_power_mode(void);
+void lis2de_set_low_power_mode(lis2de_dev_t *dev);
 // HR/normal (1.344 kHz); Low power mode (5.376 kHz):
-void lis2de_set_data_rate_to_max(void);
+void lis2de_set_data_rate_to_max(lis2de_dev_t *dev);
 
-void lis2de_enable_z_axis(void);
-void lis2de_enable_y_axis(void);
-void lis2de_enable_x_axis(void);
-void lis2de_disable_z_axis(void);
-void lis2de_disable_y_axis(void);
-void lis2de_disable_x_axis(void);
+void lis2de_enable_z_axis(lis2de_dev_t *dev);
+void lis2de_enable_y_axis(lis2de_dev_t *dev);
+void lis2de_enable_x_axis(lis2de_dev_t *dev);
+void lis2de_disable_z_axis(lis2de_dev_t *dev);
+void lis2de_disable_y_axis(lis2de_dev_t *dev);
+void lis2de_disable_x_axis(lis2de_dev_t *dev);
 
 // CTRL_REG2 (0x21)
-void lis2de_set_high_pass_filter_to_normal_mode(void);
-void lis2de_set_high_pass_filter_to_reference_mode(void);
-void lis2de_set_high_pass_filter_to_autoreset_mode(void);
+void lis2de_set_high_pass_filter_to_normal_mode(lis2de_dev_t *dev);
+void lis2de_set_high_pass_filter_to_reference_mode(lis2de_dev_t *dev);
+void lis2de_set_high_pass_filter_to_autoreset_mode(lis2de_dev_t *dev);
 
-void lis2de_set_high_pass_filter_cut_off_freq_to_8(void);
-void lis2de_set_high_pass_filter_cut_off_freq_to_16(void);
-void lis2de_set_high_pass_filter_cut_off_freq_to_32(void);
-void lis2de_set_high_pass_filter_cut_off_freq_to_64(void);
-void lis2de_enable_internal_filter_bypass(void);
-void lis2de_disable_internal_filter_bypass(void);
+void lis2de_set_high_pass_filter_cut_off_freq_to_8(lis2de_dev_t *dev);
+void lis2de_set_high_pass_filter_cut_off_freq_to_16(lis2de_dev_t *dev);
+void lis2de_set_high_pass_filter_cut_off_freq_to_32(lis2de_dev_t *dev);
+void lis2de_set_high_pass_filter_cut_off_freq_to_64(lis2de_dev_t *dev);
+void lis2de_enable_internal_filter_bypass(lis2de_dev_t *dev);
+void lis2de_disable_internal_filter_bypass(lis2de_dev_t *dev);
 
-void lis2de_enable_high_pass_filter_for_click_function(void);
-void lis2de_disable_high_pass_filter_for_click_function(void);
+void lis2de_enable_high_pass_filter_for_click_function(lis2de_dev_t *dev);
+void lis2de_disable_high_pass_filter_for_click_function(lis2de_dev_t *dev);
 
-void lis2de_enable_high_pass_filter_for_aoi_function_on_int1(void);
-void lis2de_disable_high_pass_filter_for_aoi_function_on_int1(void);
+void lis2de_enable_high_pass_filter_for_aoi_function_on_int1(lis2de_dev_t *dev);
+void lis2de_disable_high_pass_filter_for_aoi_function_on_int1(lis2de_dev_t *dev);
 
-void lis2de_enable_high_pass_filter_for_aoi_function_on_int2(void);
-void lis2de_disable_high_pass_filter_for_aoi_function_on_int2(void);
+void lis2de_enable_high_pass_filter_for_aoi_function_on_int2(lis2de_dev_t *dev);
+void lis2de_disable_high_pass_filter_for_aoi_function_on_int2(lis2de_dev_t *dev);
 
 // CTRL_REG3 (0x22)
-void lis2de_enable_click_interrupt_on_int1(void);
-void lis2de_disable_click_interrupt_on_int1(void);
+void lis2de_enable_click_interrupt_on_int1(lis2de_dev_t *dev);
+void lis2de_disable_click_interrupt_on_int1(lis2de_dev_t *dev);
 
-void lis2de_enable_aoi_interrupt_on_int1(void);
-void lis2de_disable_aoi_interrupt_on_int1(void);
+void lis2de_enable_aoi_interrupt_on_int1(lis2de_dev_t *dev);
+void lis2de_disable_aoi_interrupt_on_int1(lis2de_dev_t *dev);
 
-void lis2de_enable_aoi_interrupt_on_int2(void);
-void lis2de_disable_aoi_interrupt_on_int2(void);
+void lis2de_enable_aoi_interrupt_on_int2(lis2de_dev_t *dev);
+void lis2de_disable_aoi_interrupt_on_int2(lis2de_dev_t *dev);
 
-void lis2de_enable_drdy1_interrupt_on_int1(void);
-void lis2de_disable_drdy1_interrupt_on_int1(void);
+void lis2de_enable_drdy1_interrupt_on_int1(lis2de_dev_t *dev);
+void lis2de_disable_drdy1_interrupt_on_int1(lis2de_dev_t *dev);
 
-void lis2de_enable_drdy2_interrupt_on_int1(void);
-void lis2de_disable_drdy2_interrupt_on_int1(void);
+void lis2de_enable_drdy2_interrupt_on_int1(lis2de_dev_t *dev);
+void lis2de_disable_drdy2_interrupt_on_int1(lis2de_dev_t *dev);
 
-void lis2de_enable_fifo_watermark_interrupt_on_int1(void);
-void lis2de_disable_fifo_watermark_interrupt_on_int1(void);
+void lis2de_enable_fifo_watermark_interrupt_on_int1(lis2de_dev_t *dev);
+void lis2de_disable_fifo_watermark_interrupt_on_int1(lis2de_dev_t *dev);
 
-void lis2de_enable_fifo_overrun_interrupt_on_int1(void);
-void lis2de_disable_fifo_overrun_interrupt_on_int1(void);
+void lis2de_enable_fifo_overrun_interrupt_on_int1(lis2de_dev_t *dev);
+void lis2de_disable_fifo_overrun_interrupt_on_int1(lis2de_dev_t *dev);
 
 // CTRL_REG4 (0x23)
-void lis2de_enable_continuos_block_data_update(void);
-void lis2de_disable_continuos_block_data_update(void);
+void lis2de_enable_continuos_block_data_update(lis2de_dev_t *dev);
+void lis2de_disable_continuos_block_data_update(lis2de_dev_t *dev);
 
-void lis2de_set_full_scale_to_2g(void);
-void lis2de_set_full_scale_to_4g(void);
-void lis2de_set_full_scale_to_8g(void);
-void lis2de_set_full_scale_to_16g(void);
+void lis2de_set_full_scale_to_2g(lis2de_dev_t *dev);
+void lis2de_set_full_scale_to_4g(lis2de_dev_t *dev);
+void lis2de_set_full_scale_to_8g(lis2de_dev_t *dev);
+void lis2de_set_full_scale_to_16g(lis2de_dev_t *dev);
 
-void lis2de_enable_self_test_mode(void);
-void lis2de_disable_self_test_mode(void);
+void lis2de_enable_self_test_mode(lis2de_dev_t *dev);
+void lis2de_disable_self_test_mode(lis2de_dev_t *dev);
 
-void lis2de_set_spi_4_wire_interface_mode(void);
-void lis2de_set_spi_3_wire_interface_mode(void);
+void lis2de_set_spi_4_wire_interface_mode(lis2de_dev_t *dev);
+void lis2de_set_spi_3_wire_interface_mode(lis2de_dev_t *dev);
 
 
 // CTRL_REG5 (0x24)
-void lis2de_reboot_memory_content(void);
+void lis2de_reboot_memory_content(lis2de_dev_t *dev);
 
-void lis2de_enable_fifo(void);
-void lis2de_disable_fifo(void);
+void lis2de_enable_fifo(lis2de_dev_t *dev);
+void lis2de_disable_fifo(lis2de_dev_t *dev);
 
-void lis2de_enable_latch_interrupt_request_on_ig1_src_reg(void);
-void lis2de_disable_latch_interrupt_request_on_ig1_src_reg(void);
+void lis2de_enable_latch_interrupt_request_on_ig1_src_reg(lis2de_dev_t *dev);
+void lis2de_disable_latch_interrupt_request_on_ig1_src_reg(lis2de_dev_t *dev);
 
-void lis2de_enable_latch_interrupt_request_on_ig2_src_reg(void);
-void lis2de_disable_latch_interrupt_request_on_ig2_src_reg(void);
+void lis2de_enable_latch_interrupt_request_on_ig2_src_reg(lis2de_dev_t *dev);
+void lis2de_disable_latch_interrupt_request_on_ig2_src_reg(lis2de_dev_t *dev);
 
 
 // CTRL_REG6 (0x25)
-void lis2de_enable_click_interrupt_on_ig2_pin(void);
-void lis2de_disable_click_interrupt_on_ig2_pin(void);
+void lis2de_enable_click_interrupt_on_ig2_pin(lis2de_dev_t *dev);
+void lis2de_disable_click_interrupt_on_ig2_pin(lis2de_dev_t *dev);
 
-void lis2de_enable_interrupt_1_function_on_ig2_pin(void);
-void lis2de_disable_interrupt_1_function_on_ig2_pin(void);
+void lis2de_enable_interrupt_1_function_on_ig2_pin(lis2de_dev_t *dev);
+void lis2de_disable_interrupt_1_function_on_ig2_pin(lis2de_dev_t *dev);
 
-void lis2de_enable_interrupt_2_function_on_ig2_pin(void);
-void lis2de_disable_interrupt_2_function_on_ig2_pin(void);
+void lis2de_enable_interrupt_2_function_on_ig2_pin(lis2de_dev_t *dev);
+void lis2de_disable_interrupt_2_function_on_ig2_pin(lis2de_dev_t *dev);
 
-void lis2de_enable_boot_on_ig2_pin(void);
-void lis2de_disable_boot_on_ig2_pin(void);
+void lis2de_enable_boot_on_ig2_pin(lis2de_dev_t *dev);
+void lis2de_disable_boot_on_ig2_pin(lis2de_dev_t *dev);
 
-void lis2de_enable_activity_interrupt_on_ig2_pin(void);
-void lis2de_disable_activity_interrupt_on_ig2_pin(void);
+void lis2de_enable_activity_interrupt_on_ig2_pin(lis2de_dev_t *dev);
+void lis2de_disable_activity_interrupt_on_ig2_pin(lis2de_dev_t *dev);
 
-void lis2de_set_interrupt_active_high(void);
-void lis2de_set_interrupt_active_low(void);
+void lis2de_set_interrupt_active_high(lis2de_dev_t *dev);
+void lis2de_set_interrupt_active_low(lis2de_dev_t *dev);
 
 // REFERENCE/DATACAPTURE (0x26)
-void lis2de_set_reference(uint8_t value);
+void lis2de_set_reference(lis2de_dev_t *dev, uint8_t value);
 
 // FIFO_CTRL_REG (0x2E)
-void lis2de_set_fifo_mode_to_bypass_mode(void);
-void lis2de_set_fifo_mode_to_fifo_mode(void);
-void lis2de_set_fifo_mode_to_stream_mode(void);
-void lis2de_set_fifo_mode_to_trigger_mode(void);
+void lis2de_set_fifo_mode_to_bypass_mode(lis2de_dev_t *dev);
+void lis2de_set_fifo_mode_to_fifo_mode(lis2de_dev_t *dev);
+void lis2de_set_fifo_mode_to_stream_mode(lis2de_dev_t *dev);
+void lis2de_set_fifo_mode_to_trigger_mode(lis2de_dev_t *dev);
 
-void lis2de_set_trigger_event_allows_to_trigger_signal_on_int1(void);
-void lis2de_set_trigger_event_allows_to_trigger_signal_on_int2(void);
+void lis2de_set_trigger_event_allows_to_trigger_signal_on_int1(lis2de_dev_t *dev);
+void lis2de_set_trigger_event_allows_to_trigger_signal_on_int2(lis2de_dev_t *dev);
 
-void lis2de_set_fth(uint8_t value);
+void lis2de_set_fth(lis2de_dev_t *dev, uint8_t value);
 
 // IG1_CFG (0x30)
-void lis2de_set_ig1_or_combination_of_interrupt_events(void);
-void lis2de_set_ig1_and_combination_of_interrupt_events(void);
-void lis2de_set_ig1_6_direction_movement_recognition(void);
-void lis2de_set_ig1_6_direction_position_recognition(void);
-
-void lis2de_enable_ig1_interrupt_generation_on_z_high_event(void);
-void lis2de_disable_ig1_interrupt_generation_on_z_high_event(void);
-void lis2de_enable_ig1_interrupt_generation_on_z_low_event(void);
-void lis2de_disable_ig1_interrupt_generation_on_z_low_event(void);
-
-void lis2de_enable_ig1_interrupt_generation_on_y_high_event(void);
-void lis2de_disable_ig1_interrupt_generation_on_y_high_event(void);
-void lis2de_enable_ig1_interrupt_generation_on_y_low_event(void);
-void lis2de_disable_ig1_interrupt_generation_on_y_low_event(void);
-
-void lis2de_enable_ig1_interrupt_generation_on_x_high_event(void);
-void lis2de_disable_ig1_interrupt_generation_on_x_high_event(void);
-void lis2de_enable_ig1_interrupt_generation_on_x_low_event(void);
-void lis2de_disable_ig1_interrupt_generation_on_x_low_event(void);
+void lis2de_set_ig1_or_combination_of_interrupt_events(lis2de_dev_t *dev);
+void lis2de_set_ig1_and_combination_of_interrupt_events(lis2de_dev_t *dev);
+void lis2de_set_ig1_6_direction_movement_recognition(lis2de_dev_t *dev);
+void lis2de_set_ig1_6_direction_position_recognition(lis2de_dev_t *dev);
+
+void lis2de_enable_ig1_interrupt_generation_on_z_high_event(lis2de_dev_t *dev);
+void lis2de_disable_ig1_interrupt_generation_on_z_high_event(lis2de_dev_t *dev);
+void lis2de_enable_ig1_interrupt_generation_on_z_low_event(lis2de_dev_t *dev);
+void lis2de_disable_ig1_interrupt_generation_on_z_low_event(lis2de_dev_t *dev);
+
+void lis2de_enable_ig1_interrupt_generation_on_y_high_event(lis2de_dev_t *dev);
+void lis2de_disable_ig1_interrupt_generation_on_y_high_event(lis2de_dev_t *dev);
+void lis2de_enable_ig1_interrupt_generation_on_y_low_event(lis2de_dev_t *dev);
+void lis2de_disable_ig1_interrupt_generation_on_y_low_event(lis2de_dev_t *dev);
+
+void lis2de_enable_ig1_interrupt_generation_on_x_high_event(lis2de_dev_t *dev);
+void lis2de_disable_ig1_interrupt_generation_on_x_high_event(lis2de_dev_t *dev);
+void lis2de_enable_ig1_interrupt_generation_on_x_low_event(lis2de_dev_t *dev);
+void lis2de_disable_ig1_interrupt_generation_on_x_low_event(lis2de_dev_t *dev);
 
 // IG1_THS (0x32)
-void lis2de_set_ig1_threshold(uint8_t ths);
+void lis2de_set_ig1_threshold(lis2de_dev_t *dev, uint8_t ths);
 
 // IG1_DURATION (0x33)
-void lis2de_set_ig1_duration(uint8_t dur);
+void lis2de_set_ig1_duration(lis2de_dev_t *dev, uint8_t dur);
 
 
 // IG2_CFG (0x34)
-void lis2de_set_ig2_or_combination_of_interrupt_events(void);
-void lis2de_set_ig2_and_combination_of_interrupt_events(void);
-void lis2de_set_ig2_6_direction_movement_recognition(void);
-void lis2de_set_ig2_6_direction_position_recognition(void);
-
-void lis2de_enable_ig2_interrupt_generation_on_z_high_event(void);
-void lis2de_disable_ig2_interrupt_generation_on_z_high_event(void);
-void lis2de_enable_ig2_interrupt_generation_on_z_low_event(void);
-void lis2de_disable_ig2_interrupt_generation_on_z_low_event(void);
-
-void lis2de_enable_ig2_interrupt_generation_on_y_high_event(void);
-void lis2de_disable_ig2_interrupt_generation_on_y_high_event(void);
-void lis2de_enable_ig2_interrupt_generation_on_y_low_event(void);
-void lis2de_disable_ig2_interrupt_generation_on_y_low_event(void);
-
-void lis2de_enable_ig2_interrupt_generation_on_x_high_event(void);
-void lis2de_disable_ig2_interrupt_generation_on_x_high_event(void);
-void lis2de_enable_ig2_interrupt_generation_on_x_low_event(void);
-void lis2de_disable_ig2_interrupt_generation_on_x_low_event(void);
+void lis2de_set_ig2_or_combination_of_interrupt_events(lis2de_dev_t *dev);
+void lis2de_set_ig2_and_combination_of_interrupt_events(lis2de_dev_t *dev);
+void lis2de_set_ig2_6_direction_movement_recognition(lis2de_dev_t *dev);
+void lis2de_set_ig2_6_direction_position_recognition(lis2de_dev_t *dev);
+
+void lis2de_enable_ig2_interrupt_generation_on_z_high_event(lis2de_dev_t *dev);
+void lis2de_disable_ig2_interrupt_generation_on_z_high_event(lis2de_dev_t *dev);
+void lis2de_enable_ig2_interrupt_generation_on_z_low_event(lis2de_dev_t *dev);
+void lis2de_disable_ig2_interrupt_generation_on_z_low_event(lis2de_dev_t *dev);
+
+void lis2de_enable_ig2_interrupt_generation_on_y_high_event(lis2de_dev_t *dev);
+void lis2de_disable_ig2_interrupt_generation_on_y_high_event(lis2de_dev_t *dev);
+void lis2de_enable_ig2_interrupt_generation_on_y_low_event(lis2de_dev_t *dev);
+void lis2de_disable_ig2_interrupt_generation_on_y_low_event(lis2de_dev_t *dev);
+
+void lis2de_enable_ig2_interrupt_generation_on_x_high_event(lis2de_dev_t *dev);
+void lis2de_disable_ig2_interrupt_generation_on_x_high_event(lis2de_dev_t *dev);
+void lis2de_enable_ig2_interrupt_generation_on_x_low_event(lis2de_dev_t *dev);
+void lis2de_disable_ig2_interrupt_generation_on_x_low_event(lis2de_dev_t *dev);
 
 // INT2_THS (0x36)
-void lis2de_set_ig2_threshold(uint8_t ths);
+void lis2de_set_ig2_threshold(lis2de_dev_t *dev, uint8_t ths);
 
 // INT2_DURATION (0x37)
-void lis2de_set_ig2_duration(uint8_t dur);
+void lis2de_set_ig2_duration(lis2de_dev_t *dev, uint8_t dur);
 
 // CLICK_CFG (0x38)
-void lis2de_enable_interrupt_double_click_on_z_axis(void);
-void lis2de_disable_interrupt_double_click_on_z_axis(void);
-void lis2de_enable_interrupt_single_click_on_z_axis(void);
-void lis2de_disable_interrupt_single_click_on_z_axis(void);
+void lis2de_enable_interrupt_double_click_on_z_axis(lis2de_dev_t *dev);
+void lis2de_disable_interrupt_double_click_on_z_axis(lis2de_dev_t *dev);
+void lis2de_enable_interrupt_single_click_on_z_axis(lis2de_dev_t *dev);
+void lis2de_disable_interrupt_single_click_on_z_axis(lis2de_dev_t *dev);
 
-void lis2de_enable_interrupt_double_click_on_y_axis(void);
-void lis2de_disable_interrupt_double_click_on_y_axis(void);
-void lis2de_enable_interrupt_single_click_on_y_axis(void);
-void lis2de_disable_interrupt_single_click_on_y_axis(void);
+void lis2de_enable_interrupt_double_click_on_y_axis(lis2de_dev_t *dev);
+void lis2de_disable_interrupt_double_click_on_y_axis(lis2de_dev_t *dev);
+void lis2de_enable_interrupt_single_click_on_y_axis(lis2de_dev_t *dev);
+void lis2de_disable_interrupt_single_click_on_y_axis(lis2de_dev_t *dev);
 
-void lis2de_enable_interrupt_double_click_on_x_axis(void);
-void lis2de_disable_interrupt_double_click_on_x_axis(void);
-void lis2de_enable_interrupt_single_click_on_x_axis(void);
-void lis2de_disable_interrupt_single_click_on_x_axis(void);
+void lis2de_enable_interrupt_double_click_on_x_axis(lis2de_dev_t *dev);
+void lis2de_disable_interrupt_double_click_on_x_axis(lis2de_dev_t *dev);
+void lis2de_enable_interrupt_single_click_on_x_axis(lis2de_dev_t *dev);
+void lis2de_disable_interrupt_single_click_on_x_axis(lis2de_dev_t *dev);
 
 // CLICK_THS (0x3A)
-void lis2de_set_click_threshold(uint8_t threshold);
+void lis2de_set_click_threshold(lis2de_dev_t *dev, uint8_t threshold);
 
 // TIME_LIMIT (0x3B)
-void lis2de_set_time_limit(uint8_t limit);
+void lis2de_set_time_limit(lis2de_dev_t *dev, uint8_t limit);
 
 // TIME_LATENCY (0x3C)
-void lis2de_set_time_limit(uint8_t limit);
+void lis2de_set_time_latency(lis2de_dev_t *dev, uint8_t latency);
 
 // TIME_WINDOW (0x3D)
-void lis2de_set_time_window(uint8_t window);
+void lis2de_set_time_window(lis2de_dev_t *dev, uint8_t window);
 
 // Act_THS (0x3E)
-void lis2de_set_act_threshold(uint8_t threshold);
+void lis2de_set_act_threshold(lis2de_dev_t *dev, uint8_t threshold);
 
 // Act_DUR (0x3F)
-void lis2de_set_act_duration(uint8_t duration);
+void lis2de_set_act_duration(lis2de_dev_t *dev, uint8_t duration);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,360 @@
+#ifndef LIS2DE_HPP
+#define LIS2DE_HPP
+
+#include <stdint.h>
+
+#include "lis2de.h"
+
+/* Typed C++11 front end for the register map of lis2de.c. Registers and
+ * fields are compile-time descriptors, so masks and shifts fold into
+ * immediates and misuse fails to compile:
+ *
+ *   lis2de::Device acc(&dev);
+ *   acc.write<field::DataRate, field::LowPower>(Odr::Hz100, false);
+ *   FullScale fs = acc.read<field::FullScaleSelection>();
+ *
+ * Several fields of one register are written in a single read-modify-
+ * write, or a plain write when they cover the whole register. Writes to
+ * read-only registers, fields of different registers in one write and
+ * overlapping fields are rejected at compile time. Access goes through
+ * lis2de_query_register() and lis2de_modify_register(), so the shadow
+ * and configuration batches apply as for the C functions.
+ *
+ * Only C++11 is used, without the standard library, as the AVR
+ * toolchain builds gnu++11 and has no <type_traits>. */
+
+namespace lis2de
+{
+
+enum class Odr : uint8_t
+{
+    PowerDown = 0b0000,
+    Hz1       = 0b0001,
+    Hz10      = 0b0010,
+    Hz25      = 0b0011,
+    Hz50      = 0b0100,
+    Hz100     = 0b0101,
+    Hz200     = 0b0110,
+    Hz400     = 0b0111,
+    // Low-power mode only
+    Hz1620    = 0b1000,
+    // 1.344 kHz in normal, 5.376 kHz in low-power mode
+    Hz1344    = 0b1001
+};
+
+enum class FullScale : uint8_t
+{
+    G2  = 0b00,
+    G4  = 0b01,
+    G8  = 0b10,
+    G16 = 0b11
+};
+
+enum class FifoMode : uint8_t
+{
+    Bypass        = 0b00,
+    Fifo          = 0b01,
+    Stream        = 0b10,
+    StreamToFifo  = 0b11
+};
+
+enum class HpfMode : uint8_t
+{
+    Normal    = 0b00,
+    Reference = 0b01,
+    AutoReset = 0b11
+};
+
+// AOI and 6D bits of IG1_CFG/IG2_CFG
+enum class IgMode : uint8_t
+{
+    OrCombination     = 0b00,
+    Movement6D        = 0b01,
+    AndCombination    = 0b10,
+    Position6D        = 0b11
+};
+
+template <uint8_t Address, bool Writable>
+struct Register
+{
+    static constexpr uint8_t address = Address;
+    static constexpr bool writable = Writable;
+};
+
+namespace reg
+{
+using StatusAux   = Register<0x07, false>;
+using IntCounter  = Register<0x0E, false>;
+using WhoAmI      = Register<0x0F, false>;
+using TempCfg     = Register<0x1F, true>;
+using CtrlReg1    = Register<0x20, true>;
+using CtrlReg2    = Register<0x21, true>;
+using CtrlReg3    = Register<0x22, true>;
+using CtrlReg4    = Register<0x23, true>;
+using CtrlReg5    = Register<0x24, true>;
+using CtrlReg6    = Register<0x25, true>;
+using Reference   = Register<0x26, true>;
+using StatusReg2  = Register<0x27, false>;
+using FifoCtrl    = Register<0x2E, true>;
+using FifoSrc     = Register<0x2F, false>;
+using Ig1Cfg      = Register<0x30, true>;
+using Ig1Source   = Register<0x31, false>;
+using Ig1Ths      = Register<0x32, true>;
+using Ig1Duration = Register<0x33, true>;
+using Ig2Cfg      = Register<0x34, true>;
+using Ig2Source   = Register<0x35, false>;
+using Ig2Ths      = Register<0x36, true>;
+using Ig2Duration = Register<0x37, true>;
+using ClickCfg    = Register<0x38, true>;
+using ClickSrc    = Register<0x39, false>;
+using ClickThs    = Register<0x3A, true>;
+using TimeLimit   = Register<0x3B, true>;
+using TimeLatency = Register<0x3C, true>;
+using TimeWindow  = Register<0x3D, true>;
+using ActThs      = Register<0x3E, true>;
+using ActDur      = Register<0x3F, true>;
+}
+
+template <typename Reg, uint8_t Mask, typename T = uint8_t>
+struct Field
+{
+    static_assert(Mask != 0, "empty field");
+
+    using reg = Reg;
+    using type = T;
+
+    static constexpr uint8_t mask = Mask;
+    static constexpr uint8_t shift = (Mask & 0x01) ? 0 : (Mask & 0x02) ? 1 :
+                                     (Mask & 0x04) ? 2 : (Mask & 0x08) ? 3 :
+                                     (Mask & 0x10) ? 4 : (Mask & 0x20) ? 5 :
+                                     (Mask & 0x40) ? 6 : 7;
+
+    static constexpr uint8_t encode(T value)
+    {
+        return static_cast<uint8_t>((static_cast<uint8_t>(value) << shift) & mask);
+    }
+
+    static constexpr T decode(uint8_t raw)
+    {
+        return static_cast<T>((raw & mask) >> shift);
+    }
+};
+
+namespace field
+{
+// STATUS_REG_AUX (0x07)
+using TemperatureOverrun       = Field<reg::StatusAux, 0x40, bool>;
+using TemperatureDataAvailable = Field<reg::StatusAux, 0x04, bool>;
+
+// WHO_AM_I (0x0F)
+using DeviceId = Field<reg::WhoAmI, 0xFF>;
+
+// TEMP_CFG_REG (0x1F), both bits set enable the sensor
+using TemperatureEnable = Field<reg::TempCfg, 0xC0>;
+
+// CTRL_REG1 (0x20)
+using DataRate = Field<reg::CtrlReg1, 0xF0, Odr>;
+using LowPower = Field<reg::CtrlReg1, 0x08, bool>;
+using ZEnable  = Field<reg::CtrlReg1, 0x04, bool>;
+using YEnable  = Field<reg::CtrlReg1, 0x02, bool>;
+using XEnable  = Field<reg::CtrlReg1, 0x01, bool>;
+
+// CTRL_REG2 (0x21)
+using HighPassMode         = Field<reg::CtrlReg2, 0xC0, HpfMode>;
+using HighPassCutoff       = Field<reg::CtrlReg2, 0x30>;
+using FilteredDataSelected = Field<reg::CtrlReg2, 0x08, bool>;
+using HighPassClick        = Field<reg::CtrlReg2, 0x04, bool>;
+using HighPassIg2          = Field<reg::CtrlReg2, 0x02, bool>;
+using HighPassIg1          = Field<reg::CtrlReg2, 0x01, bool>;
+
+// CTRL_REG3 (0x22)
+using ClickOnInt1         = Field<reg::CtrlReg3, 0x80, bool>;
+using Ig1OnInt1           = Field<reg::CtrlReg3, 0x40, bool>;
+using Ig2OnInt1           = Field<reg::CtrlReg3, 0x20, bool>;
+using Drdy1OnInt1         = Field<reg::CtrlReg3, 0x10, bool>;
+using Drdy2OnInt1         = Field<reg::CtrlReg3, 0x08, bool>;
+using FifoWatermarkOnInt1 = Field<reg::CtrlReg3, 0x04, bool>;
+using FifoOverrunOnInt1   = Field<reg::CtrlReg3, 0x02, bool>;
+
+// CTRL_REG4 (0x23)
+using BlockDataUpdate    = Field<reg::CtrlReg4, 0x80, bool>;
+using FullScaleSelection = Field<reg::CtrlReg4, 0x30, FullScale>;
+using SelfTest           = Field<reg::CtrlReg4, 0x06>;
+using SpiThreeWire       = Field<reg::CtrlReg4, 0x01, bool>;
+
+// CTRL_REG5 (0x24)
+using Boot        = Field<reg::CtrlReg5, 0x80, bool>;
+using FifoEnable  = Field<reg::CtrlReg5, 0x40, bool>;
+using LatchIg1    = Field<reg::CtrlReg5, 0x08, bool>;
+using Detect4DIg1 = Field<reg::CtrlReg5, 0x04, bool>;
+using LatchIg2    = Field<reg::CtrlReg5, 0x02, bool>;
+using Detect4DIg2 = Field<reg::CtrlReg5, 0x01, bool>;
+
+// CTRL_REG6 (0x25)
+using ClickOnInt2    = Field<reg::CtrlReg6, 0x80, bool>;
+using Ig1OnInt2      = Field<reg::CtrlReg6, 0x40, bool>;
+using Ig2OnInt2      = Field<reg::CtrlReg6, 0x20, bool>;
+using BootOnInt2     = Field<reg::CtrlReg6, 0x10, bool>;
+using ActivityOnInt2 = Field<reg::CtrlReg6, 0x08, bool>;
+using IntActiveLow   = Field<reg::CtrlReg6, 0x02, bool>;
+
+// REFERENCE (0x26)
+using ReferenceValue = Field<reg::Reference, 0xFF>;
+
+// STATUS_REG2 (0x27)
+using ZyxOverrun       = Field<reg::StatusReg2, 0x80, bool>;
+using ZOverrun         = Field<reg::StatusReg2, 0x40, bool>;
+using YOverrun         = Field<reg::StatusReg2, 0x20, bool>;
+using XOverrun         = Field<reg::StatusReg2, 0x10, bool>;
+using ZyxDataAvailable = Field<reg::StatusReg2, 0x08, bool>;
+using ZDataAvailable   = Field<reg::StatusReg2, 0x04, bool>;
+using YDataAvailable   = Field<reg::StatusReg2, 0x02, bool>;
+using XDataAvailable   = Field<reg::StatusReg2, 0x01, bool>;
+
+// FIFO_CTRL_REG (0x2E)
+using FifoModeSelection = Field<reg::FifoCtrl, 0xC0, FifoMode>;
+using TriggerOnInt2     = Field<reg::FifoCtrl, 0x20, bool>;
+using FifoThreshold     = Field<reg::FifoCtrl, 0x1F>;
+
+// FIFO_SRC_REG (0x2F)
+using FifoWatermark     = Field<reg::FifoSrc, 0x80, bool>;
+using FifoOverrun       = Field<reg::FifoSrc, 0x40, bool>;
+using FifoEmpty         = Field<reg::FifoSrc, 0x20, bool>;
+using FifoUnreadSamples = Field<reg::FifoSrc, 0x1F>;
+
+// IG1_CFG (0x30) / IG2_CFG (0x34)
+template <typename Cfg> using IgModeSelection = Field<Cfg, 0xC0, IgMode>;
+template <typename Cfg> using IgZHigh         = Field<Cfg, 0x20, bool>;
+template <typename Cfg> using IgZLow          = Field<Cfg, 0x10, bool>;
+template <typename Cfg> using IgYHigh         = Field<Cfg, 0x08, bool>;
+template <typename Cfg> using IgYLow          = Field<Cfg, 0x04, bool>;
+template <typename Cfg> using IgXHigh         = Field<Cfg, 0x02, bool>;
+template <typename Cfg> using IgXLow          = Field<Cfg, 0x01, bool>;
+
+// IG1_SOURCE (0x31) / IG2_SOURCE (0x35)
+template <typename Src> using IgActive     = Field<Src, 0x40, bool>;
+template <typename Src> using IgZHighEvent = Field<Src, 0x20, bool>;
+template <typename Src> using IgZLowEvent  = Field<Src, 0x10, bool>;
+template <typename Src> using IgYHighEvent = Field<Src, 0x08, bool>;
+template <typename Src> using IgYLowEvent  = Field<Src, 0x04, bool>;
+template <typename Src> using IgXHighEvent = Field<Src, 0x02, bool>;
+template <typename Src> using IgXLowEvent  = Field<Src, 0x01, bool>;
+
+using Ig1Threshold = Field<reg::Ig1Ths, 0x7F>;
+using Ig1Duration  = Field<reg::Ig1Duration, 0x7F>;
+using Ig2Threshold = Field<reg::Ig2Ths, 0x7F>;
+using Ig2Duration  = Field<reg::Ig2Duration, 0x7F>;
+
+// CLICK_CFG (0x38)
+using ZDoubleClick = Field<reg::ClickCfg, 0x20, bool>;
+using ZSingleClick = Field<reg::ClickCfg, 0x10, bool>;
+using YDoubleClick = Field<reg::ClickCfg, 0x08, bool>;
+using YSingleClick = Field<reg::ClickCfg, 0x04, bool>;
+using XDoubleClick = Field<reg::ClickCfg, 0x02, bool>;
+using XSingleClick = Field<reg::ClickCfg, 0x01, bool>;
+
+// CLICK_SRC (0x39)
+using ClickActive      = Field<reg::ClickSrc, 0x40, bool>;
+using DoubleClickEvent = Field<reg::ClickSrc, 0x20, bool>;
+using SingleClickEvent = Field<reg::ClickSrc, 0x10, bool>;
+using ClickNegative    = Field<reg::ClickSrc, 0x08, bool>;
+using ZClickEvent      = Field<reg::ClickSrc, 0x04, bool>;
+using YClickEvent      = Field<reg::ClickSrc, 0x02, bool>;
+using XClickEvent      = Field<reg::ClickSrc, 0x01, bool>;
+
+// CLICK_THS (0x3A) .. Act_DUR (0x3F)
+using LatchClick     = Field<reg::ClickThs, 0x80, bool>;
+using ClickThreshold = Field<reg::ClickThs, 0x7F>;
+using TimeLimit      = Field<reg::TimeLimit, 0x7F>;
+using TimeLatency    = Field<reg::TimeLatency, 0xFF>;
+using TimeWindow     = Field<reg::TimeWindow, 0xFF>;
+using ActThreshold   = Field<reg::ActThs, 0x7F>;
+using ActDuration    = Field<reg::ActDur, 0xFF>;
+}
+
+namespace detail
+{
+template <typename A, typename B>
+struct Same
+{
+    static constexpr bool value = false;
+};
+
+template <typename A>
+struct Same<A, A>
+{
+    static constexpr bool value = true;
+};
+
+/* The fields of one write, taken apart recursively: whether they all
+ * belong to Reg, the sum and the OR of their masks, and their values
+ * encoded into one byte */
+template <typename Reg, typename... Fs>
+struct Fields
+{
+    static constexpr bool same_register = true;
+    static constexpr unsigned mask_sum = 0;
+    static constexpr uint8_t mask = 0;
+
+    static constexpr uint8_t encode() { return 0; }
+};
+
+template <typename Reg, typename F, typename... Fs>
+struct Fields<Reg, F, Fs...>
+{
+    using Rest = Fields<Reg, Fs...>;
+
+    static constexpr bool same_register =
+        Same<Reg, typename F::reg>::value && Rest::same_register;
+    static constexpr unsigned mask_sum = F::mask + Rest::mask_sum;
+    static constexpr uint8_t mask = F::mask | Rest::mask;
+
+    static constexpr uint8_t encode(typename F::type value, typename Fs::type... values)
+    {
+        return static_cast<uint8_t>(F::encode(value) | Rest::encode(values...));
+    }
+};
+}
+
+class Device
+{
+public:
+    explicit Device(lis2de_dev_t *dev) : dev_(dev) {}
+
+    lis2de_dev_t *handle() const { return dev_; }
+
+    // Whole register, e.g. to decode several fields from one read
+    template <typename Reg>
+    uint8_t read_register() const
+    {
+        return lis2de_query_register(dev_, Reg::address);
+    }
+
+    template <typename F>
+    typename F::type read() const
+    {
+        return F::decode(read_register<typename F::reg>());
+    }
+
+    template <typename F, typename... Fs>
+    void write(typename F::type value, typename Fs::type... values)
+    {
+        using Reg = typename F::reg;
+        using All = detail::Fields<Reg, F, Fs...>;
+
+        static_assert(Reg::writable, "register is read-only");
+        static_assert(All::same_register, "fields of one write must share a register");
+        // Disjoint masks add up to the same value as they OR together
+        static_assert(All::mask_sum == All::mask, "fields overlap");
+
+        lis2de_modify_register(dev_, Reg::address, All::mask,
+                               All::encode(value, values...));
+    }
+
+private:
+    lis2de_dev_t *dev_;
+};
+
+}
+
+#endif
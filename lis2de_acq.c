@@ -0,0 +1,280 @@
+#define _GNU_SOURCE
+
+#include "lib/lis2de-driver/include/lis2de_acq.h"
+
+#include <sched.h>
+#include <time.h>
+
+#if LIS2DE_USE_CEXCEPTION
+#error "lis2de_acq needs the driver built with LIS2DE_USE_CEXCEPTION=0"
+#endif
+
+// Frames left to the FIFO between two drains, half of its depth
+#define DRAIN_FRAMES (LIS2DE_FIFO_DEPTH / 2)
+
+// Same index protocol as lis2de_ring.c
+#define ACQ_LOAD(p)         atomic_load_explicit(p, memory_order_relaxed)
+#define ACQ_ACQUIRE(p)      atomic_load_explicit(p, memory_order_acquire)
+#define ACQ_RELEASE(p, v)   atomic_store_explicit(p, v, memory_order_release)
+
+void
+lis2de_acq_init(lis2de_acq_t *acq)
+{
+    acq->buses = 0;
+    acq->devices = 0;
+    acq->next = 0;
+    ACQ_RELEASE(&acq->running, 0);
+}
+
+uint8_t
+lis2de_acq_add_bus(lis2de_acq_t *acq,
+                   uint8_t *bus,
+                   lis2de_acq_frame_t *buf,
+                   lis2de_ring_index_t capacity,
+                   int cpu)
+{
+    lis2de_acq_worker_t *w;
+
+    if (capacity == 0 || capacity > LIS2DE_RING_MAX_CAPACITY ||
+        (capacity & (capacity - 1)))
+    {
+        return E_INVALID_RING_CAPACITY;
+    }
+    if (acq->buses == LIS2DE_ACQ_MAX_BUSES)
+    {
+        return E_ACQ_LIMIT;
+    }
+
+    w = &acq->workers[acq->buses];
+    w->count = 0;
+    w->cpu = cpu;
+    w->wait = 0;
+    w->wait_user = 0;
+    w->pinned = 0;
+    w->interval_us = LIS2DE_ACQ_IDLE_US;
+    w->drains = 0;
+    w->frames = 0;
+    w->errors = 0;
+    w->dropped = 0;
+    w->buf = buf;
+    w->mask = capacity - 1;
+    ACQ_RELEASE(&w->head, 0);
+    ACQ_RELEASE(&w->tail, 0);
+
+    *bus = acq->buses++;
+    return 0;
+}
+
+void
+lis2de_acq_set_wait(lis2de_acq_t *acq,
+                    uint8_t bus,
+                    lis2de_acq_wait_t wait,
+                    void *user)
+{
+    acq->workers[bus].wait = wait;
+    acq->workers[bus].wait_user = user;
+}
+
+uint8_t
+lis2de_acq_add_device(lis2de_acq_t *acq,
+                      uint8_t bus,
+                      lis2de_dev_t *dev)
+{
+    lis2de_acq_worker_t *w = &acq->workers[bus];
+
+    if (w->count == LIS2DE_ACQ_MAX_BUS_DEVICES)
+    {
+        return E_ACQ_LIMIT;
+    }
+    w->devs[w->count] = dev;
+    w->ids[w->count] = acq->devices++;
+    w->count++;
+    return 0;
+}
+
+static void
+lis2de_acq_sleep(void *user,
+                 uint32_t us)
+{
+    struct timespec ts;
+
+    (void) user;
+    ts.tv_sec = us / 1000000UL;
+    ts.tv_nsec = (long) (us % 1000000UL) * 1000;
+    nanosleep(&ts, 0);
+}
+
+/* Drains are spaced so the fastest device on the bus has its FIFO half
+ * full by the next one. The rates are read once per device here, on the
+ * worker's own bus. */
+static void
+lis2de_acq_worker_setup(lis2de_acq_worker_t *w)
+{
+    w->interval_us = LIS2DE_ACQ_IDLE_US;
+    for (uint8_t i = 0; i < w->count; i++)
+    {
+        uint32_t drain_us;
+
+        lis2de_timestamp_setup(&w->ts[i], w->devs[i]);
+        if (lis2de_query_error(w->devs[i]))
+        {
+            w->errors++;
+            lis2de_clear_error(w->devs[i]);
+            continue;
+        }
+        if (!w->ts[i].nominal_q8)
+        {
+            continue;
+        }
+        drain_us = (uint32_t) (((uint64_t) w->ts[i].nominal_q8 * DRAIN_FRAMES) >> 8);
+        if (drain_us < w->interval_us)
+        {
+            w->interval_us = drain_us;
+        }
+    }
+}
+
+// Producer side of the queue, frames that do not fit are dropped
+static void
+lis2de_acq_push(lis2de_acq_worker_t *w,
+                const lis2de_timed_data_t *timed,
+                uint8_t count,
+                uint8_t id)
+{
+    lis2de_ring_index_t head = ACQ_LOAD(&w->head);
+    lis2de_ring_index_t space = w->mask + 1 - (lis2de_ring_index_t) (head - ACQ_ACQUIRE(&w->tail));
+
+    if (count > space)
+    {
+        w->dropped += count - space;
+        count = (uint8_t) space;
+    }
+    for (uint8_t i = 0; i < count; i++)
+    {
+        lis2de_acq_frame_t *frame = &w->buf[(head + i) & w->mask];
+
+        frame->t_us = timed[i].t_us;
+        frame->data = timed[i].data;
+        frame->device = id;
+    }
+    ACQ_RELEASE(&w->head, head + count);
+}
+
+static void *
+lis2de_acq_worker_run(void *arg)
+{
+    lis2de_acq_worker_t *w = arg;
+    lis2de_acq_wait_t wait = w->wait ? w->wait : lis2de_acq_sleep;
+    lis2de_timed_data_t timed[LIS2DE_FIFO_DEPTH];
+
+    if (w->cpu >= 0)
+    {
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        CPU_SET(w->cpu, &set);
+        w->pinned = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+
+    lis2de_acq_worker_setup(w);
+    while (ACQ_LOAD(&w->engine->running))
+    {
+        uint32_t start = w->count ? lis2de_query_micros(w->devs[0]) : 0;
+        uint32_t busy;
+
+        for (uint8_t i = 0; i < w->count; i++)
+        {
+            lis2de_dev_t *dev = w->devs[i];
+            uint8_t count = lis2de_read_fifo_timed(dev, &w->ts[i], timed,
+                                                   LIS2DE_FIFO_DEPTH);
+
+            w->drains++;
+            if (lis2de_query_error(dev))
+            {
+                w->errors++;
+                lis2de_clear_error(dev);
+                continue;
+            }
+            w->frames += count;
+            lis2de_acq_push(w, timed, count, w->ids[i]);
+        }
+
+        // The time spent on the bus counts towards the interval
+        busy = w->count ? lis2de_query_micros(w->devs[0]) - start : 0;
+        if (busy < w->interval_us)
+        {
+            wait(w->wait_user, w->interval_us - busy);
+        }
+    }
+    return 0;
+}
+
+int
+lis2de_acq_start(lis2de_acq_t *acq)
+{
+    int err;
+
+    ACQ_RELEASE(&acq->running, 1);
+    for (uint8_t bus = 0; bus < acq->buses; bus++)
+    {
+        acq->workers[bus].engine = acq;
+        err = pthread_create(&acq->workers[bus].thread, 0,
+                             lis2de_acq_worker_run, &acq->workers[bus]);
+        if (err)
+        {
+            ACQ_RELEASE(&acq->running, 0);
+            while (bus--)
+            {
+                pthread_join(acq->workers[bus].thread, 0);
+            }
+            return err;
+        }
+    }
+    return 0;
+}
+
+void
+lis2de_acq_stop(lis2de_acq_t *acq)
+{
+    if (!ACQ_LOAD(&acq->running))
+    {
+        return;
+    }
+    ACQ_RELEASE(&acq->running, 0);
+    for (uint8_t bus = 0; bus < acq->buses; bus++)
+    {
+        pthread_join(acq->workers[bus].thread, 0);
+    }
+}
+
+/* Every call starts with the queue after the one it started with last
+ * time, so a busy bus cannot keep the others waiting. */
+uint32_t
+lis2de_acq_read(lis2de_acq_t *acq,
+                lis2de_acq_frame_t *buf,
+                uint32_t max)
+{
+    uint32_t count = 0;
+
+    for (uint8_t n = 0; n < acq->buses && count < max; n++)
+    {
+        lis2de_acq_worker_t *w = &acq->workers[(acq->next + n) % acq->buses];
+        lis2de_ring_index_t tail = ACQ_LOAD(&w->tail);
+        lis2de_ring_index_t avail = ACQ_ACQUIRE(&w->head) - tail;
+
+        if (avail > max - count)
+        {
+            avail = max - count;
+        }
+        for (lis2de_ring_index_t i = 0; i < avail; i++)
+        {
+            buf[count++] = w->buf[(tail + i) & w->mask];
+        }
+        ACQ_RELEASE(&w->tail, tail + avail);
+    }
+    if (acq->buses)
+    {
+        acq->next = (uint8_t) ((acq->next + 1) % acq->buses);
+    }
+    return count;
+}
@@ -0,0 +1,138 @@
+#ifndef LIS2DE_ACQ_H
+#define LIS2DE_ACQ_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "lis2de.h"
+#include "lis2de_ring.h"
+#include "lis2de_timestamp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Acquisition engine for hosts with several I2C adapters. Every bus
+ * gets a worker thread of its own, optionally pinned to a CPU, which
+ * drains the FIFOs of the devices on that bus with timestamps and
+ * queues the frames. Workers share nothing but the stop flag: device
+ * handles, timestamp trackers and queues belong to one worker each, so
+ * buses run in parallel and throughput grows with the number of buses.
+ *
+ * Each worker hands its frames to the consumer through a single-
+ * producer/single-consumer queue like lis2de_ring.c; lis2de_acq_read()
+ * merges these queues into one stream. Frames of one device keep their
+ * order, frames of different buses are interleaved batch by batch.
+ *
+ * The devices must be configured for FIFO stream mode before the
+ * engine is started and must not be used by others while it runs.
+ * Errors are counted and cleared per drain, so the driver has to be
+ * built with LIS2DE_USE_CEXCEPTION=0. */
+
+#ifndef LIS2DE_ACQ_MAX_BUSES
+#define LIS2DE_ACQ_MAX_BUSES 8
+#endif
+
+#ifndef LIS2DE_ACQ_MAX_BUS_DEVICES
+#define LIS2DE_ACQ_MAX_BUS_DEVICES 2
+#endif
+
+// Worker pause while no device on its bus is running
+#ifndef LIS2DE_ACQ_IDLE_US
+#define LIS2DE_ACQ_IDLE_US 100000UL
+#endif
+
+typedef struct lis2de_acq_frame
+{
+    // Time on the clock of the device's bus, see lis2de_timestamp.h
+    uint32_t t_us;
+    lis2de_data_t data;
+    // Number of the device in the order of lis2de_acq_add_device()
+    uint8_t device;
+} lis2de_acq_frame_t;
+
+// Lets us microseconds pass on the bus clock between two drains
+typedef void (*lis2de_acq_wait_t)(void *user, uint32_t us);
+
+typedef struct lis2de_acq_worker
+{
+    struct lis2de_acq *engine;
+
+    // Set up before the engine starts
+    lis2de_dev_t *devs[LIS2DE_ACQ_MAX_BUS_DEVICES];
+    uint8_t ids[LIS2DE_ACQ_MAX_BUS_DEVICES];
+    uint8_t count;
+    // CPU the worker is pinned to, -1 for none
+    int cpu;
+    lis2de_acq_wait_t wait;
+    void *wait_user;
+
+    // Owned by the worker thread, counters are valid once stopped
+    pthread_t thread;
+    lis2de_timestamp_t ts[LIS2DE_ACQ_MAX_BUS_DEVICES];
+    uint32_t interval_us;
+    uint8_t pinned;
+    uint32_t drains;
+    uint32_t frames;
+    uint32_t errors;
+    // Frames lost because the queue was full
+    uint32_t dropped;
+
+    // Queue toward the consumer
+    LIS2DE_RING_ALIGNED LIS2DE_RING_INDEX head;
+    LIS2DE_RING_ALIGNED LIS2DE_RING_INDEX tail;
+    LIS2DE_RING_ALIGNED lis2de_acq_frame_t *buf;
+    lis2de_ring_index_t mask;
+} lis2de_acq_worker_t;
+
+typedef struct lis2de_acq
+{
+    lis2de_acq_worker_t workers[LIS2DE_ACQ_MAX_BUSES];
+    uint8_t buses;
+    uint8_t devices;
+    // Nonzero while the workers are to keep going
+    LIS2DE_RING_INDEX running;
+
+    // Consumer: queue the next merge starts with
+    uint8_t next;
+} lis2de_acq_t;
+
+void lis2de_acq_init(lis2de_acq_t *acq);
+
+/* Add a worker with a queue of capacity frames in buf, a power of two,
+ * and return its number in bus. cpu is the CPU to pin it to, -1 for
+ * none. Returns 0, E_INVALID_RING_CAPACITY or E_ACQ_LIMIT. */
+uint8_t lis2de_acq_add_bus(lis2de_acq_t *acq,
+                           uint8_t *bus,
+                           lis2de_acq_frame_t *buf,
+                           lis2de_ring_index_t capacity,
+                           int cpu);
+
+/* Replace the sleep between two drains of a worker, e.g. to advance
+ * the virtual clock of a simulated bus. */
+void lis2de_acq_set_wait(lis2de_acq_t *acq,
+                         uint8_t bus,
+                         lis2de_acq_wait_t wait,
+                         void *user);
+
+// Add a device on a bus. Returns 0 or E_ACQ_LIMIT.
+uint8_t lis2de_acq_add_device(lis2de_acq_t *acq,
+                              uint8_t bus,
+                              lis2de_dev_t *dev);
+
+/* Start one thread per bus. Returns 0 or the error number of
+ * pthread_create(), in which case no worker is left running. */
+int lis2de_acq_start(lis2de_acq_t *acq);
+void lis2de_acq_stop(lis2de_acq_t *acq);
+
+/* Consumer: move up to max frames out of the worker queues. Returns
+ * the number of frames stored in buf. */
+uint32_t lis2de_acq_read(lis2de_acq_t *acq,
+                         lis2de_acq_frame_t *buf,
+                         uint32_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef LIS2DE_BUS_H
+#define LIS2DE_BUS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bus backend interface. The driver performs every register access
+ * through these operations, so the same driver runs on top of the AVR
+ * i2cmaster library, Linux i2c-dev or any other I2C implementation.
+ *
+ * addr is the 8-bit write address of the device (R/W bit cleared).
+ * reg is sent as is; the driver already set its MSB for multi-byte
+ * auto-increment transfers. Each operation is one complete transaction
+ * and returns 0 on success or one of the E_* constants of lis2de.h.
+ *
+ * timeout_us bounds the time an operation may spend waiting for the
+ * device or the bus, 0 waits forever. An operation running out of time
+ * returns E_LIS2DE_I2C_TIMEOUT, after which the driver calls recover()
+ * to bring the bus back into an idle state. */
+typedef struct lis2de_bus_ops
+{
+    // Optional, may be 0
+    uint8_t (*init)(void *ctx);
+
+    // START, addr+W, reg, REP_START, addr+R, len bytes, STOP
+    uint8_t (*read)(void *ctx, uint8_t addr, uint8_t reg,
+                    uint8_t *buf, uint8_t len, uint32_t timeout_us);
+
+    // START, addr+W, reg, len bytes, STOP
+    uint8_t (*write)(void *ctx, uint8_t addr, uint8_t reg,
+                     const uint8_t *buf, uint8_t len, uint32_t timeout_us);
+
+    // Optional, free running microsecond clock used to time transfers
+    uint32_t (*micros)(void *ctx);
+
+    // Optional, clock out a stuck slave and issue a STOP
+    void (*recover)(void *ctx);
+} lis2de_bus_ops_t;
+
+typedef struct lis2de_bus
+{
+    const lis2de_bus_ops_t *ops;
+    void *ctx;
+} lis2de_bus_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,353 @@
+#include "lib/lis2de-driver/include/lis2de_bus_queue.h"
+#include "lib/lis2de-driver/include/lis2de.h"
+
+#include <string.h>
+#include <time.h>
+
+static uint64_t
+lis2de_bus_queue_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000U + ts.tv_nsec / 1000;
+}
+
+lis2de_bus_class_t
+lis2de_bus_queue_classify(uint8_t reg,
+                          uint8_t write)
+{
+    // Strip the auto-increment bit
+    reg &= 0x7F;
+
+    if (write)
+    {
+        return LIS2DE_BUS_CLASS_CONFIG;
+    }
+    if ((reg >= 0x07 && reg <= 0x0D) || (reg >= 0x27 && reg <= 0x2D) ||
+        reg == 0x2F)
+    {
+        return LIS2DE_BUS_CLASS_DATA;
+    }
+    if (reg == 0x31 || reg == 0x35 || reg == 0x39)
+    {
+        return LIS2DE_BUS_CLASS_INT_SOURCE;
+    }
+    if (reg >= 0x1E && reg <= 0x3F)
+    {
+        return LIS2DE_BUS_CLASS_CONFIG;
+    }
+    return LIS2DE_BUS_CLASS_DIAGNOSTICS;
+}
+
+void
+lis2de_bus_queue_init(lis2de_bus_queue_t *queue,
+                      const lis2de_bus_t *lower)
+{
+    pthread_condattr_t attr;
+
+    queue->bus.ops = &lis2de_bus_queue_ops;
+    queue->bus.ctx = queue;
+    queue->lower = lower;
+    pthread_mutex_init(&queue->lock, 0);
+    // Deadlines are taken from the same clock as the wait statistics
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&queue->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    queue->busy = 0;
+    for (uint8_t c = 0; c < LIS2DE_BUS_CLASSES; c++)
+    {
+        queue->head[c] = 0;
+        queue->tail[c] = 0;
+        queue->bypassed[c] = 0;
+    }
+    memset(queue->stats, 0, sizeof(queue->stats));
+}
+
+void
+lis2de_bus_queue_destroy(lis2de_bus_queue_t *queue)
+{
+    pthread_cond_destroy(&queue->cond);
+    pthread_mutex_destroy(&queue->lock);
+}
+
+/* Classes that let LIS2DE_BUS_QUEUE_MAX_BYPASS grants pass rank ahead
+ * of all others, in class order among themselves. */
+static uint8_t
+lis2de_bus_queue_rank(const lis2de_bus_queue_t *queue,
+                      const uint8_t cls)
+{
+    if (queue->bypassed[cls] >= LIS2DE_BUS_QUEUE_MAX_BYPASS)
+    {
+        return cls;
+    }
+    return LIS2DE_BUS_CLASSES + cls;
+}
+
+// The oldest waiter of a class may go when no class ranks ahead of it
+static uint8_t
+lis2de_bus_queue_preempted(const lis2de_bus_queue_t *queue,
+                           const lis2de_bus_class_t cls)
+{
+    uint8_t rank = lis2de_bus_queue_rank(queue, cls);
+
+    for (uint8_t c = 0; c < LIS2DE_BUS_CLASSES; c++)
+    {
+        if (c != cls && queue->head[c] && lis2de_bus_queue_rank(queue, c) < rank)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static uint8_t
+lis2de_bus_queue_blocked(const lis2de_bus_queue_t *queue,
+                         const lis2de_bus_class_t cls,
+                         const lis2de_bus_queue_waiter_t *waiter)
+{
+    return queue->busy || queue->head[cls] != waiter ||
+           lis2de_bus_queue_preempted(queue, cls);
+}
+
+static void
+lis2de_bus_queue_unlink(lis2de_bus_queue_t *queue,
+                        const lis2de_bus_class_t cls,
+                        lis2de_bus_queue_waiter_t *waiter)
+{
+    lis2de_bus_queue_waiter_t **link = &queue->head[cls];
+    lis2de_bus_queue_waiter_t *prev = 0;
+
+    while (*link != waiter)
+    {
+        prev = *link;
+        link = &prev->next;
+    }
+    *link = waiter->next;
+    if (queue->tail[cls] == waiter)
+    {
+        queue->tail[cls] = prev;
+    }
+    if (!prev)
+    {
+        // A new oldest waiter starts counting afresh
+        queue->bypassed[cls] = 0;
+    }
+    queue->stats[cls].depth--;
+}
+
+/* Wait for the bus within the time budget *budget_us, 0 waits
+ * forever. On success *budget_us is left with what remains of the
+ * budget for the transfer. */
+static uint8_t
+lis2de_bus_queue_acquire(lis2de_bus_queue_t *queue,
+                         const lis2de_bus_class_t cls,
+                         uint32_t *budget_us)
+{
+    const uint32_t timeout_us = *budget_us;
+    lis2de_bus_queue_class_stats_t *stats = &queue->stats[cls];
+    lis2de_bus_queue_waiter_t waiter = { 0 };
+    uint64_t arrival = lis2de_bus_queue_now_us();
+    uint64_t deadline = arrival + timeout_us;
+    struct timespec ts = { (time_t) (deadline / 1000000U),
+                           (long) (deadline % 1000000U) * 1000 };
+    uint32_t waited;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->tail[cls])
+    {
+        queue->tail[cls]->next = &waiter;
+    }
+    else
+    {
+        queue->head[cls] = &waiter;
+    }
+    queue->tail[cls] = &waiter;
+    if (++stats->depth > stats->max_depth)
+    {
+        stats->max_depth = stats->depth;
+    }
+    while (lis2de_bus_queue_blocked(queue, cls, &waiter))
+    {
+        if (!timeout_us)
+        {
+            pthread_cond_wait(&queue->cond, &queue->lock);
+        }
+        else if (pthread_cond_timedwait(&queue->cond, &queue->lock, &ts) &&
+                 lis2de_bus_queue_blocked(queue, cls, &waiter))
+        {
+            // Leaving may make another waiter eligible
+            lis2de_bus_queue_unlink(queue, cls, &waiter);
+            stats->timeouts++;
+            pthread_cond_broadcast(&queue->cond);
+            pthread_mutex_unlock(&queue->lock);
+            return E_LIS2DE_I2C_BUSY;
+        }
+    }
+    waited = (uint32_t) (lis2de_bus_queue_now_us() - arrival);
+
+    queue->busy = 1;
+    for (uint8_t c = 0; c < cls; c++)
+    {
+        if (queue->head[c])
+        {
+            stats->aged++;
+            break;
+        }
+    }
+    lis2de_bus_queue_unlink(queue, cls, &waiter);
+    for (uint8_t c = 0; c < LIS2DE_BUS_CLASSES; c++)
+    {
+        if (c != cls && queue->head[c])
+        {
+            queue->bypassed[c]++;
+        }
+    }
+
+    stats->transactions++;
+    stats->wait_us += waited;
+    if (waited > stats->max_wait_us)
+    {
+        stats->max_wait_us = waited;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    // The transfer always gets at least a microsecond
+    if (timeout_us)
+    {
+        *budget_us = waited < timeout_us ? timeout_us - waited : 1;
+    }
+    return 0;
+}
+
+static void
+lis2de_bus_queue_release(lis2de_bus_queue_t *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->busy = 0;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static uint8_t
+lis2de_bus_queue_bus_init(void *ctx)
+{
+    lis2de_bus_queue_t *queue = ctx;
+    uint32_t forever = 0;
+    uint8_t err = 0;
+
+    if (queue->lower->ops->init)
+    {
+        lis2de_bus_queue_acquire(queue, LIS2DE_BUS_CLASS_CONFIG, &forever);
+        err = queue->lower->ops->init(queue->lower->ctx);
+        lis2de_bus_queue_release(queue);
+    }
+    return err;
+}
+
+static uint8_t
+lis2de_bus_queue_read(void *ctx,
+                      uint8_t addr,
+                      uint8_t reg,
+                      uint8_t *buf,
+                      uint8_t len,
+                      uint32_t timeout_us)
+{
+    lis2de_bus_queue_t *queue = ctx;
+    uint8_t err;
+
+    err = lis2de_bus_queue_acquire(queue, lis2de_bus_queue_classify(reg, 0),
+                                   &timeout_us);
+    if (err)
+    {
+        return err;
+    }
+    err = queue->lower->ops->read(queue->lower->ctx, addr, reg,
+                                  buf, len, timeout_us);
+    lis2de_bus_queue_release(queue);
+    return err;
+}
+
+static uint8_t
+lis2de_bus_queue_write(void *ctx,
+                       uint8_t addr,
+                       uint8_t reg,
+                       const uint8_t *buf,
+                       uint8_t len,
+                       uint32_t timeout_us)
+{
+    lis2de_bus_queue_t *queue = ctx;
+    uint8_t err;
+
+    err = lis2de_bus_queue_acquire(queue, lis2de_bus_queue_classify(reg, 1),
+                                   &timeout_us);
+    if (err)
+    {
+        return err;
+    }
+    err = queue->lower->ops->write(queue->lower->ctx, addr, reg,
+                                   buf, len, timeout_us);
+    lis2de_bus_queue_release(queue);
+    return err;
+}
+
+static uint32_t
+lis2de_bus_queue_micros(void *ctx)
+{
+    lis2de_bus_queue_t *queue = ctx;
+
+    if (!queue->lower->ops->micros)
+    {
+        return 0;
+    }
+    return queue->lower->ops->micros(queue->lower->ctx);
+}
+
+// Recovery is queued with the priority of sample reads
+static void
+lis2de_bus_queue_recover(void *ctx)
+{
+    lis2de_bus_queue_t *queue = ctx;
+    uint32_t forever = 0;
+
+    if (queue->lower->ops->recover)
+    {
+        lis2de_bus_queue_acquire(queue, LIS2DE_BUS_CLASS_DATA, &forever);
+        queue->lower->ops->recover(queue->lower->ctx);
+        lis2de_bus_queue_release(queue);
+    }
+}
+
+const lis2de_bus_ops_t lis2de_bus_queue_ops =
+{
+    lis2de_bus_queue_bus_init,
+    lis2de_bus_queue_read,
+    lis2de_bus_queue_write,
+    lis2de_bus_queue_micros,
+    lis2de_bus_queue_recover
+};
+
+void
+lis2de_bus_queue_query_stats(lis2de_bus_queue_t *queue,
+                             lis2de_bus_queue_class_stats_t *stats)
+{
+    pthread_mutex_lock(&queue->lock);
+    memcpy(stats, queue->stats, sizeof(queue->stats));
+    pthread_mutex_unlock(&queue->lock);
+}
+
+void
+lis2de_bus_queue_reset_stats(lis2de_bus_queue_t *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    for (uint8_t c = 0; c < LIS2DE_BUS_CLASSES; c++)
+    {
+        // Waiting transactions are still counted in depth
+        uint32_t depth = queue->stats[c].depth;
+
+        memset(&queue->stats[c], 0, sizeof(queue->stats[c]));
+        queue->stats[c].depth = depth;
+    }
+    pthread_mutex_unlock(&queue->lock);
+}
@@ -0,0 +1,109 @@
+#ifndef LIS2DE_BUS_QUEUE_H
+#define LIS2DE_BUS_QUEUE_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "lis2de_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Prioritized transaction queue in front of a bus backend, for hosts
+ * where several tasks share one bus. Every transaction waits until the
+ * bus is free and no transaction of a more urgent class is waiting;
+ * within a class the order of arrival is kept. The class follows from
+ * the register and the direction of the transfer:
+ *
+ *   data          reads of STATUS_REG_AUX..OUT_TEMP_H, STATUS_REG2..OUT_Z
+ *                 and FIFO_SRC_REG
+ *   int_source    reads of IG1_SOURCE, IG2_SOURCE and CLICK_SRC
+ *   config        all writes and reads of the control registers
+ *   diagnostics   everything else, e.g. WHO_AM_I
+ *
+ * Strict priority is bounded: once more urgent classes have gone ahead
+ * LIS2DE_BUS_QUEUE_MAX_BYPASS times while a class was waiting, the
+ * oldest transaction of that class goes next, so configuration and
+ * diagnostics traffic still gets through a saturated data stream.
+ *
+ * The time budget of a transaction covers its wait in the queue. A
+ * transaction that used it up before it got the bus fails with
+ * E_LIS2DE_I2C_BUSY without touching the bus, the lower backend gets
+ * whatever is left of the budget.
+ *
+ * A read-modify-write of a setter is two transactions, so a sample read
+ * may run between its read and its write. The queue serializes the bus
+ * only; a device handle shared between tasks still needs its own lock
+ * around configuration calls. */
+
+// Grants to more urgent classes a waiting class lets pass before it goes
+#ifndef LIS2DE_BUS_QUEUE_MAX_BYPASS
+#define LIS2DE_BUS_QUEUE_MAX_BYPASS 8
+#endif
+
+typedef enum lis2de_bus_class
+{
+    LIS2DE_BUS_CLASS_DATA = 0,
+    LIS2DE_BUS_CLASS_INT_SOURCE,
+    LIS2DE_BUS_CLASS_CONFIG,
+    LIS2DE_BUS_CLASS_DIAGNOSTICS,
+    LIS2DE_BUS_CLASSES
+} lis2de_bus_class_t;
+
+typedef struct lis2de_bus_queue_class_stats
+{
+    uint32_t transactions;
+    // Transactions currently waiting and the most seen at once
+    uint32_t depth;
+    uint32_t max_depth;
+    // Time from arrival until the bus was granted
+    uint64_t wait_us;
+    uint32_t max_wait_us;
+    // Granted ahead of more urgent classes by the starvation bound
+    uint32_t aged;
+    // Ran out of time budget while waiting
+    uint32_t timeouts;
+} lis2de_bus_queue_class_stats_t;
+
+// A transaction waiting for the bus, lives on the stack of its thread
+typedef struct lis2de_bus_queue_waiter
+{
+    struct lis2de_bus_queue_waiter *next;
+} lis2de_bus_queue_waiter_t;
+
+typedef struct lis2de_bus_queue
+{
+    // Pass to lis2de_init() instead of the lower bus
+    lis2de_bus_t bus;
+    const lis2de_bus_t *lower;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint8_t busy;
+    // Waiting transactions per class in order of arrival
+    lis2de_bus_queue_waiter_t *head[LIS2DE_BUS_CLASSES];
+    lis2de_bus_queue_waiter_t *tail[LIS2DE_BUS_CLASSES];
+    // Grants the oldest waiter of each class has let pass
+    uint32_t bypassed[LIS2DE_BUS_CLASSES];
+
+    lis2de_bus_queue_class_stats_t stats[LIS2DE_BUS_CLASSES];
+} lis2de_bus_queue_t;
+
+extern const lis2de_bus_ops_t lis2de_bus_queue_ops;
+
+void lis2de_bus_queue_init(lis2de_bus_queue_t *queue,
+                           const lis2de_bus_t *lower);
+void lis2de_bus_queue_destroy(lis2de_bus_queue_t *queue);
+
+lis2de_bus_class_t lis2de_bus_queue_classify(uint8_t reg, uint8_t write);
+
+void lis2de_bus_queue_query_stats(lis2de_bus_queue_t *queue,
+                                  lis2de_bus_queue_class_stats_t *stats);
+void lis2de_bus_queue_reset_stats(lis2de_bus_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,165 @@
+#include "lib/lis2de-driver/include/lis2de_i2cmaster.h"
+#include "lib/lis2de-driver/include/lis2de.h"
+#include "lib/i2cmaster/include/i2cmaster.h"
+
+#include <avr/io.h>
+#include <util/delay.h>
+
+// Half an SCL period while bit-banging, about 100 kHz
+#define LIS2DE_I2CMASTER_HALF_CLOCK_US 5
+
+static uint8_t
+lis2de_i2cmaster_init(void *ctx)
+{
+    (void) ctx;
+    i2c_init();
+    return 0;
+}
+
+/* Bounded replacement of i2c_start_wait(), which spins forever on a
+ * device that never ACKs. A timeout of 0 keeps waiting forever. */
+static uint8_t
+lis2de_i2cmaster_start(uint8_t addr,
+                       uint32_t timeout_us)
+{
+    uint32_t waited = 0;
+
+    while (i2c_start(addr))
+    {
+        i2c_stop();
+        if (timeout_us && waited >= timeout_us)
+        {
+            return E_LIS2DE_I2C_TIMEOUT;
+        }
+        _delay_us(LIS2DE_I2CMASTER_POLL_US);
+        waited += LIS2DE_I2CMASTER_POLL_US;
+    }
+    return 0;
+}
+
+/* The lines are open drain, so a pin is released by switching it to an
+ * input and pulled low by driving a 0. */
+static void
+lis2de_i2cmaster_line(uint8_t pin,
+                      uint8_t high)
+{
+    if (high)
+    {
+        LIS2DE_I2CMASTER_DDR &= ~(1 << pin);
+    }
+    else
+    {
+        LIS2DE_I2CMASTER_DDR |= (1 << pin);
+    }
+    _delay_us(LIS2DE_I2CMASTER_HALF_CLOCK_US);
+}
+
+static void
+lis2de_i2cmaster_recover(void *ctx)
+{
+    (void) ctx;
+
+    TWCR = 0;
+    LIS2DE_I2CMASTER_PORT &= ~((1 << LIS2DE_I2CMASTER_SCL) |
+                               (1 << LIS2DE_I2CMASTER_SDA));
+    lis2de_i2cmaster_line(LIS2DE_I2CMASTER_SDA, 1);
+
+    // Up to nine clocks finish whatever byte the slave is sending
+    for (uint8_t pulse = 0; pulse < 9; pulse++)
+    {
+        if (LIS2DE_I2CMASTER_PIN & (1 << LIS2DE_I2CMASTER_SDA))
+        {
+            break;
+        }
+        lis2de_i2cmaster_line(LIS2DE_I2CMASTER_SCL, 0);
+        lis2de_i2cmaster_line(LIS2DE_I2CMASTER_SCL, 1);
+    }
+
+    // STOP: SDA rises while SCL is high
+    lis2de_i2cmaster_line(LIS2DE_I2CMASTER_SCL, 0);
+    lis2de_i2cmaster_line(LIS2DE_I2CMASTER_SDA, 0);
+    lis2de_i2cmaster_line(LIS2DE_I2CMASTER_SCL, 1);
+    lis2de_i2cmaster_line(LIS2DE_I2CMASTER_SDA, 1);
+
+    i2c_init();
+}
+
+static uint8_t
+lis2de_i2cmaster_read(void *ctx,
+                      uint8_t addr,
+                      uint8_t reg,
+                      uint8_t *buf,
+                      uint8_t len,
+                      uint32_t timeout_us)
+{
+    (void) ctx;
+
+    if (lis2de_i2cmaster_start(addr + I2C_WRITE, timeout_us))
+    {
+        return E_LIS2DE_I2C_TIMEOUT;
+    }
+    if (i2c_write(reg))
+    {
+        i2c_stop();
+        return E_LIS2DE_I2C_WRITE;
+    }
+    if (i2c_rep_start(addr + I2C_READ))
+    {
+        i2c_stop();
+        return E_LIS2DE_I2C_REP_START;
+    }
+    --len;
+    for (uint8_t pos = 0; pos < len; pos++)
+    {
+        buf[pos] = i2c_readAck();
+    }
+    buf[len] = i2c_readNak();
+    i2c_stop();
+    return 0;
+}
+
+static uint8_t
+lis2de_i2cmaster_write(void *ctx,
+                       uint8_t addr,
+                       uint8_t reg,
+                       const uint8_t *buf,
+                       uint8_t len,
+                       uint32_t timeout_us)
+{
+    (void) ctx;
+
+    if (lis2de_i2cmaster_start(addr + I2C_WRITE, timeout_us))
+    {
+        return E_LIS2DE_I2C_TIMEOUT;
+    }
+    if (i2c_write(reg))
+    {
+        i2c_stop();
+        return E_LIS2DE_I2C_WRITE;
+    }
+    for (uint8_t pos = 0; pos < len; pos++)
+    {
+        if (i2c_write(buf[pos]))
+        {
+            i2c_stop();
+            return E_LIS2DE_I2C_WRITE;
+        }
+    }
+    i2c_stop();
+    return 0;
+}
+
+const lis2de_bus_ops_t lis2de_i2cmaster_bus_ops =
+{
+    lis2de_i2cmaster_init,
+    lis2de_i2cmaster_read,
+    lis2de_i2cmaster_write,
+    0,
+    lis2de_i2cmaster_recover
+};
+
+const lis2de_bus_t lis2de_i2cmaster_bus =
+{
+    &lis2de_i2cmaster_bus_ops,
+    0
+};
@@ -0,0 +1,39 @@
+#ifndef LIS2DE_I2CMASTER_H
+#define LIS2DE_I2CMASTER_H
+
+#include "lis2de_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bus backend on top of Peter Fleury's i2cmaster library (AVR TWI).
+ * The library drives a single bus, so no context is needed.
+ *
+ * Addressing the device is retried until it ACKs or the time budget of
+ * the transfer is used up. Recovery disables the TWI, clocks SCL by hand
+ * until the slave releases SDA and sends a STOP. Waits inside the
+ * library for a single byte to finish remain unbounded. */
+
+// Pause between two attempts to address a busy device
+#ifndef LIS2DE_I2CMASTER_POLL_US
+#define LIS2DE_I2CMASTER_POLL_US 10
+#endif
+
+// Pins of the TWI, defaults match the ATmega328P (SCL PC5, SDA PC4)
+#ifndef LIS2DE_I2CMASTER_PORT
+#define LIS2DE_I2CMASTER_PORT PORTC
+#define LIS2DE_I2CMASTER_DDR  DDRC
+#define LIS2DE_I2CMASTER_PIN  PINC
+#define LIS2DE_I2CMASTER_SCL  PC5
+#define LIS2DE_I2CMASTER_SDA  PC4
+#endif
+
+extern const lis2de_bus_ops_t lis2de_i2cmaster_bus_ops;
+extern const lis2de_bus_t lis2de_i2cmaster_bus;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
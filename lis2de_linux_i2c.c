@@ -0,0 +1,145 @@
+#include "lib/lis2de-driver/include/lis2de_linux_i2c.h"
+#include "lib/lis2de-driver/include/lis2de.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+uint8_t
+lis2de_linux_i2c_open(lis2de_linux_i2c_t *i2c,
+                      const char *path)
+{
+    i2c->fd = open(path, O_RDWR | O_CLOEXEC);
+    i2c->timeout_us = 0;
+    if (i2c->fd < 0)
+    {
+        return E_LIS2DE_I2C_IO;
+    }
+    return 0;
+}
+
+void
+lis2de_linux_i2c_close(lis2de_linux_i2c_t *i2c)
+{
+    if (i2c->fd >= 0)
+    {
+        close(i2c->fd);
+        i2c->fd = -1;
+    }
+}
+
+// Keeps the adapter timeout in line with the driver's time budget
+static void
+lis2de_linux_i2c_set_timeout(lis2de_linux_i2c_t *i2c,
+                             uint32_t timeout_us)
+{
+    unsigned long units;
+
+    if (timeout_us == i2c->timeout_us)
+    {
+        return;
+    }
+    // Without a budget the adapter gets its default back
+    units = timeout_us ? timeout_us : LIS2DE_LINUX_I2C_ADAPTER_TIMEOUT_US;
+    // I2C_TIMEOUT counts in units of 10 ms
+    units = (units + 9999) / 10000;
+    if (ioctl(i2c->fd, I2C_TIMEOUT, units) == 0)
+    {
+        i2c->timeout_us = timeout_us;
+    }
+}
+
+static uint8_t
+lis2de_linux_i2c_transfer(lis2de_linux_i2c_t *i2c,
+                          struct i2c_rdwr_ioctl_data *xfer)
+{
+    if (ioctl(i2c->fd, I2C_RDWR, xfer) < 0)
+    {
+        return errno == ETIMEDOUT ? E_LIS2DE_I2C_TIMEOUT : E_LIS2DE_I2C_IO;
+    }
+    return 0;
+}
+
+static uint8_t
+lis2de_linux_i2c_read(void *ctx,
+                      uint8_t addr,
+                      uint8_t reg,
+                      uint8_t *buf,
+                      uint8_t len,
+                      uint32_t timeout_us)
+{
+    lis2de_linux_i2c_t *i2c = ctx;
+    struct i2c_msg msgs[2];
+    struct i2c_rdwr_ioctl_data xfer;
+
+    // i2c-dev expects the 7-bit address
+    msgs[0].addr  = addr >> 1;
+    msgs[0].flags = 0;
+    msgs[0].len   = 1;
+    msgs[0].buf   = &reg;
+
+    msgs[1].addr  = addr >> 1;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len   = len;
+    msgs[1].buf   = buf;
+
+    xfer.msgs  = msgs;
+    xfer.nmsgs = 2;
+
+    lis2de_linux_i2c_set_timeout(i2c, timeout_us);
+    return lis2de_linux_i2c_transfer(i2c, &xfer);
+}
+
+static uint8_t
+lis2de_linux_i2c_write(void *ctx,
+                       uint8_t addr,
+                       uint8_t reg,
+                       const uint8_t *buf,
+                       uint8_t len,
+                       uint32_t timeout_us)
+{
+    lis2de_linux_i2c_t *i2c = ctx;
+    uint8_t tx[1 + UINT8_MAX];
+    struct i2c_msg msg;
+    struct i2c_rdwr_ioctl_data xfer;
+
+    tx[0] = reg;
+    for (uint8_t pos = 0; pos < len; pos++)
+    {
+        tx[1 + pos] = buf[pos];
+    }
+
+    msg.addr  = addr >> 1;
+    msg.flags = 0;
+    msg.len   = 1 + len;
+    msg.buf   = tx;
+
+    xfer.msgs  = &msg;
+    xfer.nmsgs = 1;
+
+    lis2de_linux_i2c_set_timeout(i2c, timeout_us);
+    return lis2de_linux_i2c_transfer(i2c, &xfer);
+}
+
+static uint32_t
+lis2de_linux_i2c_micros(void *ctx)
+{
+    struct timespec ts;
+
+    (void) ctx;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t) ((uint64_t) ts.tv_sec * 1000000U + ts.tv_nsec / 1000);
+}
+
+const lis2de_bus_ops_t lis2de_linux_i2c_bus_ops =
+{
+    0,
+    lis2de_linux_i2c_read,
+    lis2de_linux_i2c_write,
+    lis2de_linux_i2c_micros,
+    0
+};
@@ -0,0 +1,44 @@
+#ifndef LIS2DE_LINUX_I2C_H
+#define LIS2DE_LINUX_I2C_H
+
+#include <stdint.h>
+
+#include "lis2de_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bus backend for Linux hosts using /dev/i2c-N. Every read is issued
+ * as one I2C_RDWR ioctl with a combined write-reg + repeated-start read
+ * message pair, so a whole register burst costs a single syscall.
+ *
+ * The time budget of a transfer is handed to the adapter with
+ * I2C_TIMEOUT, which has a granularity of 10 ms. Bus recovery is left
+ * to the adapter driver. */
+
+/* Adapter timeout restored for transfers without a budget. i2c-dev
+ * cannot read the timeout back, so this is the i2c core default of one
+ * second; override it for adapters whose driver sets another. */
+#ifndef LIS2DE_LINUX_I2C_ADAPTER_TIMEOUT_US
+#define LIS2DE_LINUX_I2C_ADAPTER_TIMEOUT_US 1000000UL
+#endif
+
+typedef struct lis2de_linux_i2c
+{
+    int fd;
+    // Adapter timeout last set via I2C_TIMEOUT in microseconds, 0 for the default
+    uint32_t timeout_us;
+} lis2de_linux_i2c_t;
+
+extern const lis2de_bus_ops_t lis2de_linux_i2c_bus_ops;
+
+// Returns 0 or E_LIS2DE_I2C_IO
+uint8_t lis2de_linux_i2c_open(lis2de_linux_i2c_t *i2c, const char *path);
+void lis2de_linux_i2c_close(lis2de_linux_i2c_t *i2c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,389 @@
+#include "lib/lis2de-driver/include/lis2de_poll.h"
+
+// The period estimate stays within 1/8 of the nominal one
+#define PERIOD_RANGE_SHIFT 3
+
+// Polling step while searching for the sample instant, 1/2^n period
+#define ACQUIRE_SHIFT 3
+
+/* Bound of the period error right after acquisition, 1/2^n period, and
+ * the least it is assumed to be later on */
+#define DRIFT_INIT_SHIFT 7
+#define DRIFT_MIN_SHIFT  12
+
+
+void
+lis2de_poll_init(lis2de_poll_t *poll,
+                 uint16_t odr_hz)
+{
+    poll->nominal_q8 = odr_hz ? (uint32_t) ((256000000ULL + odr_hz / 2) / odr_hz) : 0;
+    poll->period_q8 = poll->nominal_q8;
+    poll->ready_us = 0;
+    poll->ready_frac = 0;
+    poll->locked = 0;
+    poll->empty_us = 0;
+    poll->after_empty = 0;
+    poll->probing = 0;
+    poll->probe_countdown = LIS2DE_POLL_PROBE_INTERVAL;
+    poll->unbracketed = 0;
+    poll->spread_q8 = 0;
+    poll->drift_q8 = 0;
+    poll->careful = 0;
+    poll->suspect = 0;
+    poll->suspect_us = 0;
+    poll->xfer_us = 0;
+    poll->next_us = 0;
+    poll->sample_us = 0;
+    poll->temperature_interval = 0;
+    poll->temperature_countdown = 0;
+    poll->polls = 0;
+    poll->samples = 0;
+    poll->empty = 0;
+    poll->overruns = 0;
+    poll->lost = 0;
+    poll->age_us = 0;
+}
+
+void
+lis2de_poll_setup(lis2de_poll_t *poll,
+                  lis2de_dev_t *dev)
+{
+    uint8_t odr = lis2de_query_data_rate_selection(dev);
+    uint8_t low_power = lis2de_query_low_power_mode_enabled(dev);
+
+    lis2de_poll_init(poll, lis2de_data_rate_in_hz(odr, low_power));
+}
+
+void
+lis2de_poll_set_temperature_interval(lis2de_poll_t *poll,
+                                     uint16_t interval)
+{
+    poll->temperature_interval = interval;
+    poll->temperature_countdown = interval;
+}
+
+uint32_t
+lis2de_poll_next_us(const lis2de_poll_t *poll)
+{
+    return poll->next_us;
+}
+
+uint32_t
+lis2de_poll_wait_us(const lis2de_poll_t *poll,
+                    lis2de_dev_t *dev)
+{
+    int32_t wait = (int32_t) (poll->next_us - lis2de_query_micros(dev));
+
+    // Nothing is planned before the first poll
+    if (!poll->polls || wait < 0)
+    {
+        return 0;
+    }
+    return (uint32_t) wait;
+}
+
+// Q8 time relative to the reference t_us
+static int64_t
+lis2de_poll_rel(uint32_t us,
+                uint8_t frac,
+                uint32_t t_us)
+{
+    return (int64_t) (int32_t) (us - t_us) * 256 + frac;
+}
+
+// Whole microseconds of a Q8 time relative to t_us, rounded down
+static uint32_t
+lis2de_poll_floor(int64_t rel,
+                  uint32_t t_us)
+{
+    int64_t whole = rel >= 0 ? rel / 256 : -((-rel + 255) / 256);
+
+    return t_us + (uint32_t) (int32_t) whole;
+}
+
+// Same, rounded up, so a poll planned there is not early
+static uint32_t
+lis2de_poll_ceil(int64_t rel,
+                 uint32_t t_us)
+{
+    return lis2de_poll_floor(rel + 255, t_us);
+}
+
+static int64_t
+lis2de_poll_guard(const lis2de_poll_t *poll)
+{
+    int64_t guard = poll->period_q8 >> LIS2DE_POLL_GUARD_SHIFT;
+
+    if (guard < LIS2DE_POLL_MIN_GUARD_US * 256)
+    {
+        guard = LIS2DE_POLL_MIN_GUARD_US * 256;
+    }
+    // Keep the burst of a poll clear of the sample instant
+    if (guard < (int64_t) poll->xfer_us * 2 * 256)
+    {
+        guard = (int64_t) poll->xfer_us * 2 * 256;
+    }
+    if (guard > poll->period_q8 / 4)
+    {
+        guard = poll->period_q8 / 4;
+    }
+    return guard;
+}
+
+/* Fold a measured sample instant into the estimate. Part of the phase
+ * error is taken as an error of the period, since a period off by a
+ * little shows up as a phase error growing from sample to sample. The
+ * error per sample also bounds how far the phase may drift until the
+ * next measurement; the bound decays slowly, so one lucky measurement
+ * does not shrink it. */
+static void
+lis2de_poll_correct(lis2de_poll_t *poll,
+                    int64_t error)
+{
+    int64_t per_sample = error / poll->unbracketed;
+    int64_t period = poll->period_q8 + per_sample / (1 << LIS2DE_POLL_FREQ_SHIFT);
+    int64_t range = poll->nominal_q8 >> PERIOD_RANGE_SHIFT;
+    int64_t drift = poll->drift_q8 - (poll->drift_q8 >> 2);
+
+    if (period > poll->nominal_q8 + range)
+    {
+        period = poll->nominal_q8 + range;
+    }
+    if (period < poll->nominal_q8 - range)
+    {
+        period = poll->nominal_q8 - range;
+    }
+    poll->period_q8 = (uint32_t) period;
+
+    if (per_sample < 0)
+    {
+        per_sample = -per_sample;
+    }
+    if (drift < per_sample)
+    {
+        drift = per_sample;
+    }
+    if (drift < poll->nominal_q8 >> DRIFT_MIN_SHIFT)
+    {
+        drift = poll->nominal_q8 >> DRIFT_MIN_SHIFT;
+    }
+    poll->drift_q8 = (uint32_t) drift;
+}
+
+/* The poll is timestamped in the middle of its transaction. With new
+ * data and no overrun exactly one sample got ready since the last read,
+ * and if the poll before came up empty, it did so in between the two
+ * polls. Otherwise the poll only bounds the instant from above.
+ *
+ * A burst poll that comes up empty is suspect: its sample may have got
+ * ready after the status byte and been read along unflagged. If the
+ * sample does not show within the margin the poll was planned with, it
+ * did so; it counts as lost and its instant as measured. */
+uint8_t
+lis2de_poll_run(lis2de_poll_t *poll,
+                lis2de_dev_t *dev,
+                lis2de_data_t *sample)
+{
+    lis2de_status_t status;
+    uint32_t before = lis2de_query_micros(dev);
+    uint32_t t_us;
+    int64_t period = poll->period_q8;
+    int64_t acquire = period >> ACQUIRE_SHIFT;
+    int64_t guard;
+    int64_t margin;
+    int64_t predicted;
+    int64_t ready;
+    uint8_t probe = poll->probing;
+    uint8_t careful = !poll->locked || probe || poll->after_empty || poll->careful;
+    uint8_t res = 0;
+
+    if (!period)
+    {
+        poll->next_us = before + LIS2DE_POLL_IDLE_US;
+        return 0;
+    }
+
+    // Polls that may come too early look at STATUS_REG2 alone
+    if (careful)
+    {
+        status = lis2de_query_status(dev);
+        t_us = before + (lis2de_query_micros(dev) - before) / 2;
+        if (status.zyx_new_data && lis2de_try_read_sample(dev, sample, &status))
+        {
+            res |= LIS2DE_POLL_SAMPLE;
+        }
+    }
+    else
+    {
+        if (lis2de_try_read_sample(dev, sample, &status))
+        {
+            res |= LIS2DE_POLL_SAMPLE;
+        }
+        poll->xfer_us = lis2de_query_micros(dev) - before;
+        t_us = before + poll->xfer_us / 2;
+    }
+    poll->polls++;
+    poll->probing = 0;
+
+    guard = lis2de_poll_guard(poll);
+    margin = (int64_t) poll->spread_q8 + poll->drift_q8;
+    predicted = lis2de_poll_rel(poll->ready_us, poll->ready_frac, t_us) + period;
+
+    if (!(res & LIS2DE_POLL_SAMPLE))
+    {
+        poll->empty++;
+        poll->empty_us = t_us;
+        poll->after_empty = 1;
+        if (poll->locked && !careful)
+        {
+            poll->suspect = 1;
+            poll->suspect_us = before + poll->xfer_us;
+        }
+
+        if (poll->locked && poll->suspect
+            && lis2de_poll_rel(poll->suspect_us, 0, t_us) < -(guard + margin))
+        {
+            // Read unflagged during the suspect burst
+            poll->lost++;
+            poll->suspect = 0;
+            poll->after_empty = 0;
+            poll->unbracketed = 1;
+            poll->spread_q8 = poll->xfer_us * 256;
+            ready = lis2de_poll_rel(poll->suspect_us, 0, t_us) - poll->spread_q8 / 2;
+            poll->ready_us = lis2de_poll_floor(ready, t_us);
+            poll->ready_frac = (uint8_t) (ready - lis2de_poll_rel(poll->ready_us, 0, t_us));
+            poll->probing = 1;
+            poll->probe_countdown = LIS2DE_POLL_PROBE_INTERVAL;
+            poll->next_us = lis2de_poll_ceil(ready + poll->period_q8 - guard / 2
+                                             - poll->spread_q8 - poll->drift_q8, t_us);
+            return res;
+        }
+
+        // A whole period past the expected instant, the rate has changed
+        if (poll->locked && predicted + period < 0)
+        {
+            poll->locked = 0;
+            poll->suspect = 0;
+        }
+        if (!poll->locked)
+        {
+            poll->next_us = lis2de_poll_ceil(acquire, t_us);
+        }
+        else
+        {
+            poll->next_us = lis2de_poll_ceil(guard / 2, t_us);
+        }
+        return res;
+    }
+    poll->samples++;
+    poll->suspect = 0;
+
+    if (status.zyx_overrun)
+    {
+        poll->overruns++;
+        poll->locked = 0;
+        poll->unbracketed = 0;
+        ready = 0;
+    }
+    else if (poll->after_empty
+             && lis2de_poll_rel(poll->empty_us, 0, t_us) > -period)
+    {
+        int64_t empty = lis2de_poll_rel(poll->empty_us, 0, t_us);
+
+        ready = empty / 2;
+        if (poll->locked)
+        {
+            // A sample landing during an empty poll was read unflagged
+            while (ready - predicted > period / 2)
+            {
+                predicted += period;
+                poll->lost++;
+            }
+            lis2de_poll_correct(poll, ready - predicted);
+            ready = predicted + (ready - predicted) / (1 << LIS2DE_POLL_PHASE_SHIFT);
+            if (ready < empty)
+            {
+                ready = empty;
+            }
+            if (ready > 0)
+            {
+                ready = 0;
+            }
+        }
+        else
+        {
+            poll->drift_q8 = poll->nominal_q8 >> DRIFT_INIT_SHIFT;
+        }
+        poll->spread_q8 = (uint32_t) -empty;
+        poll->locked = 1;
+        poll->unbracketed = 0;
+    }
+    else if (poll->locked && probe)
+    {
+        // The sample was there before the probe, probe again
+        ready = predicted > 0 ? 0 : predicted;
+        lis2de_poll_correct(poll, ready - predicted);
+        poll->spread_q8 += poll->drift_q8;
+        poll->probe_countdown = 1;
+    }
+    else if (poll->locked)
+    {
+        ready = predicted > 0 ? 0 : predicted;
+
+        // Had one more sample got ready since, ZYXOR would be set
+        if (ready < -period)
+        {
+            ready = -period;
+        }
+        poll->spread_q8 += poll->drift_q8;
+    }
+    else
+    {
+        ready = 0;
+    }
+    poll->after_empty = 0;
+    if (poll->unbracketed < UINT16_MAX)
+    {
+        poll->unbracketed++;
+    }
+
+    poll->ready_us = lis2de_poll_floor(ready, t_us);
+    poll->ready_frac = (uint8_t) (ready - lis2de_poll_rel(poll->ready_us, 0, t_us));
+    poll->sample_us = poll->ready_us;
+    poll->age_us += t_us - poll->ready_us;
+
+    /* The next instant is known to within the spread of this one and
+     * the drift of one period. A poll whose margin would not fit in a
+     * quarter period may come early, so it reads the status first. */
+    margin = (int64_t) poll->spread_q8 + poll->drift_q8;
+    poll->careful = 0;
+    if (!poll->locked)
+    {
+        poll->next_us = lis2de_poll_ceil(acquire, t_us);
+    }
+    else if (--poll->probe_countdown == 0)
+    {
+        poll->probing = 1;
+        poll->probe_countdown = LIS2DE_POLL_PROBE_INTERVAL;
+        poll->next_us = lis2de_poll_ceil(ready + poll->period_q8 - guard / 2 - margin, t_us);
+    }
+    else
+    {
+        int64_t after = guard + margin;
+
+        if (after > (int64_t) poll->period_q8 / 4)
+        {
+            after = poll->period_q8 / 4;
+            poll->careful = 1;
+        }
+        poll->next_us = lis2de_poll_ceil(ready + poll->period_q8 + after, t_us);
+    }
+
+    if (poll->temperature_interval && --poll->temperature_countdown == 0)
+    {
+        poll->temperature = lis2de_query_temperature_data(dev);
+        poll->temperature_countdown = poll->temperature_interval;
+        res |= LIS2DE_POLL_TEMPERATURE;
+    }
+    return res;
+}
@@ -0,0 +1,158 @@
+#ifndef LIS2DE_POLL_H
+#define LIS2DE_POLL_H
+
+#include <stdint.h>
+
+#include "lis2de.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Polling scheduler for boards without the INT pin wired. It tells
+ * when to poll next so that each poll lands just after the sensor has
+ * made a new sample ready, instead of reading stale data too early or
+ * losing samples too late.
+ *
+ * The period comes from the ODR in CTRL_REG1. The instant samples get
+ * ready is found by polling in steps of 1/8 period until one poll sees
+ * no new data and the next one does. From then on a poll is planned a
+ * guard time plus the uncertainty of the estimate after the expected
+ * instant and reads STATUS_REG2 and the outputs in one burst
+ * (lis2de_try_read_sample()). The uncertainty starts at the width of
+ * the last pair of polls around the instant and grows every sample by
+ * the error of the period estimate seen in the last correction. Every
+ * few samples a probe as far ahead of the expected instant checks the
+ * phase; a probe or poll that comes up empty is retried in steps of
+ * half a guard time, and the pair of polls around the true instant
+ * corrects phase and period of the estimate. An overrun drops the lock
+ * and starts over.
+ *
+ * Polls that may come too early read STATUS_REG2 alone and fetch the
+ * sample with a second transaction, since a sample landing in a burst
+ * after its status byte would be read without ZYXDA. For the same
+ * reason the guard time is kept at twice the burst duration, and a
+ * poll whose guard and uncertainty exceed a quarter period reads the
+ * status first. Should a burst poll still come up empty and its sample
+ * not show within that margin, the sample was read unflagged; it is
+ * counted in lost and its instant taken from the burst.
+ *
+ * Times are microseconds of lis2de_query_micros(), which the bus
+ * backend must provide. Periods are kept in Q8 fixed point like in
+ * lis2de_timestamp.h. */
+
+// Guard time after the expected sample instant, 1/2^n of the period
+#ifndef LIS2DE_POLL_GUARD_SHIFT
+#define LIS2DE_POLL_GUARD_SHIFT 5
+#endif
+
+// Lower bound of the guard time, to cover the wake-up jitter
+#ifndef LIS2DE_POLL_MIN_GUARD_US
+#define LIS2DE_POLL_MIN_GUARD_US 20
+#endif
+
+// Weight of a measured phase error in the next estimate, 1/2^n
+#ifndef LIS2DE_POLL_PHASE_SHIFT
+#define LIS2DE_POLL_PHASE_SHIFT 1
+#endif
+
+// Weight of a phase error in the period estimate, 1/2^n per sample
+#ifndef LIS2DE_POLL_FREQ_SHIFT
+#define LIS2DE_POLL_FREQ_SHIFT 4
+#endif
+
+// Samples between two probe polls
+#ifndef LIS2DE_POLL_PROBE_INTERVAL
+#define LIS2DE_POLL_PROBE_INTERVAL 8
+#endif
+
+// Poll interval while the sensor is powered down
+#ifndef LIS2DE_POLL_IDLE_US
+#define LIS2DE_POLL_IDLE_US 1000000UL
+#endif
+
+// Result flags of lis2de_poll_run()
+#define LIS2DE_POLL_SAMPLE      0x01
+#define LIS2DE_POLL_TEMPERATURE 0x02
+
+typedef struct lis2de_poll
+{
+    // Nominal and estimated sample period, Q8 microseconds
+    uint32_t nominal_q8;
+    uint32_t period_q8;
+
+    // Estimated instant the last sample got ready
+    uint32_t ready_us;
+    uint8_t ready_frac;
+    uint8_t locked;
+
+    // Time of the last poll if it found no new data
+    uint32_t empty_us;
+    uint8_t after_empty;
+
+    // The next poll is a probe ahead of the expected instant
+    uint8_t probing;
+    uint8_t probe_countdown;
+
+    // Samples since the instant was last measured between two polls
+    uint16_t unbracketed;
+
+    /* Uncertainty of the estimated instant and its growth per sample
+     * from the error of the period estimate, Q8 microseconds */
+    uint32_t spread_q8;
+    uint32_t drift_q8;
+
+    // The next regular poll may come early and reads the status first
+    uint8_t careful;
+
+    // A burst poll came up empty at suspect_us, its sample may be gone
+    uint8_t suspect;
+    uint32_t suspect_us;
+
+    // Duration of the last poll transaction
+    uint32_t xfer_us;
+
+    uint32_t next_us;
+
+    // Estimated instant the sample returned by the last poll got ready
+    uint32_t sample_us;
+
+    // Temperature read after every interval samples, 0 for never
+    uint16_t temperature_interval;
+    uint16_t temperature_countdown;
+    lis2de_temperature_t temperature;
+
+    uint32_t polls;
+    uint32_t samples;
+    // Polls that found no new data
+    uint32_t empty;
+    uint32_t overruns;
+    // Samples read unflagged by a poll that raced their instant
+    uint32_t lost;
+    // Sum of the time from sample ready to poll, for the mean age
+    uint64_t age_us;
+} lis2de_poll_t;
+
+// Start over for a nominal output data rate, 0 for power-down
+void lis2de_poll_init(lis2de_poll_t *poll, uint16_t odr_hz);
+
+// Same, with the rate configured in CTRL_REG1 of the device
+void lis2de_poll_setup(lis2de_poll_t *poll, lis2de_dev_t *dev);
+
+// Read OUT_TEMP along with every interval-th sample, 0 to stop
+void lis2de_poll_set_temperature_interval(lis2de_poll_t *poll, uint16_t interval);
+
+// Time of the next poll and how long it is from now, 0 if already due
+uint32_t lis2de_poll_next_us(const lis2de_poll_t *poll);
+uint32_t lis2de_poll_wait_us(const lis2de_poll_t *poll, lis2de_dev_t *dev);
+
+/* Poll the device once and plan the next poll. Returns the
+ * LIS2DE_POLL_* flags of what was read: the sample goes to sample, a
+ * temperature reading to poll->temperature. */
+uint8_t lis2de_poll_run(lis2de_poll_t *poll, lis2de_dev_t *dev, lis2de_data_t *sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
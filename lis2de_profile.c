@@ -0,0 +1,15 @@
+#include "lib/lis2de-driver/include/lis2de_profile.h"
+
+uint8_t
+lis2de_apply_profile(lis2de_dev_t *dev,
+                     const lis2de_profile_t *profile)
+{
+    lis2de_profile_image_t img = lis2de_profile_compile(profile);
+
+    if (img.error)
+    {
+        return img.error;
+    }
+    lis2de_apply_register_image(dev, img.regs);
+    return 0;
+}
@@ -0,0 +1,311 @@
+#ifndef LIS2DE_PROFILE_H
+#define LIS2DE_PROFILE_H
+
+#include <stdint.h>
+
+#include "lis2de.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Declarative device configuration. A profile states the whole setup
+ * at once and is compiled into the byte image of TEMP_CFG_REG (0x1F) ..
+ * Act_DUR (0x3F), which lis2de_apply_register_image() then writes as a
+ * minimal diff against the device:
+ *
+ *   static const lis2de_profile_t tap = {
+ *       .odr_hz = 400, .axes = LIS2DE_AXES_XYZ, .full_scale_g = 8,
+ *       .block_data_update = 1,
+ *       .fifo_mode = LIS2DE_FIFO_STREAM, .fifo_watermark = 16,
+ *       .click = {.events = LIS2DE_CLICK_Z_SINGLE, .threshold = 40,
+ *                 .time_limit = 10},
+ *       .int1 = LIS2DE_INT1_CLICK | LIS2DE_INT1_FIFO_WATERMARK,
+ *   };
+ *
+ *   lis2de_apply_profile(&dev, &tap);
+ *
+ * The compiler is a static inline function, so a constant profile folds
+ * into a constant image. In C++ it is constexpr and a bad profile can
+ * be rejected while compiling:
+ *
+ *   constexpr lis2de_profile_image_t img = lis2de_profile_compile(&tap);
+ *   static_assert(img.error == 0, "invalid profile");
+ *
+ * Values are checked against the width of their fields, and settings
+ * that cannot work together are refused: 1.62 and 5.376 kHz without
+ * low-power mode, 1.344 kHz with it, the temperature sensor without
+ * BDU, interrupts routed from a function that has nothing enabled, FIFO
+ * interrupts with the FIFO bypassed, a FIFO trigger source outside
+ * trigger mode and 4D detection on a generator not in a 6D mode. */
+
+#ifdef __cplusplus
+#define LIS2DE_PROFILE_FN constexpr
+#else
+#define LIS2DE_PROFILE_FN static inline
+#endif
+
+// Axes, same bits as CTRL_REG1
+#define LIS2DE_AXIS_X   0x01
+#define LIS2DE_AXIS_Y   0x02
+#define LIS2DE_AXIS_Z   0x04
+#define LIS2DE_AXES_XYZ 0x07
+
+// High-pass filter modes and the paths it applies to (CTRL_REG2)
+#define LIS2DE_HPF_NORMAL     0
+#define LIS2DE_HPF_REFERENCE  1
+#define LIS2DE_HPF_AUTO_RESET 3
+
+#define LIS2DE_HPF_IG1     0x01
+#define LIS2DE_HPF_IG2     0x02
+#define LIS2DE_HPF_CLICK   0x04
+#define LIS2DE_HPF_OUTPUTS 0x08
+
+// Sources routed to INT1 (CTRL_REG3)
+#define LIS2DE_INT1_FIFO_OVERRUN   0x02
+#define LIS2DE_INT1_FIFO_WATERMARK 0x04
+#define LIS2DE_INT1_DRDY2          0x08
+#define LIS2DE_INT1_DRDY1          0x10
+#define LIS2DE_INT1_IG2            0x20
+#define LIS2DE_INT1_IG1            0x40
+#define LIS2DE_INT1_CLICK          0x80
+
+// Sources routed to INT2 (CTRL_REG6)
+#define LIS2DE_INT2_ACTIVITY 0x08
+#define LIS2DE_INT2_BOOT     0x10
+#define LIS2DE_INT2_IG2      0x20
+#define LIS2DE_INT2_IG1      0x40
+#define LIS2DE_INT2_CLICK    0x80
+
+// FIFO modes (FIFO_CTRL_REG)
+#define LIS2DE_FIFO_BYPASS         0
+#define LIS2DE_FIFO_FIFO           1
+#define LIS2DE_FIFO_STREAM         2
+#define LIS2DE_FIFO_STREAM_TO_FIFO 3
+
+// Interrupt generator modes and events (IG1_CFG/IG2_CFG)
+#define LIS2DE_IG_OR          0
+#define LIS2DE_IG_MOVEMENT_6D 1
+#define LIS2DE_IG_AND         2
+#define LIS2DE_IG_POSITION_6D 3
+
+#define LIS2DE_IG_X_LOW  0x01
+#define LIS2DE_IG_X_HIGH 0x02
+#define LIS2DE_IG_Y_LOW  0x04
+#define LIS2DE_IG_Y_HIGH 0x08
+#define LIS2DE_IG_Z_LOW  0x10
+#define LIS2DE_IG_Z_HIGH 0x20
+
+// Click events (CLICK_CFG)
+#define LIS2DE_CLICK_X_SINGLE 0x01
+#define LIS2DE_CLICK_X_DOUBLE 0x02
+#define LIS2DE_CLICK_Y_SINGLE 0x04
+#define LIS2DE_CLICK_Y_DOUBLE 0x08
+#define LIS2DE_CLICK_Z_SINGLE 0x10
+#define LIS2DE_CLICK_Z_DOUBLE 0x20
+
+// Position of a register in an image
+#define LIS2DE_IMAGE_INDEX(adr) ((adr) - 0x1F)
+
+typedef struct lis2de_profile_ig
+{
+    uint8_t mode;
+    uint8_t events;
+    // 7 bits each
+    uint8_t threshold;
+    uint8_t duration;
+    uint8_t latch;
+    // 4D instead of 6D, needs one of the 6D modes
+    uint8_t detect_4d;
+} lis2de_profile_ig_t;
+
+typedef struct lis2de_profile_click
+{
+    uint8_t events;
+    // 7 bits, like time_limit
+    uint8_t threshold;
+    uint8_t latch;
+    uint8_t time_limit;
+    uint8_t time_latency;
+    uint8_t time_window;
+} lis2de_profile_click_t;
+
+typedef struct lis2de_profile
+{
+    // 0 (power-down), 1, 10, 25, 50, 100, 200, 400, 1344, 1620 or 5376
+    uint16_t odr_hz;
+    uint8_t low_power;
+    uint8_t axes;
+    // 2, 4, 8 or 16
+    uint8_t full_scale_g;
+    uint8_t block_data_update;
+    uint8_t temperature;
+
+    uint8_t hpf_mode;
+    uint8_t hpf_cutoff;
+    uint8_t hpf_paths;
+    uint8_t reference;
+
+    uint8_t int1;
+    uint8_t int2;
+    uint8_t int_active_low;
+
+    uint8_t fifo_mode;
+    uint8_t fifo_watermark;
+    // Trigger event of LIS2DE_FIFO_STREAM_TO_FIFO from INT2 instead of INT1
+    uint8_t fifo_trigger_int2;
+
+    lis2de_profile_ig_t ig1;
+    lis2de_profile_ig_t ig2;
+    lis2de_profile_click_t click;
+
+    // 7 bits
+    uint8_t activity_threshold;
+    uint8_t activity_duration;
+} lis2de_profile_t;
+
+typedef struct lis2de_profile_image
+{
+    // TEMP_CFG_REG (0x1F) .. Act_DUR (0x3F), 0 at read-only registers
+    uint8_t regs[LIS2DE_SHADOW_SIZE];
+    // 0 or E_INVALID_PROFILE, the image is all zero then
+    uint8_t error;
+} lis2de_profile_image_t;
+
+LIS2DE_PROFILE_FN uint8_t
+lis2de_profile_ig_valid(const lis2de_profile_ig_t *ig)
+{
+    return ig->mode <= LIS2DE_IG_POSITION_6D
+           && ig->events <= 0x3F
+           && ig->threshold <= 0x7F
+           && ig->duration <= 0x7F
+           && (!ig->detect_4d || (ig->mode & LIS2DE_IG_MOVEMENT_6D));
+}
+
+LIS2DE_PROFILE_FN uint8_t
+lis2de_profile_valid(const lis2de_profile_t *p)
+{
+    uint8_t res = 1;
+
+    switch (p->odr_hz)
+    {
+    case 0: case 1: case 10: case 25: case 50: case 100: case 200: case 400:
+        break;
+    case 1344:
+        res = !p->low_power;
+        break;
+    case 1620:
+    case 5376:
+        res = p->low_power != 0;
+        break;
+    default:
+        res = 0;
+        break;
+    }
+
+    return res
+           && (p->full_scale_g == 2 || p->full_scale_g == 4 ||
+               p->full_scale_g == 8 || p->full_scale_g == 16)
+           && p->axes <= LIS2DE_AXES_XYZ
+           && (!p->temperature || p->block_data_update)
+           && p->hpf_mode <= LIS2DE_HPF_AUTO_RESET
+           && p->hpf_cutoff <= 3
+           && p->hpf_paths <= 0x0F
+           && (p->int1 & 0x01) == 0
+           && (p->int2 & 0x07) == 0
+           && p->fifo_mode <= LIS2DE_FIFO_STREAM_TO_FIFO
+           && p->fifo_watermark < LIS2DE_FIFO_DEPTH
+           && (!p->fifo_trigger_int2 || p->fifo_mode == LIS2DE_FIFO_STREAM_TO_FIFO)
+           && (p->fifo_mode != LIS2DE_FIFO_BYPASS ||
+               !(p->int1 & (LIS2DE_INT1_FIFO_WATERMARK | LIS2DE_INT1_FIFO_OVERRUN)))
+           && lis2de_profile_ig_valid(&p->ig1)
+           && lis2de_profile_ig_valid(&p->ig2)
+           && (p->ig1.events || !((p->int1 & LIS2DE_INT1_IG1) || (p->int2 & LIS2DE_INT2_IG1)))
+           && (p->ig2.events || !((p->int1 & LIS2DE_INT1_IG2) || (p->int2 & LIS2DE_INT2_IG2)))
+           && p->click.events <= 0x3F
+           && p->click.threshold <= 0x7F
+           && p->click.time_limit <= 0x7F
+           && (p->click.events || !((p->int1 & LIS2DE_INT1_CLICK) || (p->int2 & LIS2DE_INT2_CLICK)))
+           && p->activity_threshold <= 0x7F
+           && (p->activity_threshold || !(p->int2 & LIS2DE_INT2_ACTIVITY));
+}
+
+LIS2DE_PROFILE_FN lis2de_profile_image_t
+lis2de_profile_compile(const lis2de_profile_t *p)
+{
+    lis2de_profile_image_t img = {{0}, 0};
+    uint8_t odr = 0;
+    uint8_t fs = 0;
+
+    if (!lis2de_profile_valid(p))
+    {
+        img.error = E_INVALID_PROFILE;
+        return img;
+    }
+
+    switch (p->odr_hz)
+    {
+    case 1:    odr = 0b0001; break;
+    case 10:   odr = 0b0010; break;
+    case 25:   odr = 0b0011; break;
+    case 50:   odr = 0b0100; break;
+    case 100:  odr = 0b0101; break;
+    case 200:  odr = 0b0110; break;
+    case 400:  odr = 0b0111; break;
+    case 1620: odr = 0b1000; break;
+    case 1344:
+    case 5376: odr = 0b1001; break;
+    default:   odr = 0b0000; break;
+    }
+    switch (p->full_scale_g)
+    {
+    case 4:  fs = 0b01; break;
+    case 8:  fs = 0b10; break;
+    case 16: fs = 0b11; break;
+    default: fs = 0b00; break;
+    }
+
+    img.regs[LIS2DE_IMAGE_INDEX(0x1F)] = p->temperature ? 0xC0 : 0;
+    img.regs[LIS2DE_IMAGE_INDEX(0x20)] = (uint8_t) ((odr << 4) | (p->low_power ? 0x08 : 0)
+                                                    | p->axes);
+    img.regs[LIS2DE_IMAGE_INDEX(0x21)] = (uint8_t) ((p->hpf_mode << 6) | (p->hpf_cutoff << 4)
+                                                    | p->hpf_paths);
+    img.regs[LIS2DE_IMAGE_INDEX(0x22)] = p->int1;
+    img.regs[LIS2DE_IMAGE_INDEX(0x23)] = (uint8_t) ((p->block_data_update ? 0x80 : 0)
+                                                    | (fs << 4));
+    img.regs[LIS2DE_IMAGE_INDEX(0x24)] = (uint8_t) ((p->fifo_mode != LIS2DE_FIFO_BYPASS ? 0x40 : 0)
+                                                    | (p->ig1.latch ? 0x08 : 0)
+                                                    | (p->ig1.detect_4d ? 0x04 : 0)
+                                                    | (p->ig2.latch ? 0x02 : 0)
+                                                    | (p->ig2.detect_4d ? 0x01 : 0));
+    img.regs[LIS2DE_IMAGE_INDEX(0x25)] = (uint8_t) (p->int2 | (p->int_active_low ? 0x02 : 0));
+    img.regs[LIS2DE_IMAGE_INDEX(0x26)] = p->reference;
+    img.regs[LIS2DE_IMAGE_INDEX(0x2E)] = (uint8_t) ((p->fifo_mode << 6)
+                                                    | (p->fifo_trigger_int2 ? 0x20 : 0)
+                                                    | p->fifo_watermark);
+    img.regs[LIS2DE_IMAGE_INDEX(0x30)] = (uint8_t) ((p->ig1.mode << 6) | p->ig1.events);
+    img.regs[LIS2DE_IMAGE_INDEX(0x32)] = p->ig1.threshold;
+    img.regs[LIS2DE_IMAGE_INDEX(0x33)] = p->ig1.duration;
+    img.regs[LIS2DE_IMAGE_INDEX(0x34)] = (uint8_t) ((p->ig2.mode << 6) | p->ig2.events);
+    img.regs[LIS2DE_IMAGE_INDEX(0x36)] = p->ig2.threshold;
+    img.regs[LIS2DE_IMAGE_INDEX(0x37)] = p->ig2.duration;
+    img.regs[LIS2DE_IMAGE_INDEX(0x38)] = p->click.events;
+    img.regs[LIS2DE_IMAGE_INDEX(0x3A)] = (uint8_t) ((p->click.latch ? 0x80 : 0)
+                                                    | p->click.threshold);
+    img.regs[LIS2DE_IMAGE_INDEX(0x3B)] = p->click.time_limit;
+    img.regs[LIS2DE_IMAGE_INDEX(0x3C)] = p->click.time_latency;
+    img.regs[LIS2DE_IMAGE_INDEX(0x3D)] = p->click.time_window;
+    img.regs[LIS2DE_IMAGE_INDEX(0x3E)] = p->activity_threshold;
+    img.regs[LIS2DE_IMAGE_INDEX(0x3F)] = p->activity_duration;
+    return img;
+}
+
+/* Compile the profile and apply its image. Returns 0, or
+ * E_INVALID_PROFILE without touching the device. */
+uint8_t lis2de_apply_profile(lis2de_dev_t *dev, const lis2de_profile_t *profile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
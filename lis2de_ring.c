@@ -0,0 +1,173 @@
+#include "lib/lis2de-driver/include/lis2de_ring.h"
+
+/* The side owning an index reads it relaxed; the other side's index is
+ * loaded with acquire so the frames published before it are visible.
+ * On AVR the volatile index alone does not order the plain frame
+ * accesses around it, so a compiler barrier does. */
+#ifdef __AVR__
+#define RING_BARRIER()       __asm__ __volatile__("" ::: "memory")
+#define RING_LOAD(p)         (*(p))
+#define RING_ACQUIRE(p)      ({ lis2de_ring_index_t v_ = *(p); RING_BARRIER(); v_; })
+#define RING_RELEASE(p, v)   do { RING_BARRIER(); *(p) = (v); } while (0)
+#else
+#define RING_LOAD(p)         atomic_load_explicit(p, memory_order_relaxed)
+#define RING_ACQUIRE(p)      atomic_load_explicit(p, memory_order_acquire)
+#define RING_RELEASE(p, v)   atomic_store_explicit(p, v, memory_order_release)
+#endif
+
+uint8_t
+lis2de_ring_init(lis2de_ring_t *ring,
+                 lis2de_data_t *buf,
+                 lis2de_ring_index_t capacity)
+{
+    if (capacity == 0 || capacity > LIS2DE_RING_MAX_CAPACITY ||
+        (capacity & (capacity - 1)))
+    {
+        return E_INVALID_RING_CAPACITY;
+    }
+    ring->buf = buf;
+    ring->mask = capacity - 1;
+    ring->dropped = 0;
+    ring->overflow = 0;
+    ring->skipped_drains = 0;
+    RING_RELEASE(&ring->head, 0);
+    RING_RELEASE(&ring->tail, 0);
+    return 0;
+}
+
+lis2de_ring_index_t
+lis2de_ring_count(const lis2de_ring_t *ring)
+{
+    return (lis2de_ring_index_t) (RING_ACQUIRE(&ring->head) -
+                                  RING_ACQUIRE(&ring->tail));
+}
+
+lis2de_data_t *
+lis2de_ring_reserve(lis2de_ring_t *ring,
+                    lis2de_ring_index_t *count)
+{
+    lis2de_ring_index_t head = RING_LOAD(&ring->head);
+    lis2de_ring_index_t tail = RING_ACQUIRE(&ring->tail);
+    lis2de_ring_index_t space = ring->mask + 1 - (lis2de_ring_index_t) (head - tail);
+    lis2de_ring_index_t pos = head & ring->mask;
+
+    // Stop at the end of the buffer, the rest follows after the wrap
+    if (space > ring->mask + 1 - pos)
+    {
+        space = ring->mask + 1 - pos;
+    }
+    *count = space;
+    return &ring->buf[pos];
+}
+
+void
+lis2de_ring_commit(lis2de_ring_t *ring,
+                   lis2de_ring_index_t count)
+{
+    RING_RELEASE(&ring->head, RING_LOAD(&ring->head) + count);
+}
+
+uint8_t
+lis2de_ring_push(lis2de_ring_t *ring,
+                 const lis2de_data_t *sample)
+{
+    lis2de_ring_index_t count;
+    lis2de_data_t *slot = lis2de_ring_reserve(ring, &count);
+
+    if (count == 0)
+    {
+        ring->dropped++;
+        return 0;
+    }
+    *slot = *sample;
+    lis2de_ring_commit(ring, 1);
+    return 1;
+}
+
+uint8_t
+lis2de_ring_drain_fifo(lis2de_ring_t *ring,
+                       lis2de_dev_t *dev)
+{
+    lis2de_ring_index_t head = RING_LOAD(&ring->head);
+    lis2de_ring_index_t tail = RING_ACQUIRE(&ring->tail);
+    lis2de_ring_index_t space = ring->mask + 1 - (lis2de_ring_index_t) (head - tail);
+    lis2de_ring_index_t pos = head & ring->mask;
+    lis2de_ring_index_t first = ring->mask + 1 - pos;
+    lis2de_ring_index_t rest;
+    lis2de_fifo_src_t src;
+    uint8_t count;
+
+    // Nothing would fit, leave the bus alone until the consumer catches up
+    if (space == 0)
+    {
+        ring->skipped_drains++;
+        return 0;
+    }
+
+    if (first > space)
+    {
+        first = space;
+    }
+    rest = space - first;
+
+    // The FIFO never holds more than LIS2DE_FIFO_DEPTH frames
+    if (first > LIS2DE_FIFO_DEPTH)
+    {
+        first = LIS2DE_FIFO_DEPTH;
+    }
+    if (rest > LIS2DE_FIFO_DEPTH - first)
+    {
+        rest = LIS2DE_FIFO_DEPTH - first;
+    }
+
+    // Frames beyond the free space stay in the FIFO for the next drain
+    src = lis2de_query_fifo_src(dev);
+    if (src.overrun)
+    {
+        ring->overflow++;
+    }
+    count = lis2de_read_fifo_frames(dev, &src, &ring->buf[pos], (uint8_t) first,
+                                    ring->buf, (uint8_t) rest);
+    lis2de_ring_commit(ring, count);
+    return count;
+}
+
+const lis2de_data_t *
+lis2de_ring_peek(lis2de_ring_t *ring,
+                 lis2de_ring_index_t *count)
+{
+    lis2de_ring_index_t head = RING_ACQUIRE(&ring->head);
+    lis2de_ring_index_t tail = RING_LOAD(&ring->tail);
+    lis2de_ring_index_t used = (lis2de_ring_index_t) (head - tail);
+    lis2de_ring_index_t pos = tail & ring->mask;
+
+    if (used > ring->mask + 1 - pos)
+    {
+        used = ring->mask + 1 - pos;
+    }
+    *count = used;
+    return &ring->buf[pos];
+}
+
+void
+lis2de_ring_consume(lis2de_ring_t *ring,
+                    lis2de_ring_index_t count)
+{
+    RING_RELEASE(&ring->tail, RING_LOAD(&ring->tail) + count);
+}
+
+uint8_t
+lis2de_ring_pop(lis2de_ring_t *ring,
+                lis2de_data_t *sample)
+{
+    lis2de_ring_index_t count;
+    const lis2de_data_t *frame = lis2de_ring_peek(ring, &count);
+
+    if (count == 0)
+    {
+        return 0;
+    }
+    *sample = *frame;
+    lis2de_ring_consume(ring, 1);
+    return 1;
+}
@@ -0,0 +1,97 @@
+#ifndef LIS2DE_RING_H
+#define LIS2DE_RING_H
+
+#include <stdint.h>
+
+#include "lis2de.h"
+
+/* Single-producer/single-consumer ring of lis2de_data_t frames between
+ * the acquisition context (ISR or thread) and the processing code. The
+ * producer only writes head, the consumer only writes tail, so no lock
+ * is needed. Frames are decoded from the bus straight into the ring and
+ * handed to the consumer in place, without further copies.
+ *
+ * The capacity must be a power of two. On AVR the indices are single
+ * bytes, which the MCU reads and writes atomically, and the capacity is
+ * limited to 128. On hosts they are C11 atomics on separate cache lines
+ * so producer and consumer cores do not contend for the same line. */
+
+#ifdef __AVR__
+typedef uint8_t lis2de_ring_index_t;
+#define LIS2DE_RING_INDEX volatile lis2de_ring_index_t
+#define LIS2DE_RING_ALIGNED
+#define LIS2DE_RING_MAX_CAPACITY 128
+#elif defined(__cplusplus)
+// Same layout as the C11 atomics for consumers written in C++
+#include <atomic>
+typedef uint32_t lis2de_ring_index_t;
+#define LIS2DE_RING_INDEX std::atomic<lis2de_ring_index_t>
+#define LIS2DE_RING_ALIGNED alignas(64)
+#define LIS2DE_RING_MAX_CAPACITY 0x80000000UL
+#else
+#include <stdatomic.h>
+typedef uint32_t lis2de_ring_index_t;
+#define LIS2DE_RING_INDEX _Atomic lis2de_ring_index_t
+#define LIS2DE_RING_ALIGNED _Alignas(64)
+#define LIS2DE_RING_MAX_CAPACITY 0x80000000UL
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct lis2de_ring
+{
+    // Producer side
+    LIS2DE_RING_ALIGNED LIS2DE_RING_INDEX head;
+    // Frames lost because the ring was full when pushed
+    uint32_t dropped;
+    /* Drains that found the sensor FIFO overrun, each standing for one
+     * or more frames the sensor overwrote before they were read */
+    uint32_t overflow;
+    // Drains skipped without a bus transaction because the ring was full
+    uint32_t skipped_drains;
+
+    // Consumer side
+    LIS2DE_RING_ALIGNED LIS2DE_RING_INDEX tail;
+
+    LIS2DE_RING_ALIGNED lis2de_data_t *buf;
+    lis2de_ring_index_t mask;
+} lis2de_ring_t;
+
+// Returns 0 or E_INVALID_RING_CAPACITY if capacity is no power of two
+uint8_t lis2de_ring_init(lis2de_ring_t *ring,
+                         lis2de_data_t *buf,
+                         lis2de_ring_index_t capacity);
+
+lis2de_ring_index_t lis2de_ring_count(const lis2de_ring_t *ring);
+
+// Producer: store one frame, returns 0 and counts a drop when full
+uint8_t lis2de_ring_push(lis2de_ring_t *ring, const lis2de_data_t *sample);
+
+/* Producer: contiguous free slots starting at the returned pointer, to
+ * be filled in place and published with lis2de_ring_commit(). */
+lis2de_data_t *lis2de_ring_reserve(lis2de_ring_t *ring,
+                                   lis2de_ring_index_t *count);
+void lis2de_ring_commit(lis2de_ring_t *ring, lis2de_ring_index_t count);
+
+/* Producer: drain the sensor FIFO into the free space of the ring with
+ * one FIFO_SRC read and one burst per LIS2DE_FIFO_BURST_FRAMES frames.
+ * Returns the number of frames added. A full ring skips the drain
+ * without touching the bus. */
+uint8_t lis2de_ring_drain_fifo(lis2de_ring_t *ring, lis2de_dev_t *dev);
+
+/* Consumer: contiguous readable frames starting at the returned pointer,
+ * valid until released with lis2de_ring_consume(). */
+const lis2de_data_t *lis2de_ring_peek(lis2de_ring_t *ring,
+                                      lis2de_ring_index_t *count);
+void lis2de_ring_consume(lis2de_ring_t *ring, lis2de_ring_index_t count);
+
+// Consumer: copy out one frame, returns 0 when empty
+uint8_t lis2de_ring_pop(lis2de_ring_t *ring, lis2de_data_t *sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
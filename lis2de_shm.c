@@ -0,0 +1,278 @@
+#include "lib/lis2de-driver/include/lis2de_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SHM_LOAD(p)         atomic_load_explicit(p, memory_order_relaxed)
+#define SHM_ACQUIRE(p)      atomic_load_explicit(p, memory_order_acquire)
+#define SHM_RELEASE(p, v)   atomic_store_explicit(p, v, memory_order_release)
+
+// Sequence word of a slot once frame n is complete in it
+#define SLOT_SEQ(n)         ((uint32_t) ((n) * 2U + 2U))
+
+static size_t
+lis2de_shm_size(uint32_t capacity)
+{
+    return sizeof(lis2de_shm_header_t) + (size_t) capacity * sizeof(lis2de_shm_slot_t);
+}
+
+static uint8_t
+lis2de_shm_set_name(lis2de_shm_t *shm,
+                    const char *name)
+{
+    if (strlen(name) >= sizeof(shm->name))
+    {
+        errno = ENAMETOOLONG;
+        return E_LIS2DE_SHM_IO;
+    }
+    strcpy(shm->name, name);
+    return 0;
+}
+
+static void
+lis2de_shm_attach(lis2de_shm_t *shm,
+                  void *map,
+                  size_t size,
+                  uint32_t capacity)
+{
+    shm->header = map;
+    shm->slots = (lis2de_shm_slot_t *) (shm->header + 1);
+    shm->size = size;
+    shm->mask = capacity - 1;
+    shm->next = 0;
+    shm->lost = 0;
+}
+
+/* A stale object of an earlier run is removed rather than reused, so
+ * readers still mapping it are not handed a ring starting over. */
+uint8_t
+lis2de_shm_create(lis2de_shm_t *shm,
+                  const char *name,
+                  uint32_t capacity)
+{
+    size_t size = lis2de_shm_size(capacity);
+    void *map;
+    int fd;
+
+    shm->header = 0;
+    if (capacity < 2 || capacity > LIS2DE_SHM_MAX_CAPACITY ||
+        (capacity & (capacity - 1)))
+    {
+        return E_INVALID_RING_CAPACITY;
+    }
+    if (lis2de_shm_set_name(shm, name))
+    {
+        return E_LIS2DE_SHM_IO;
+    }
+
+    shm_unlink(name);
+    fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        return E_LIS2DE_SHM_IO;
+    }
+    if (ftruncate(fd, (off_t) size) < 0)
+    {
+        close(fd);
+        shm_unlink(name);
+        return E_LIS2DE_SHM_IO;
+    }
+    map = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        shm_unlink(name);
+        return E_LIS2DE_SHM_IO;
+    }
+
+    // The object comes zero-filled, so no slot holds a complete frame
+    lis2de_shm_attach(shm, map, size, capacity);
+    shm->writer = 1;
+    shm->header->version = LIS2DE_SHM_VERSION;
+    shm->header->slot_size = sizeof(lis2de_shm_slot_t);
+    shm->header->capacity = capacity;
+    shm->header->odr_hz = 0;
+    SHM_RELEASE(&shm->header->head, 0);
+    shm->header->magic = LIS2DE_SHM_MAGIC;
+    return 0;
+}
+
+void
+lis2de_shm_destroy(lis2de_shm_t *shm)
+{
+    if (shm->header)
+    {
+        munmap(shm->header, shm->size);
+        shm->header = 0;
+        shm_unlink(shm->name);
+    }
+}
+
+void
+lis2de_shm_set_odr(lis2de_shm_t *shm,
+                   uint32_t odr_hz)
+{
+    shm->header->odr_hz = odr_hz;
+}
+
+/* The sequence word goes odd before the frame is touched and even with
+ * the number of the new frame after it, so a reader copying the slot in
+ * between sees the word change. */
+void
+lis2de_shm_publish(lis2de_shm_t *shm,
+                   const lis2de_shm_frame_t *frames,
+                   uint32_t count)
+{
+    uint32_t head = SHM_LOAD(&shm->header->head);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        lis2de_shm_slot_t *slot = &shm->slots[(head + i) & shm->mask];
+        uint32_t seq = SLOT_SEQ(head + i);
+
+        atomic_store_explicit(&slot->seq, seq - 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        slot->data = frames[i].data;
+        slot->t_us = frames[i].t_us;
+        SHM_RELEASE(&slot->seq, seq);
+    }
+    SHM_RELEASE(&shm->header->head, head + count);
+}
+
+uint8_t
+lis2de_shm_open(lis2de_shm_t *shm,
+                const char *name)
+{
+    const lis2de_shm_header_t *header;
+    struct stat st;
+    void *map;
+    int fd;
+
+    shm->header = 0;
+    if (lis2de_shm_set_name(shm, name))
+    {
+        return E_LIS2DE_SHM_IO;
+    }
+    fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return E_LIS2DE_SHM_IO;
+    }
+    if (fstat(fd, &st) < 0)
+    {
+        close(fd);
+        return E_LIS2DE_SHM_IO;
+    }
+    if ((size_t) st.st_size < sizeof(lis2de_shm_header_t))
+    {
+        close(fd);
+        errno = EPROTO;
+        return E_LIS2DE_SHM_IO;
+    }
+    map = mmap(0, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return E_LIS2DE_SHM_IO;
+    }
+
+    header = map;
+    if (header->magic != LIS2DE_SHM_MAGIC ||
+        header->version != LIS2DE_SHM_VERSION ||
+        header->slot_size != sizeof(lis2de_shm_slot_t) ||
+        header->capacity < 2 || header->capacity > LIS2DE_SHM_MAX_CAPACITY ||
+        (header->capacity & (header->capacity - 1)) ||
+        (size_t) st.st_size < lis2de_shm_size(header->capacity))
+    {
+        munmap(map, (size_t) st.st_size);
+        errno = EPROTO;
+        return E_LIS2DE_SHM_IO;
+    }
+
+    lis2de_shm_attach(shm, map, (size_t) st.st_size, header->capacity);
+    shm->writer = 0;
+    shm->next = SHM_ACQUIRE(&shm->header->head);
+    return 0;
+}
+
+void
+lis2de_shm_close(lis2de_shm_t *shm)
+{
+    if (shm->header)
+    {
+        munmap(shm->header, shm->size);
+        shm->header = 0;
+    }
+}
+
+uint32_t
+lis2de_shm_available(const lis2de_shm_t *shm)
+{
+    return SHM_ACQUIRE(&shm->header->head) - shm->next;
+}
+
+// Skip the frames the writer has already overwritten
+static void
+lis2de_shm_catch_up(lis2de_shm_t *shm,
+                    uint32_t head)
+{
+    uint32_t behind = head - shm->next;
+
+    if (behind > shm->mask + 1)
+    {
+        shm->lost += behind - (shm->mask + 1);
+        shm->next = head - (shm->mask + 1);
+    }
+}
+
+/* The frame is copied with plain loads between two loads of the slot's
+ * sequence word; the fence keeps the copy ahead of the second one. */
+uint32_t
+lis2de_shm_read(lis2de_shm_t *shm,
+                lis2de_shm_frame_t *buf,
+                uint32_t max)
+{
+    uint32_t head = SHM_ACQUIRE(&shm->header->head);
+    uint32_t count = 0;
+
+    lis2de_shm_catch_up(shm, head);
+    while (count < max && shm->next != head)
+    {
+        const lis2de_shm_slot_t *slot = &shm->slots[shm->next & shm->mask];
+        uint32_t seq = SLOT_SEQ(shm->next);
+        uint32_t before = SHM_ACQUIRE(&slot->seq);
+        uint32_t after;
+
+        buf[count].data = slot->data;
+        buf[count].t_us = slot->t_us;
+        atomic_thread_fence(memory_order_acquire);
+        after = SHM_LOAD(&slot->seq);
+
+        if (before != seq || after != seq)
+        {
+            // Lapped by the writer while reading, drop what is gone
+            head = SHM_ACQUIRE(&shm->header->head);
+            shm->lost++;
+            shm->next++;
+            lis2de_shm_catch_up(shm, head);
+            continue;
+        }
+        shm->next++;
+        count++;
+    }
+    return count;
+}
+
+uint64_t
+lis2de_shm_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000U + (uint64_t) ts.tv_nsec / 1000;
+}
@@ -0,0 +1,134 @@
+#ifndef LIS2DE_SHM_H
+#define LIS2DE_SHM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lis2de.h"
+
+/* Ring of timestamped frames in POSIX shared memory, written by one
+ * process (lis2de_shmd.c) and read by any number of others. Readers
+ * never write to the mapping and take no lock, so they cannot slow the
+ * writer down nor each other, and reading costs no syscall.
+ *
+ * The writer never waits for readers: a reader falling behind by more
+ * than the capacity loses the oldest frames, which it learns from the
+ * frame sequence numbers. Every slot carries a sequence word, odd while
+ * the frame is being written and even once it is complete, seqlock
+ * style; a reader copies the frame out of the slot and keeps it only
+ * when the word was the expected even value before and after the copy.
+ * head counts the frames published so far.
+ *
+ * Sequence numbers wrap around at 2^32, so the capacity is limited to
+ * keep a lap of the ring far shorter than that. Times are microseconds
+ * of CLOCK_MONOTONIC, extended to 64 bits. */
+
+#ifdef __cplusplus
+// Same layout as the C11 atomics for readers written in C++
+#include <atomic>
+#define LIS2DE_SHM_SEQ std::atomic<uint32_t>
+#define LIS2DE_SHM_ALIGNED alignas(64)
+#else
+#include <stdatomic.h>
+#define LIS2DE_SHM_SEQ _Atomic uint32_t
+#define LIS2DE_SHM_ALIGNED _Alignas(64)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LIS2DE_SHM_MAGIC   0x4C325344UL
+#define LIS2DE_SHM_VERSION 1
+
+#define LIS2DE_SHM_MAX_CAPACITY 0x01000000UL
+
+// Object name used by the daemon unless told otherwise
+#ifndef LIS2DE_SHM_DEFAULT_NAME
+#define LIS2DE_SHM_DEFAULT_NAME "/lis2de"
+#endif
+
+typedef struct lis2de_shm_frame
+{
+    uint64_t t_us;
+    lis2de_data_t data;
+} lis2de_shm_frame_t;
+
+typedef struct lis2de_shm_slot
+{
+    LIS2DE_SHM_SEQ seq;
+    lis2de_data_t data;
+    uint8_t reserved;
+    uint64_t t_us;
+} lis2de_shm_slot_t;
+
+// Start of the shared object, followed by capacity slots
+typedef struct lis2de_shm_header
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t slot_size;
+    uint32_t capacity;
+    // Output data rate of the sensor, set before the first frame
+    uint32_t odr_hz;
+
+    // Frames published so far
+    LIS2DE_SHM_ALIGNED LIS2DE_SHM_SEQ head;
+} lis2de_shm_header_t;
+
+typedef struct lis2de_shm
+{
+    lis2de_shm_header_t *header;
+    lis2de_shm_slot_t *slots;
+    size_t size;
+    uint32_t mask;
+    uint8_t writer;
+    char name[64];
+
+    // Reader side: sequence number of the next frame to read
+    uint32_t next;
+    // Frames overwritten before this reader got to them
+    uint32_t lost;
+} lis2de_shm_t;
+
+/* Writer: create (or take over) the shared object name with room for
+ * capacity frames. Returns 0, E_INVALID_RING_CAPACITY if capacity is
+ * no power of two or E_LIS2DE_SHM_IO with errno set. */
+uint8_t lis2de_shm_create(lis2de_shm_t *shm,
+                          const char *name,
+                          uint32_t capacity);
+
+// Writer: unmap and remove the object, readers keep their mapping
+void lis2de_shm_destroy(lis2de_shm_t *shm);
+
+void lis2de_shm_set_odr(lis2de_shm_t *shm, uint32_t odr_hz);
+
+// Writer: append frames, overwriting the oldest ones
+void lis2de_shm_publish(lis2de_shm_t *shm,
+                        const lis2de_shm_frame_t *frames,
+                        uint32_t count);
+
+/* Reader: map an existing object read-only. Reading starts with the
+ * next frame published. Returns 0 or E_LIS2DE_SHM_IO with errno set,
+ * EPROTO if the object is no ring of this version. */
+uint8_t lis2de_shm_open(lis2de_shm_t *shm, const char *name);
+void lis2de_shm_close(lis2de_shm_t *shm);
+
+// Reader: frames published and not yet read, may exceed the capacity
+uint32_t lis2de_shm_available(const lis2de_shm_t *shm);
+
+/* Reader: copy up to max frames in order. Frames overwritten before
+ * they could be read are skipped and counted in shm->lost. Returns the
+ * number of frames stored in buf, 0 when there is nothing new. */
+uint32_t lis2de_shm_read(lis2de_shm_t *shm,
+                         lis2de_shm_frame_t *buf,
+                         uint32_t max);
+
+// Microseconds of CLOCK_MONOTONIC, the time base of the frames
+uint64_t lis2de_shm_now_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef LIS2DE_SHM_HPP
+#define LIS2DE_SHM_HPP
+
+#include <stdint.h>
+#include <cerrno>
+#include <system_error>
+
+#include "lis2de_shm.h"
+
+/* C++ reader of the shared-memory ring published by lis2de_shmd.c.
+ * The mapping lives as long as the reader; frames are handed to a
+ * callback in batches copied out of the ring on the stack:
+ *
+ *   lis2de::ShmReader reader;
+ *   reader.poll([](const lis2de_shm_frame_t &f) { log(f.t_us, f.data.x); });
+ *
+ * Nothing but the constructor makes a syscall. lost() tells how many
+ * frames the reader missed for falling more than a lap behind. */
+
+namespace lis2de
+{
+
+class ShmReader
+{
+public:
+    // Throws std::system_error if the ring does not exist or is no ring
+    explicit ShmReader(const char *name = LIS2DE_SHM_DEFAULT_NAME)
+    {
+        if (lis2de_shm_open(&shm_, name))
+        {
+            throw std::system_error(errno, std::generic_category(), name);
+        }
+    }
+
+    ~ShmReader() { lis2de_shm_close(&shm_); }
+
+    ShmReader(const ShmReader &) = delete;
+    ShmReader &operator=(const ShmReader &) = delete;
+
+    uint32_t odr_hz() const { return shm_.header->odr_hz; }
+    uint32_t capacity() const { return shm_.mask + 1; }
+    uint32_t available() const { return lis2de_shm_available(&shm_); }
+    uint32_t lost() const { return shm_.lost; }
+
+    uint32_t read(lis2de_shm_frame_t *buf, uint32_t max)
+    {
+        return lis2de_shm_read(&shm_, buf, max);
+    }
+
+    // Call f for every new frame in order, returns the number of frames
+    template <typename F>
+    uint32_t poll(F &&f)
+    {
+        lis2de_shm_frame_t batch[64];
+        uint32_t total = 0;
+        uint32_t count;
+
+        while ((count = read(batch, 64)) != 0)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                f(static_cast<const lis2de_shm_frame_t &>(batch[i]));
+            }
+            total += count;
+        }
+        return total;
+    }
+
+    lis2de_shm_t *handle() { return &shm_; }
+
+private:
+    lis2de_shm_t shm_;
+};
+
+}
+
+#endif
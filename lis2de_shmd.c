@@ -0,0 +1,230 @@
+/* Acquisition daemon for Linux hosts. It owns the sensor on an i2c-dev
+ * adapter, runs it in FIFO stream mode, drains the FIFO every half fill
+ * and publishes the timestamped frames into the shared-memory ring of
+ * lis2de_shm.c, from where any number of processes read them.
+ *
+ *   lis2de_shmd [-d /dev/i2c-1] [-a 0x50] [-r 400] [-n /lis2de] [-c 4096]
+ *
+ * -a takes the 8-bit address like lis2de_init(), -r one of the rates
+ * of lis2de_set_data_rate_to_*() in Hz, 1344 for the maximum, and -c
+ * the ring capacity in frames. Bus errors are logged and followed by a
+ * reconfiguration, so the daemon rides out a sensor that was reset.
+ *
+ * The driver must be built in error-code mode:
+ *
+ *   cc -DLIS2DE_USE_CEXCEPTION=0 -o lis2de_shmd lis2de_shmd.c lis2de_shm.c \
+ *      lis2de_timestamp.c lis2de_linux_i2c.c lis2de.c */
+
+#include "lib/lis2de-driver/include/lis2de.h"
+#include "lib/lis2de-driver/include/lis2de_linux_i2c.h"
+#include "lib/lis2de-driver/include/lis2de_shm.h"
+#include "lib/lis2de-driver/include/lis2de_timestamp.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if LIS2DE_USE_CEXCEPTION
+#error "lis2de_shmd needs the driver built with LIS2DE_USE_CEXCEPTION=0"
+#endif
+
+// Frames left to the FIFO between two drains, half of its depth
+#define DRAIN_FRAMES (LIS2DE_FIFO_DEPTH / 2)
+
+// Pause after a bus error before the sensor is set up again
+#define RETRY_US 100000UL
+
+static volatile sig_atomic_t stop;
+
+static void
+lis2de_shmd_signal(int sig)
+{
+    (void) sig;
+    stop = 1;
+}
+
+static void
+lis2de_shmd_sleep_us(uint32_t us)
+{
+    struct timespec ts;
+
+    ts.tv_sec = us / 1000000UL;
+    ts.tv_nsec = (long) (us % 1000000UL) * 1000;
+    // A signal cuts the sleep short, the loop then checks stop
+    nanosleep(&ts, 0);
+}
+
+typedef void (*lis2de_shmd_setter_t)(lis2de_dev_t *dev);
+
+// Setter for a rate in Hz, 0 if there is none
+static lis2de_shmd_setter_t
+lis2de_shmd_rate_setter(unsigned long odr_hz)
+{
+    switch (odr_hz)
+    {
+    case 1:    return lis2de_set_data_rate_to_1hz;
+    case 10:   return lis2de_set_data_rate_to_10hz;
+    case 25:   return lis2de_set_data_rate_to_25hz;
+    case 50:   return lis2de_set_data_rate_to_50hz;
+    case 100:  return lis2de_set_data_rate_to_100hz;
+    case 200:  return lis2de_set_data_rate_to_200hz;
+    case 400:  return lis2de_set_data_rate_to_400hz;
+    case 1344: return lis2de_set_data_rate_to_max;
+    default:   return 0;
+    }
+}
+
+/* Normal mode with BDU, all axes and the FIFO in stream mode. Going
+ * through bypass mode empties the FIFO and clears a pending overrun. */
+static void
+lis2de_shmd_configure(lis2de_dev_t *dev,
+                      lis2de_shmd_setter_t set_rate)
+{
+    lis2de_set_operating_mode_to_normal_mode(dev);
+    lis2de_disable_continuos_block_data_update(dev);
+    set_rate(dev);
+    lis2de_enable_x_axis(dev);
+    lis2de_enable_y_axis(dev);
+    lis2de_enable_z_axis(dev);
+    lis2de_enable_fifo(dev);
+    lis2de_set_fifo_mode_to_bypass_mode(dev);
+    lis2de_set_fifo_mode_to_stream_mode(dev);
+}
+
+/* Times of the driver are CLOCK_MONOTONIC microseconds cut to 32 bits
+ * by the Linux backend. A frame is at most a few drains old, so it is
+ * placed relative to a full reading of the same clock. */
+static void
+lis2de_shmd_drain(lis2de_dev_t *dev,
+                  lis2de_timestamp_t *ts,
+                  lis2de_shm_t *shm)
+{
+    lis2de_timed_data_t timed[LIS2DE_FIFO_DEPTH];
+    lis2de_shm_frame_t frames[LIS2DE_FIFO_DEPTH];
+    uint8_t count = lis2de_read_fifo_timed(dev, ts, timed, LIS2DE_FIFO_DEPTH);
+    uint64_t now = lis2de_shm_now_us();
+
+    if (lis2de_query_error(dev))
+    {
+        return;
+    }
+    for (uint8_t i = 0; i < count; i++)
+    {
+        frames[i].t_us = now - (uint32_t) ((uint32_t) now - timed[i].t_us);
+        frames[i].data = timed[i].data;
+    }
+    lis2de_shm_publish(shm, frames, count);
+}
+
+static void
+lis2de_shmd_usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-d i2c-device] [-a address] [-r rate-hz] "
+            "[-n shm-name] [-c capacity]\n", prog);
+}
+
+int
+main(int argc,
+     char **argv)
+{
+    const char *path = "/dev/i2c-1";
+    const char *name = LIS2DE_SHM_DEFAULT_NAME;
+    unsigned long addr = LIS2DE_ADDR_SA0_LOW;
+    unsigned long odr_hz = 400;
+    unsigned long capacity = 4096;
+    lis2de_linux_i2c_t i2c;
+    lis2de_bus_t bus;
+    lis2de_dev_t dev;
+    lis2de_timestamp_t ts;
+    lis2de_shm_t shm;
+    lis2de_shmd_setter_t set_rate;
+    struct sigaction sa;
+    uint32_t interval_us;
+    uint8_t err;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:a:r:n:c:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'd': path = optarg;                          break;
+        case 'a': addr = strtoul(optarg, 0, 0);           break;
+        case 'r': odr_hz = strtoul(optarg, 0, 0);         break;
+        case 'n': name = optarg;                          break;
+        case 'c': capacity = strtoul(optarg, 0, 0);       break;
+        default:
+            lis2de_shmd_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    set_rate = lis2de_shmd_rate_setter(odr_hz);
+    if (addr > 0xFE || !set_rate)
+    {
+        lis2de_shmd_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = lis2de_shmd_signal;
+    sigaction(SIGINT, &sa, 0);
+    sigaction(SIGTERM, &sa, 0);
+
+    if (lis2de_linux_i2c_open(&i2c, path))
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return EXIT_FAILURE;
+    }
+    bus.ops = &lis2de_linux_i2c_bus_ops;
+    bus.ctx = &i2c;
+    lis2de_init(&dev, &bus, (uint8_t) addr);
+
+    err = lis2de_shm_create(&shm, name, (uint32_t) capacity);
+    if (err)
+    {
+        fprintf(stderr, "%s: %s\n", name,
+                err == E_INVALID_RING_CAPACITY ? "capacity must be a power of two"
+                                               : strerror(errno));
+        lis2de_linux_i2c_close(&i2c);
+        return EXIT_FAILURE;
+    }
+
+    while (!stop)
+    {
+        lis2de_clear_error(&dev);
+        lis2de_shmd_configure(&dev, set_rate);
+        lis2de_timestamp_setup(&ts, &dev);
+        if (lis2de_query_error(&dev))
+        {
+            fprintf(stderr, "%s: setup failed with error %u\n", path,
+                    lis2de_query_error(&dev));
+            lis2de_shmd_sleep_us(RETRY_US);
+            continue;
+        }
+        lis2de_shm_set_odr(&shm, (uint32_t) odr_hz);
+
+        // At 1344 Hz a drain is due every 12 ms
+        interval_us = (uint32_t) (DRAIN_FRAMES * 1000000UL / odr_hz);
+        while (!stop)
+        {
+            lis2de_shmd_drain(&dev, &ts, &shm);
+            if (lis2de_query_error(&dev))
+            {
+                fprintf(stderr, "%s: drain failed with error %u\n", path,
+                        lis2de_query_error(&dev));
+                lis2de_shmd_sleep_us(RETRY_US);
+                break;
+            }
+            lis2de_shmd_sleep_us(interval_us);
+        }
+    }
+
+    lis2de_set_fifo_mode_to_bypass_mode(&dev);
+    lis2de_shm_destroy(&shm);
+    lis2de_linux_i2c_close(&i2c);
+    return EXIT_SUCCESS;
+}
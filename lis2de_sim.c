@@ -0,0 +1,750 @@
+#include "lib/lis2de-driver/include/lis2de_sim.h"
+
+// Register addresses, see the register map in lis2de.c
+#define SIM_STATUS_AUX    0x07
+#define SIM_OUT_TEMP_L    0x0C
+#define SIM_OUT_TEMP_H    0x0D
+#define SIM_WHO_AM_I      0x0F
+#define SIM_TEMP_CFG      0x1F
+#define SIM_CTRL_REG1     0x20
+#define SIM_CTRL_REG4     0x23
+#define SIM_CTRL_REG5     0x24
+#define SIM_STATUS_REG2   0x27
+#define SIM_OUT_FIRST     0x28
+#define SIM_OUT_X         0x29
+#define SIM_OUT_Y         0x2B
+#define SIM_OUT_Z         0x2D
+#define SIM_FIFO_CTRL     0x2E
+#define SIM_FIFO_SRC      0x2F
+#define SIM_IG1_CFG       0x30
+#define SIM_IG2_CFG       0x34
+#define SIM_CLICK_CFG     0x38
+#define SIM_CLICK_SRC     0x39
+#define SIM_CLICK_THS     0x3A
+
+// Offsets of SOURCE, THS and DURATION relative to IGx_CFG
+#define SIM_IG_SOURCE     1
+#define SIM_IG_THS        2
+#define SIM_IG_DURATION   3
+
+#define SIM_FIFO_BYPASS   0
+#define SIM_FIFO_FIFO     1
+#define SIM_FIFO_STREAM   2
+#define SIM_FIFO_TRIGGER  3
+
+static uint8_t
+lis2de_sim_is_writable(const uint8_t reg)
+{
+    return (reg >= SIM_TEMP_CFG && reg <= 0x26)
+           || reg == SIM_FIFO_CTRL
+           || reg == SIM_IG1_CFG
+           || (reg >= 0x32 && reg <= 0x34)
+           || (reg >= 0x36 && reg <= SIM_CLICK_CFG)
+           || (reg >= SIM_CLICK_THS && reg <= 0x3F);
+}
+
+static void
+lis2de_sim_reset_registers(lis2de_sim_t *sim)
+{
+    for (uint8_t reg = 0; reg < LIS2DE_SIM_REGS; reg++)
+    {
+        sim->regs[reg] = 0;
+    }
+    sim->regs[SIM_WHO_AM_I] = LIS2DE_SIM_DEVICE_ID;
+    // Power-down with all axes enabled
+    sim->regs[SIM_CTRL_REG1] = 0x07;
+
+    sim->fifo_head = 0;
+    sim->fifo_count = 0;
+    sim->fifo_triggered = 0;
+    sim->held_valid = 0;
+    sim->bdu_locked = 0;
+    sim->ig_duration_count[0] = 0;
+    sim->ig_duration_count[1] = 0;
+}
+
+void
+lis2de_sim_init(lis2de_sim_t *sim,
+                uint8_t addr)
+{
+    sim->addr = addr;
+    sim->waveform = 0;
+    sim->waveform_user = 0;
+    sim->trace = 0;
+    sim->trace_len = 0;
+    sim->sample_index = 0;
+    sim->odr_error_ppm = 0;
+    sim->temperature = 0;
+    sim->next_sample_ns = 0;
+    sim->boot_done_ns = 0;
+    sim->out.x = 0;
+    sim->out.y = 0;
+    sim->out.z = 0;
+    sim->ptr = 0;
+    sim->auto_increment = 0;
+    sim->expect_reg = 0;
+    sim->reading = 0;
+    lis2de_sim_reset_registers(sim);
+}
+
+void
+lis2de_sim_set_waveform(lis2de_sim_t *sim,
+                        lis2de_sim_waveform_t waveform,
+                        void *user)
+{
+    sim->waveform = waveform;
+    sim->waveform_user = user;
+}
+
+void
+lis2de_sim_set_trace(lis2de_sim_t *sim,
+                     const lis2de_data_t *trace,
+                     uint32_t len)
+{
+    sim->trace = trace;
+    sim->trace_len = len;
+}
+
+static uint64_t
+lis2de_sim_period_ns(const lis2de_sim_t *sim)
+{
+    uint8_t ctrl1 = sim->regs[SIM_CTRL_REG1];
+    uint16_t hz = lis2de_data_rate_in_hz(ctrl1 >> 4, (ctrl1 >> 3) & 1);
+    uint64_t period;
+
+    if (hz == 0)
+    {
+        return 0;
+    }
+    period = 1000000000ULL / hz;
+    return (period * 1000000ULL) / (uint64_t) (1000000 + sim->odr_error_ppm);
+}
+
+static uint8_t
+lis2de_sim_fifo_mode(const lis2de_sim_t *sim)
+{
+    if (!(sim->regs[SIM_CTRL_REG5] & 0x40))
+    {
+        return SIM_FIFO_BYPASS;
+    }
+    return sim->regs[SIM_FIFO_CTRL] >> 6;
+}
+
+static void
+lis2de_sim_fifo_reset(lis2de_sim_t *sim)
+{
+    sim->fifo_head = 0;
+    sim->fifo_count = 0;
+    sim->fifo_triggered = 0;
+}
+
+static void
+lis2de_sim_fifo_push(lis2de_sim_t *sim,
+                     const lis2de_data_t *sample)
+{
+    uint8_t mode = lis2de_sim_fifo_mode(sim);
+
+    if (mode == SIM_FIFO_BYPASS)
+    {
+        return;
+    }
+    // Trigger mode streams until the trigger, then behaves like FIFO mode
+    if (mode == SIM_FIFO_TRIGGER)
+    {
+        mode = sim->fifo_triggered ? SIM_FIFO_FIFO : SIM_FIFO_STREAM;
+    }
+    if (sim->fifo_count == LIS2DE_FIFO_DEPTH)
+    {
+        if (mode == SIM_FIFO_FIFO)
+        {
+            return;
+        }
+        sim->fifo_head = (sim->fifo_head + 1) % LIS2DE_FIFO_DEPTH;
+        sim->fifo_count--;
+    }
+    sim->fifo[(sim->fifo_head + sim->fifo_count) % LIS2DE_FIFO_DEPTH] = *sample;
+    sim->fifo_count++;
+}
+
+static uint8_t
+lis2de_sim_abs(const int8_t value)
+{
+    return (uint8_t) (value < 0 ? -value : value);
+}
+
+static void
+lis2de_sim_eval_ig(lis2de_sim_t *sim,
+                   const uint8_t n,
+                   const lis2de_data_t *s)
+{
+    uint8_t cfg_reg = n ? SIM_IG2_CFG : SIM_IG1_CFG;
+    uint8_t cfg = sim->regs[cfg_reg];
+    uint8_t ths = sim->regs[cfg_reg + SIM_IG_THS] & 0x7F;
+    uint8_t enabled = cfg & 0x3F;
+    uint8_t latched = sim->regs[SIM_CTRL_REG5] & (n ? 0x02 : 0x08);
+    const int8_t axis[3] = {s->x, s->y, s->z};
+    uint8_t events = 0;
+    uint8_t hit;
+    uint8_t active;
+    uint8_t src = 0;
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        if (lis2de_sim_abs(axis[i]) > ths)
+        {
+            events |= (uint8_t) (0b10 << (2 * i));
+        }
+        else
+        {
+            events |= (uint8_t) (0b01 << (2 * i));
+        }
+    }
+    hit = events & enabled;
+
+    // AOI=1, 6D=0 is AND combination; everything else is treated as OR
+    if ((cfg & 0xC0) == 0x80)
+    {
+        active = enabled && hit == enabled;
+    }
+    else
+    {
+        active = hit != 0;
+    }
+
+    if (active)
+    {
+        if (sim->ig_duration_count[n] < 0xFF)
+        {
+            sim->ig_duration_count[n]++;
+        }
+        if (sim->ig_duration_count[n] > sim->regs[cfg_reg + SIM_IG_DURATION])
+        {
+            src = 0x40 | hit;
+        }
+    }
+    else
+    {
+        sim->ig_duration_count[n] = 0;
+    }
+
+    if (src && lis2de_sim_fifo_mode(sim) == SIM_FIFO_TRIGGER
+        && ((sim->regs[SIM_FIFO_CTRL] >> 5) & 1) == n)
+    {
+        sim->fifo_triggered = 1;
+    }
+    if (!(latched && (sim->regs[cfg_reg + SIM_IG_SOURCE] & 0x40)))
+    {
+        sim->regs[cfg_reg + SIM_IG_SOURCE] = src;
+    }
+}
+
+static void
+lis2de_sim_eval_click(lis2de_sim_t *sim,
+                      const lis2de_data_t *s)
+{
+    uint8_t cfg = sim->regs[SIM_CLICK_CFG];
+    uint8_t ths = sim->regs[SIM_CLICK_THS] & 0x7F;
+    uint8_t latched = sim->regs[SIM_CLICK_THS] & 0x80;
+    const int8_t axis[3] = {s->x, s->y, s->z};
+    uint8_t src = 0;
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        // Single click enable bits: XS (0), YS (2), ZS (4)
+        if ((cfg & (1 << (2 * i))) && lis2de_sim_abs(axis[i]) > ths)
+        {
+            if (!src && axis[i] < 0)
+            {
+                src |= 0x08;
+            }
+            src |= 0x50 | (uint8_t) (1 << i);
+        }
+    }
+    if (!(latched && (sim->regs[SIM_CLICK_SRC] & 0x40)))
+    {
+        sim->regs[SIM_CLICK_SRC] = src;
+    }
+}
+
+static void
+lis2de_sim_generate(lis2de_sim_t *sim)
+{
+    lis2de_data_t s = {0};
+    uint8_t ctrl1 = sim->regs[SIM_CTRL_REG1];
+
+    if (sim->waveform)
+    {
+        sim->waveform(sim->waveform_user, sim->sample_index, &s);
+    }
+    else if (sim->trace && sim->trace_len)
+    {
+        s = sim->trace[sim->sample_index % sim->trace_len];
+    }
+    sim->sample_index++;
+
+    if (!(ctrl1 & 0x01))
+    {
+        s.x = 0;
+    }
+    if (!(ctrl1 & 0x02))
+    {
+        s.y = 0;
+    }
+    if (!(ctrl1 & 0x04))
+    {
+        s.z = 0;
+    }
+
+    // Unread data is overwritten: ZYXOR/ZOR/YOR/XOR
+    if (sim->regs[SIM_STATUS_REG2] & 0x08)
+    {
+        sim->regs[SIM_STATUS_REG2] |= 0xF0;
+    }
+    sim->regs[SIM_STATUS_REG2] |= 0x0F;
+
+    if (sim->bdu_locked)
+    {
+        sim->held = s;
+        sim->held_valid = 1;
+    }
+    else
+    {
+        sim->out = s;
+    }
+
+    lis2de_sim_eval_ig(sim, 0, &s);
+    lis2de_sim_eval_ig(sim, 1, &s);
+    lis2de_sim_eval_click(sim, &s);
+    lis2de_sim_fifo_push(sim, &s);
+
+    if ((sim->regs[SIM_TEMP_CFG] & 0xC0) == 0xC0)
+    {
+        // TOR if TDA was still set, then TDA
+        if (sim->regs[SIM_STATUS_AUX] & 0x04)
+        {
+            sim->regs[SIM_STATUS_AUX] |= 0x40;
+        }
+        sim->regs[SIM_STATUS_AUX] |= 0x04;
+        sim->regs[SIM_OUT_TEMP_L] = 0;
+        sim->regs[SIM_OUT_TEMP_H] = (uint8_t) sim->temperature;
+    }
+}
+
+static void
+lis2de_sim_advance(lis2de_sim_t *sim,
+                   uint64_t now)
+{
+    uint64_t period;
+
+    if (sim->boot_done_ns && now >= sim->boot_done_ns)
+    {
+        sim->regs[SIM_CTRL_REG5] &= (uint8_t) ~0x80;
+        sim->boot_done_ns = 0;
+    }
+
+    period = lis2de_sim_period_ns(sim);
+    if (period == 0)
+    {
+        return;
+    }
+    while (sim->next_sample_ns <= now)
+    {
+        lis2de_sim_generate(sim);
+        sim->next_sample_ns += period;
+    }
+}
+
+static void
+lis2de_sim_write_register(lis2de_sim_t *sim,
+                          const uint8_t reg,
+                          const uint8_t val,
+                          const uint64_t now)
+{
+    uint8_t old = sim->regs[reg];
+
+    if (!lis2de_sim_is_writable(reg))
+    {
+        return;
+    }
+    sim->regs[reg] = val;
+
+    if (reg == SIM_CTRL_REG1 && (old & 0xF8) != (val & 0xF8))
+    {
+        sim->next_sample_ns = now + lis2de_sim_period_ns(sim);
+    }
+    else if (reg == SIM_CTRL_REG5)
+    {
+        if (val & 0x80)
+        {
+            lis2de_sim_reset_registers(sim);
+            sim->regs[SIM_CTRL_REG5] = 0x80;
+            sim->boot_done_ns = now + LIS2DE_SIM_BOOT_NS;
+        }
+        else if (!(val & 0x40))
+        {
+            lis2de_sim_fifo_reset(sim);
+        }
+    }
+    else if (reg == SIM_FIFO_CTRL && (old & 0xC0) != (val & 0xC0))
+    {
+        lis2de_sim_fifo_reset(sim);
+    }
+}
+
+static uint8_t
+lis2de_sim_read_register(lis2de_sim_t *sim,
+                         const uint8_t reg)
+{
+    uint8_t fifo_active = lis2de_sim_fifo_mode(sim) != SIM_FIFO_BYPASS;
+    uint8_t val = sim->regs[reg];
+    const lis2de_data_t *frame = &sim->out;
+
+    if (reg >= SIM_OUT_FIRST && reg <= SIM_OUT_Z)
+    {
+        if (fifo_active && sim->fifo_count)
+        {
+            frame = &sim->fifo[sim->fifo_head];
+        }
+        switch (reg)
+        {
+            case SIM_OUT_X: val = (uint8_t) frame->x; break;
+            case SIM_OUT_Y: val = (uint8_t) frame->y; break;
+            case SIM_OUT_Z: val = (uint8_t) frame->z; break;
+            default:        val = 0; break;
+        }
+
+        if (fifo_active)
+        {
+            if (reg == SIM_OUT_Z && sim->fifo_count)
+            {
+                sim->fifo_head = (sim->fifo_head + 1) % LIS2DE_FIFO_DEPTH;
+                sim->fifo_count--;
+            }
+        }
+        else if (reg == SIM_OUT_X && (sim->regs[SIM_CTRL_REG4] & 0x80))
+        {
+            sim->bdu_locked = 1;
+        }
+        else if (reg == SIM_OUT_Z)
+        {
+            sim->regs[SIM_STATUS_REG2] = 0;
+            sim->bdu_locked = 0;
+            if (sim->held_valid)
+            {
+                sim->out = sim->held;
+                sim->held_valid = 0;
+                sim->regs[SIM_STATUS_REG2] = 0x0F;
+            }
+        }
+        return val;
+    }
+
+    switch (reg)
+    {
+        case SIM_OUT_TEMP_H:
+            sim->regs[SIM_STATUS_AUX] = 0;
+            break;
+        case SIM_FIFO_SRC:
+            val = 0;
+            if (sim->fifo_count > (sim->regs[SIM_FIFO_CTRL] & 0x1F))
+            {
+                val |= 0x80;
+            }
+            if (sim->fifo_count == LIS2DE_FIFO_DEPTH)
+            {
+                val |= 0x40 | (LIS2DE_FIFO_DEPTH - 1);
+            }
+            else
+            {
+                val |= sim->fifo_count;
+            }
+            if (sim->fifo_count == 0)
+            {
+                val |= 0x20;
+            }
+            break;
+        case SIM_IG1_CFG + SIM_IG_SOURCE:
+            if (sim->regs[SIM_CTRL_REG5] & 0x08)
+            {
+                sim->regs[reg] = 0;
+            }
+            break;
+        case SIM_IG2_CFG + SIM_IG_SOURCE:
+            if (sim->regs[SIM_CTRL_REG5] & 0x02)
+            {
+                sim->regs[reg] = 0;
+            }
+            break;
+        case SIM_CLICK_SRC:
+            if (sim->regs[SIM_CLICK_THS] & 0x80)
+            {
+                sim->regs[reg] = 0;
+            }
+            break;
+        default:
+            break;
+    }
+    return val;
+}
+
+static void
+lis2de_sim_next_ptr(lis2de_sim_t *sim)
+{
+    if (!sim->auto_increment)
+    {
+        return;
+    }
+    // With the FIFO enabled the pointer rolls over from OUT_Z to 0x28
+    if (sim->ptr == SIM_OUT_Z && lis2de_sim_fifo_mode(sim) != SIM_FIFO_BYPASS)
+    {
+        sim->ptr = SIM_OUT_FIRST;
+    }
+    else
+    {
+        sim->ptr = (sim->ptr + 1) % LIS2DE_SIM_REGS;
+    }
+}
+
+void
+lis2de_sim_bus_init(lis2de_sim_bus_t *bus,
+                    uint32_t scl_hz)
+{
+    bus->count = 0;
+    bus->selected = 0;
+    bus->busy = 0;
+    bus->stuck = 0;
+    bus->scl_hz = scl_hz;
+    bus->now_ns = 0;
+    bus->transactions = 0;
+    bus->bytes = 0;
+}
+
+void
+lis2de_sim_bus_attach(lis2de_sim_bus_t *bus,
+                      lis2de_sim_t *sim)
+{
+    if (bus->count < LIS2DE_SIM_MAX_DEVICES)
+    {
+        bus->devs[bus->count++] = sim;
+        sim->next_sample_ns = bus->now_ns + lis2de_sim_period_ns(sim);
+    }
+}
+
+void
+lis2de_sim_bus_advance(lis2de_sim_bus_t *bus,
+                       uint64_t ns)
+{
+    bus->now_ns += ns;
+    for (uint8_t i = 0; i < bus->count; i++)
+    {
+        lis2de_sim_advance(bus->devs[i], bus->now_ns);
+    }
+}
+
+// Duration of bits on the bus at the configured SCL rate
+static void
+lis2de_sim_bus_clock(lis2de_sim_bus_t *bus,
+                     uint8_t bits)
+{
+    lis2de_sim_bus_advance(bus, (1000000000ULL * bits) / bus->scl_hz);
+}
+
+uint8_t
+lis2de_sim_bus_start(lis2de_sim_bus_t *bus,
+                     uint8_t addr_rw)
+{
+    if (!bus->busy)
+    {
+        bus->busy = 1;
+        bus->transactions++;
+    }
+    // START condition plus the address byte
+    lis2de_sim_bus_clock(bus, 1 + 9);
+    bus->bytes++;
+
+    bus->selected = 0;
+    for (uint8_t i = 0; i < bus->count; i++)
+    {
+        if (bus->devs[i]->addr == (addr_rw & 0xFE))
+        {
+            bus->selected = bus->devs[i];
+        }
+    }
+    if (!bus->selected)
+    {
+        return 0;
+    }
+    bus->selected->reading = addr_rw & 1;
+    bus->selected->expect_reg = !bus->selected->reading;
+    return 1;
+}
+
+uint8_t
+lis2de_sim_bus_write_byte(lis2de_sim_bus_t *bus,
+                          uint8_t data)
+{
+    lis2de_sim_t *sim = bus->selected;
+
+    lis2de_sim_bus_clock(bus, 9);
+    bus->bytes++;
+
+    if (!sim || sim->reading)
+    {
+        return 0;
+    }
+    if (sim->expect_reg)
+    {
+        sim->ptr = data & 0x7F;
+        sim->auto_increment = data >> 7;
+        sim->expect_reg = 0;
+    }
+    else
+    {
+        lis2de_sim_write_register(sim, sim->ptr, data, bus->now_ns);
+        lis2de_sim_next_ptr(sim);
+    }
+    return 1;
+}
+
+uint8_t
+lis2de_sim_bus_read_byte(lis2de_sim_bus_t *bus,
+                         uint8_t ack)
+{
+    lis2de_sim_t *sim = bus->selected;
+    uint8_t val;
+
+    (void) ack;
+    lis2de_sim_bus_clock(bus, 9);
+    bus->bytes++;
+
+    if (!sim || !sim->reading)
+    {
+        return 0xFF;
+    }
+    val = lis2de_sim_read_register(sim, sim->ptr);
+    lis2de_sim_next_ptr(sim);
+    return val;
+}
+
+void
+lis2de_sim_bus_stop(lis2de_sim_bus_t *bus)
+{
+    lis2de_sim_bus_clock(bus, 1);
+    bus->selected = 0;
+    bus->busy = 0;
+}
+
+void
+lis2de_sim_bus_set_stuck(lis2de_sim_bus_t *bus,
+                         uint8_t stuck)
+{
+    bus->stuck = stuck;
+}
+
+/* A hung bus burns the whole time budget before the transfer gives up.
+ * Without a budget the real bus would hang forever, the model still
+ * returns so the caller can observe it. */
+static uint8_t
+lis2de_sim_bus_stalled(lis2de_sim_bus_t *bus,
+                       uint32_t timeout_us)
+{
+    if (!bus->stuck)
+    {
+        return 0;
+    }
+    bus->transactions++;
+    lis2de_sim_bus_advance(bus, (uint64_t) timeout_us * 1000);
+    return 1;
+}
+
+static uint8_t
+lis2de_sim_bus_read(void *ctx,
+                    uint8_t addr,
+                    uint8_t reg,
+                    uint8_t *buf,
+                    uint8_t len,
+                    uint32_t timeout_us)
+{
+    lis2de_sim_bus_t *bus = ctx;
+    uint8_t err = 0;
+
+    if (lis2de_sim_bus_stalled(bus, timeout_us))
+    {
+        return E_LIS2DE_I2C_TIMEOUT;
+    }
+    if (!lis2de_sim_bus_start(bus, addr) || !lis2de_sim_bus_write_byte(bus, reg))
+    {
+        err = E_LIS2DE_I2C_WRITE;
+    }
+    else if (!lis2de_sim_bus_start(bus, addr | 1))
+    {
+        err = E_LIS2DE_I2C_REP_START;
+    }
+    else
+    {
+        for (uint8_t pos = 0; pos < len; pos++)
+        {
+            buf[pos] = lis2de_sim_bus_read_byte(bus, pos + 1 < len);
+        }
+    }
+    lis2de_sim_bus_stop(bus);
+    return err;
+}
+
+static uint8_t
+lis2de_sim_bus_write(void *ctx,
+                     uint8_t addr,
+                     uint8_t reg,
+                     const uint8_t *buf,
+                     uint8_t len,
+                     uint32_t timeout_us)
+{
+    lis2de_sim_bus_t *bus = ctx;
+    uint8_t err = 0;
+
+    if (lis2de_sim_bus_stalled(bus, timeout_us))
+    {
+        return E_LIS2DE_I2C_TIMEOUT;
+    }
+    if (!lis2de_sim_bus_start(bus, addr) || !lis2de_sim_bus_write_byte(bus, reg))
+    {
+        err = E_LIS2DE_I2C_WRITE;
+    }
+    for (uint8_t pos = 0; !err && pos < len; pos++)
+    {
+        if (!lis2de_sim_bus_write_byte(bus, buf[pos]))
+        {
+            err = E_LIS2DE_I2C_WRITE;
+        }
+    }
+    lis2de_sim_bus_stop(bus);
+    return err;
+}
+
+static uint32_t
+lis2de_sim_bus_micros(void *ctx)
+{
+    lis2de_sim_bus_t *bus = ctx;
+    return (uint32_t) (bus->now_ns / 1000);
+}
+
+// Nine SCL pulses and a STOP release the slave
+static void
+lis2de_sim_bus_recover(void *ctx)
+{
+    lis2de_sim_bus_t *bus = ctx;
+
+    lis2de_sim_bus_clock(bus, 9 + 1);
+    bus->stuck = 0;
+    bus->selected = 0;
+    bus->busy = 0;
+}
+
+const lis2de_bus_ops_t lis2de_sim_bus_ops =
+{
+    0,
+    lis2de_sim_bus_read,
+    lis2de_sim_bus_write,
+    lis2de_sim_bus_micros,
+    lis2de_sim_bus_recover
+};
@@ -0,0 +1,127 @@
+#ifndef LIS2DE_SIM_H
+#define LIS2DE_SIM_H
+
+#include <stdint.h>
+
+#include "lis2de.h"
+#include "lis2de_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Register-level model of the LIS2DE for host-side testing and
+ * benchmarking. It implements the register map of lis2de.c including
+ * auto-increment, BDU, the 32-slot FIFO in bypass/FIFO/stream/trigger
+ * mode, latched IG1/IG2/click sources and ODR-driven sample generation
+ * from a waveform callback or a recorded trace.
+ *
+ * Simplifications: 6D recognition is evaluated like OR combination,
+ * only single clicks are detected and the activity function is not
+ * modelled. Thresholds are compared against raw output counts.
+ *
+ * Devices are attached to a simulated bus that keeps a virtual clock.
+ * Every transaction advances the clock by its duration at the bus SCL
+ * rate, so runs are fully deterministic. */
+
+#define LIS2DE_SIM_REGS        0x40
+#define LIS2DE_SIM_MAX_DEVICES 4
+
+// WHO_AM_I (0x0F) content of a LIS2DE
+#define LIS2DE_SIM_DEVICE_ID   0x33
+
+// Time the device needs to reload its registers after BOOT
+#define LIS2DE_SIM_BOOT_NS     5000000ULL
+
+typedef void (*lis2de_sim_waveform_t)(void *user,
+                                      uint32_t index,
+                                      lis2de_data_t *sample);
+
+typedef struct lis2de_sim
+{
+    uint8_t addr;
+    uint8_t regs[LIS2DE_SIM_REGS];
+
+    // Sample source, the trace is replayed in a loop
+    lis2de_sim_waveform_t waveform;
+    void *waveform_user;
+    const lis2de_data_t *trace;
+    uint32_t trace_len;
+    uint32_t sample_index;
+
+    // Deviation of the true ODR from the nominal one
+    int32_t odr_error_ppm;
+    int8_t temperature;
+
+    uint64_t next_sample_ns;
+    uint64_t boot_done_ns;
+
+    // Output registers and the sample held back while BDU blocks them
+    lis2de_data_t out;
+    lis2de_data_t held;
+    uint8_t held_valid;
+    uint8_t bdu_locked;
+
+    lis2de_data_t fifo[LIS2DE_FIFO_DEPTH];
+    uint8_t fifo_head;
+    uint8_t fifo_count;
+    uint8_t fifo_triggered;
+
+    uint8_t ig_duration_count[2];
+
+    // Transaction state
+    uint8_t ptr;
+    uint8_t auto_increment;
+    uint8_t expect_reg;
+    uint8_t reading;
+} lis2de_sim_t;
+
+typedef struct lis2de_sim_bus
+{
+    lis2de_sim_t *devs[LIS2DE_SIM_MAX_DEVICES];
+    uint8_t count;
+    lis2de_sim_t *selected;
+    uint8_t busy;
+
+    // A slave holding SDA low, every transfer times out until recovered
+    uint8_t stuck;
+
+    uint32_t scl_hz;
+    uint64_t now_ns;
+
+    // Traffic seen on the bus
+    uint32_t transactions;
+    uint32_t bytes;
+} lis2de_sim_bus_t;
+
+extern const lis2de_bus_ops_t lis2de_sim_bus_ops;
+
+void lis2de_sim_init(lis2de_sim_t *sim, uint8_t addr);
+void lis2de_sim_set_waveform(lis2de_sim_t *sim,
+                             lis2de_sim_waveform_t waveform,
+                             void *user);
+void lis2de_sim_set_trace(lis2de_sim_t *sim,
+                          const lis2de_data_t *trace,
+                          uint32_t len);
+
+void lis2de_sim_bus_init(lis2de_sim_bus_t *bus, uint32_t scl_hz);
+void lis2de_sim_bus_attach(lis2de_sim_bus_t *bus, lis2de_sim_t *sim);
+
+// Let virtual time pass without bus traffic
+void lis2de_sim_bus_advance(lis2de_sim_bus_t *bus, uint64_t ns);
+
+/* Byte-level bus access, e.g. for a TWI peripheral model. addr_rw is
+ * the 8-bit address including the R/W bit. Return 1 on ACK. */
+uint8_t lis2de_sim_bus_start(lis2de_sim_bus_t *bus, uint8_t addr_rw);
+uint8_t lis2de_sim_bus_write_byte(lis2de_sim_bus_t *bus, uint8_t data);
+uint8_t lis2de_sim_bus_read_byte(lis2de_sim_bus_t *bus, uint8_t ack);
+void lis2de_sim_bus_stop(lis2de_sim_bus_t *bus);
+
+// Hang the bus to exercise timeout and recovery handling
+void lis2de_sim_bus_set_stuck(lis2de_sim_bus_t *bus, uint8_t stuck);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,86 @@
+#include "lib/lis2de-driver/include/lis2de_snapshot.h"
+
+#include <stdio.h>
+
+// Register names from 0x07, 0 for reserved registers
+static const char *const NAMES[LIS2DE_REGISTERS - LIS2DE_SNAPSHOT_STATUS_FIRST] =
+{
+    "STATUS_REG_AUX", 0, 0, 0, 0, "OUT_TEMP_L", "OUT_TEMP_H", "INT_COUNTER_REG",
+    "WHO_AM_I", 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, "TEMP_CFG_REG",
+    "CTRL_REG1", "CTRL_REG2", "CTRL_REG3", "CTRL_REG4",
+    "CTRL_REG5", "CTRL_REG6", "REFERENCE", "STATUS_REG2",
+    0, "OUT_X_H", 0, "OUT_Y_H", 0, "OUT_Z_H", "FIFO_CTRL_REG", "FIFO_SRC_REG",
+    "IG1_CFG", "IG1_SOURCE", "IG1_THS", "IG1_DURATION",
+    "IG2_CFG", "IG2_SOURCE", "IG2_THS", "IG2_DURATION",
+    "CLICK_CFG", "CLICK_SRC", "CLICK_THS", "TIME_LIMIT",
+    "TIME_LATENCY", "TIME_WINDOW", "Act_THS", "Act_DUR"
+};
+
+void
+lis2de_snapshot_dump(lis2de_dev_t *dev,
+                     lis2de_snapshot_t *snap)
+{
+    lis2de_read_registers(dev, LIS2DE_SNAPSHOT_STATUS_FIRST, snap->status,
+                          LIS2DE_SNAPSHOT_STATUS_SIZE);
+    lis2de_read_registers(dev, LIS2DE_SNAPSHOT_CONFIG_FIRST, snap->config,
+                          LIS2DE_SHADOW_SIZE);
+}
+
+void
+lis2de_snapshot_restore(lis2de_dev_t *dev,
+                        const lis2de_snapshot_t *snap)
+{
+    lis2de_restore_register_image(dev, snap->config);
+}
+
+uint8_t
+lis2de_snapshot_register(const lis2de_snapshot_t *snap,
+                         uint8_t adr)
+{
+    uint8_t res = 0;
+
+    if (adr >= LIS2DE_SNAPSHOT_STATUS_FIRST
+        && adr < LIS2DE_SNAPSHOT_STATUS_FIRST + LIS2DE_SNAPSHOT_STATUS_SIZE)
+    {
+        res = snap->status[adr - LIS2DE_SNAPSHOT_STATUS_FIRST];
+    }
+    else if (adr >= LIS2DE_SNAPSHOT_CONFIG_FIRST
+             && adr < LIS2DE_SNAPSHOT_CONFIG_FIRST + LIS2DE_SHADOW_SIZE)
+    {
+        res = snap->config[adr - LIS2DE_SNAPSHOT_CONFIG_FIRST];
+    }
+    return res;
+}
+
+int
+lis2de_snapshot_format(const lis2de_snapshot_t *snap,
+                       char *buf,
+                       size_t size)
+{
+    size_t len = 0;
+
+    if (size > 0)
+    {
+        buf[0] = '\0';
+    }
+    for (uint8_t adr = LIS2DE_SNAPSHOT_STATUS_FIRST; adr < LIS2DE_REGISTERS; adr++)
+    {
+        const char *name = NAMES[adr - LIS2DE_SNAPSHOT_STATUS_FIRST];
+        int n;
+
+        if (!name)
+        {
+            continue;
+        }
+        n = snprintf(len < size ? buf + len : 0, len < size ? size - len : 0,
+                     "0x%02X %-15s 0x%02X\n", adr, name,
+                     lis2de_snapshot_register(snap, adr));
+        if (n < 0)
+        {
+            return n;
+        }
+        len += (size_t) n;
+    }
+    return (int) len;
+}
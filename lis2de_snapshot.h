@@ -0,0 +1,58 @@
+#ifndef LIS2DE_SNAPSHOT_H
+#define LIS2DE_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lis2de.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Snapshot of the whole readable register map for diagnostics and
+ * recovery, taken with two auto-increment bursts: STATUS_REG_AUX (0x07)
+ * .. WHO_AM_I (0x0F) and TEMP_CFG_REG (0x1F) .. Act_DUR (0x3F), plus a
+ * third from FIFO_CTRL_REG on while the FIFO is enabled. The struct
+ * holds bytes only, so it is its own compact binary form of
+ * LIS2DE_SNAPSHOT_SIZE bytes, e.g. for storing in EEPROM.
+ *
+ * The registers are read like their queries do: latched IG1/IG2/click
+ * sources are cleared, and in FIFO mode the output registers hand out
+ * frames, which are lost to the stream. With the shadow enabled, the
+ * dump resyncs it as well. */
+
+#define LIS2DE_SNAPSHOT_STATUS_FIRST 0x07
+#define LIS2DE_SNAPSHOT_STATUS_SIZE  (0x0F - 0x07 + 1)
+#define LIS2DE_SNAPSHOT_CONFIG_FIRST 0x1F
+#define LIS2DE_SNAPSHOT_SIZE         (LIS2DE_SNAPSHOT_STATUS_SIZE + LIS2DE_SHADOW_SIZE)
+
+typedef struct lis2de_snapshot
+{
+    // STATUS_REG_AUX (0x07) .. WHO_AM_I (0x0F)
+    uint8_t status[LIS2DE_SNAPSHOT_STATUS_SIZE];
+    // TEMP_CFG_REG (0x1F) .. Act_DUR (0x3F), laid out like a profile image
+    uint8_t config[LIS2DE_SHADOW_SIZE];
+} lis2de_snapshot_t;
+
+void lis2de_snapshot_dump(lis2de_dev_t *dev, lis2de_snapshot_t *snap);
+
+/* Write the writable registers of the snapshot back with one burst per
+ * run of writable registers, whatever the shadow says, so it also
+ * serves after the device lost its state. The read-only source
+ * registers between the runs are not written. BOOT is never written. */
+void lis2de_snapshot_restore(lis2de_dev_t *dev, const lis2de_snapshot_t *snap);
+
+// Value of a register in the snapshot, 0 for those it does not cover
+uint8_t lis2de_snapshot_register(const lis2de_snapshot_t *snap, uint8_t adr);
+
+/* One line per register, e.g. "0x20 CTRL_REG1      0x57". Reserved
+ * registers are left out. Returns the length of the full text like
+ * snprintf(); the output is cut to size - 1 characters. */
+int lis2de_snapshot_format(const lis2de_snapshot_t *snap, char *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,141 @@
+#include "lib/lis2de-driver/include/lis2de_startup.h"
+
+// Bus errors are thrown with CException, recorded otherwise
+static uint8_t
+lis2de_startup_error(lis2de_dev_t *dev)
+{
+#if LIS2DE_USE_CEXCEPTION
+    (void) dev;
+    return 0;
+#else
+    return lis2de_query_error(dev);
+#endif
+}
+
+static uint8_t
+lis2de_startup_expired(lis2de_dev_t *dev,
+                       const uint32_t since,
+                       const uint32_t timeout_us,
+                       const uint16_t polls)
+{
+    if (dev->bus->ops->micros)
+    {
+        return lis2de_query_micros(dev) - since > timeout_us;
+    }
+    return polls >= LIS2DE_STARTUP_MAX_POLLS;
+}
+
+static uint8_t
+lis2de_startup_run(lis2de_dev_t *dev,
+                   const lis2de_profile_t *profile,
+                   const uint8_t reboot,
+                   const uint32_t start,
+                   lis2de_startup_report_t *report)
+{
+    uint32_t since;
+    uint32_t timeout_us;
+    uint16_t polls;
+    uint8_t err;
+
+    if (!lis2de_profile_valid(profile))
+    {
+        return E_INVALID_PROFILE;
+    }
+
+    report->device_id = lis2de_query_device_id(dev);
+    if ((err = lis2de_startup_error(dev)))
+    {
+        return err;
+    }
+    if (report->device_id != LIS2DE_DEVICE_ID)
+    {
+        return E_UNKNOWN_DEVICE;
+    }
+
+    if (reboot)
+    {
+        lis2de_reboot_memory_content(dev);
+        since = lis2de_query_micros(dev);
+        polls = 0;
+        for (;;)
+        {
+            uint8_t booting = lis2de_query_boot_in_progress(dev);
+
+            report->polls++;
+            polls++;
+            if ((err = lis2de_startup_error(dev)))
+            {
+                return err;
+            }
+            if (!booting)
+            {
+                break;
+            }
+            if (lis2de_startup_expired(dev, since, LIS2DE_STARTUP_BOOT_TIMEOUT_US, polls))
+            {
+                return E_STARTUP_TIMEOUT;
+            }
+        }
+        report->boot_us = lis2de_query_micros(dev) - start;
+    }
+    else
+    {
+        lis2de_data_t stale;
+
+        // A sample of the old configuration must not count as the first
+        lis2de_try_read_sample(dev, &stale, 0);
+    }
+
+    if ((err = lis2de_apply_profile(dev, profile)) || (err = lis2de_startup_error(dev)))
+    {
+        return err;
+    }
+    report->config_us = lis2de_query_micros(dev) - start;
+    if (!profile->odr_hz || !profile->axes)
+    {
+        return 0;
+    }
+
+    timeout_us = 2000000UL / profile->odr_hz + LIS2DE_STARTUP_SAMPLE_MARGIN_US;
+    since = lis2de_query_micros(dev);
+    polls = 0;
+    for (;;)
+    {
+        uint8_t ready = lis2de_query_new_data_available_on_xyz_axes(dev);
+
+        report->polls++;
+        polls++;
+        if ((err = lis2de_startup_error(dev)))
+        {
+            return err;
+        }
+        if (ready)
+        {
+            break;
+        }
+        if (lis2de_startup_expired(dev, since, timeout_us, polls))
+        {
+            return E_STARTUP_TIMEOUT;
+        }
+    }
+    report->first_sample_us = lis2de_query_micros(dev) - start;
+
+    lis2de_try_read_sample(dev, &report->sample, 0);
+    return lis2de_startup_error(dev);
+}
+
+uint8_t
+lis2de_startup(lis2de_dev_t *dev,
+               const lis2de_profile_t *profile,
+               const uint8_t reboot,
+               lis2de_startup_report_t *report)
+{
+    lis2de_startup_report_t rep = {0};
+    uint8_t err = lis2de_startup_run(dev, profile, reboot, lis2de_query_micros(dev), &rep);
+
+    if (report)
+    {
+        *report = rep;
+    }
+    return err;
+}
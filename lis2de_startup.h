@@ -0,0 +1,81 @@
+#ifndef LIS2DE_STARTUP_H
+#define LIS2DE_STARTUP_H
+
+#include <stdint.h>
+
+#include "lis2de.h"
+#include "lis2de_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Cold start of a device in as little time as the device allows,
+ * replacing fixed delays with polls:
+ *
+ * 1. WHO_AM_I is read to make sure a LIS2DE answers at the address.
+ * 2. Optionally the memory content is rebooted and CTRL_REG5 is polled
+ *    until the device clears BOOT.
+ * 3. The profile is written with lis2de_apply_profile(), one burst per
+ *    run of writable registers that changes.
+ * 4. STATUS_REG2 is polled until ZYXDA shows the first sample of the
+ *    new configuration, which is then fetched. Polling the status
+ *    alone avoids missing a sample that lands within a burst after
+ *    its status byte, see lis2de_poll.h.
+ *
+ * Without reboot, a sample still pending from the previous
+ * configuration is read away before the profile is written, so the
+ * first sample reported is a new one. In FIFO mode that sample is
+ * taken out of the FIFO.
+ *
+ * Waits are bounded by time when the bus backend has a clock and by
+ * LIS2DE_STARTUP_MAX_POLLS polls each otherwise; the times of the
+ * report stay 0 then. */
+
+// Time the device may take to clear BOOT
+#ifndef LIS2DE_STARTUP_BOOT_TIMEOUT_US
+#define LIS2DE_STARTUP_BOOT_TIMEOUT_US 20000UL
+#endif
+
+/* Allowance on top of two sample periods for the first sample, which
+ * takes 1 ms plus one period after power-down */
+#ifndef LIS2DE_STARTUP_SAMPLE_MARGIN_US
+#define LIS2DE_STARTUP_SAMPLE_MARGIN_US 10000UL
+#endif
+
+// Bound of every wait on a bus without clock
+#ifndef LIS2DE_STARTUP_MAX_POLLS
+#define LIS2DE_STARTUP_MAX_POLLS 10000U
+#endif
+
+typedef struct lis2de_startup_report
+{
+    uint8_t device_id;
+    // Microseconds since the call until BOOT was seen clear (if rebooted)
+    uint32_t boot_us;
+    // Microseconds since the call until the profile was written
+    uint32_t config_us;
+    // Microseconds since the call until ZYXDA was seen, time-to-first-sample
+    uint32_t first_sample_us;
+    // Reads of CTRL_REG5 and STATUS_REG2 spent waiting
+    uint16_t polls;
+    lis2de_data_t sample;
+} lis2de_startup_report_t;
+
+/* Run the startup sequence above after lis2de_init(). report, if not
+ * NULL, receives what was measured so far. Returns 0 once the first
+ * sample arrived, or right after the profile was written if it selects
+ * power-down. Otherwise returns E_INVALID_PROFILE before any bus
+ * traffic, E_UNKNOWN_DEVICE for an unexpected WHO_AM_I, E_STARTUP_TIMEOUT
+ * if BOOT or ZYXDA did not come in time, or the bus error recorded with
+ * LIS2DE_USE_CEXCEPTION=0. */
+uint8_t lis2de_startup(lis2de_dev_t *dev,
+                       const lis2de_profile_t *profile,
+                       uint8_t reboot,
+                       lis2de_startup_report_t *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
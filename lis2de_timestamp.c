@@ -0,0 +1,166 @@
+#include "lib/lis2de-driver/include/lis2de_timestamp.h"
+
+// The period estimate stays within 1/8 of the nominal one
+#define PERIOD_RANGE_SHIFT 3
+
+void
+lis2de_timestamp_init(lis2de_timestamp_t *ts,
+                      uint16_t odr_hz)
+{
+    ts->nominal_q8 = odr_hz ? (uint32_t) ((256000000ULL + odr_hz / 2) / odr_hz) : 0;
+    ts->period_q8 = ts->nominal_q8;
+    ts->last_us = 0;
+    ts->last_frac = 0;
+    ts->locked = 0;
+    ts->leftover = 0;
+}
+
+void
+lis2de_timestamp_setup(lis2de_timestamp_t *ts,
+                       lis2de_dev_t *dev)
+{
+    uint8_t odr = lis2de_query_data_rate_selection(dev);
+    uint8_t low_power = lis2de_query_low_power_mode_enabled(dev);
+
+    lis2de_timestamp_init(ts, lis2de_data_rate_in_hz(odr, low_power));
+}
+
+int32_t
+lis2de_timestamp_drift_ppm(const lis2de_timestamp_t *ts)
+{
+    if (!ts->period_q8)
+    {
+        return 0;
+    }
+    return (int32_t) (((int64_t) ts->nominal_q8 - ts->period_q8) * 1000000 /
+                      ts->period_q8);
+}
+
+// Q8 time relative to the reference t_us, which is never earlier
+static int64_t
+lis2de_timestamp_rel(uint32_t us,
+                     uint8_t frac,
+                     uint32_t t_us)
+{
+    return (int64_t) (int32_t) (us - t_us) * 256 + frac;
+}
+
+// Round a Q8 time at or before the reference t_us to microseconds
+static uint32_t
+lis2de_timestamp_abs(int64_t rel,
+                     uint32_t t_us)
+{
+    return t_us - (uint32_t) ((-rel + 128) / 256);
+}
+
+/* The newest frame counted at t_us was taken during the last sample
+ * period before it, expected in the middle of that period. Starting
+ * from the previous estimate, `fresh` periods later is the prediction;
+ * part of the error corrects the phase, part of it the period. Frames
+ * lost to an overrun make the count useless, so only the phase is
+ * reset then. Returns the estimate relative to t_us. */
+static int64_t
+lis2de_timestamp_update(lis2de_timestamp_t *ts,
+                        uint32_t t_us,
+                        const lis2de_fifo_src_t *src)
+{
+    int64_t period = ts->period_q8;
+    int64_t observed = -period / 2;
+    int64_t estimate = observed;
+    uint8_t pending = lis2de_fifo_src_frames(src);
+    uint8_t fresh = pending > ts->leftover ? pending - ts->leftover : 0;
+    uint32_t whole;
+
+    if (ts->locked && !src->overrun && fresh)
+    {
+        int64_t predicted = lis2de_timestamp_rel(ts->last_us, ts->last_frac, t_us)
+                          + fresh * period;
+        int64_t error = observed - predicted;
+        int64_t range = ts->nominal_q8 >> PERIOD_RANGE_SHIFT;
+
+        estimate = predicted + error / (1 << LIS2DE_TIMESTAMP_PHASE_SHIFT);
+        period += error / fresh / (1 << LIS2DE_TIMESTAMP_FREQ_SHIFT);
+
+        if (period > ts->nominal_q8 + range)
+        {
+            period = ts->nominal_q8 + range;
+        }
+        if (period < ts->nominal_q8 - range)
+        {
+            period = ts->nominal_q8 - range;
+        }
+        ts->period_q8 = (uint32_t) period;
+    }
+    else if (ts->locked && !src->overrun)
+    {
+        // Nothing new, the last frame is still the newest
+        estimate = lis2de_timestamp_rel(ts->last_us, ts->last_frac, t_us);
+    }
+
+    // Whatever the loop says, the frame cannot lie outside that period
+    if (estimate > 0)
+    {
+        estimate = 0;
+    }
+    if (estimate < -period)
+    {
+        estimate = -period;
+    }
+
+    // Whole microseconds rounded down, the rest goes into the fraction
+    whole = (uint32_t) ((-estimate + 255) / 256);
+    ts->last_us = t_us - whole;
+    ts->last_frac = (uint8_t) (estimate + (int64_t) whole * 256);
+    ts->locked = 1;
+    return estimate;
+}
+
+/* FIFO_SRC_REG is timestamped in the middle of its transaction; the
+ * frames it counts are read right after it, straight into buf, and are
+ * spaced one period apart, the oldest first. After a failed read it is
+ * unknown how many frames the FIFO gave away, so the tracker drops the
+ * count of frames left behind and locks on again with the next drain. */
+uint8_t
+lis2de_read_fifo_timed(lis2de_dev_t *dev,
+                       lis2de_timestamp_t *ts,
+                       lis2de_timed_data_t *buf,
+                       uint8_t max)
+{
+    uint32_t before = lis2de_query_micros(dev);
+    lis2de_fifo_src_t src = lis2de_query_fifo_src(dev);
+    uint32_t t_us = before + (lis2de_query_micros(dev) - before) / 2;
+    uint8_t pending = lis2de_fifo_src_frames(&src);
+    int64_t newest;
+    uint8_t count;
+
+    if (max > LIS2DE_FIFO_DEPTH)
+    {
+        max = LIS2DE_FIFO_DEPTH;
+    }
+    if (lis2de_query_error(dev))
+    {
+        ts->locked = 0;
+        ts->leftover = 0;
+        return 0;
+    }
+    count = lis2de_read_fifo_frames_into(dev, &src, &buf[0].data, max,
+                                         sizeof(buf[0]));
+
+    newest = lis2de_timestamp_update(ts, t_us, &src);
+    if (count < (pending < max ? pending : max) || lis2de_query_error(dev))
+    {
+        ts->locked = 0;
+        ts->leftover = 0;
+    }
+    else
+    {
+        ts->leftover = pending - count;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        buf[i].t_us = lis2de_timestamp_abs(newest - (int64_t) (pending - 1 - i) *
+                                           ts->period_q8, t_us);
+    }
+    return count;
+}
@@ -0,0 +1,74 @@
+#ifndef LIS2DE_TIMESTAMP_H
+#define LIS2DE_TIMESTAMP_H
+
+#include <stdint.h>
+
+#include "lis2de.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Reconstruction of sample times for FIFO batches. The FIFO_SRC_REG
+ * read of every drain is timestamped with the bus clock; together with
+ * the number of unread frames it tells when the newest frame was taken,
+ * give or take one sample period. A phase/frequency tracking loop fits
+ * the estimated sample period to these observations, so timestamps
+ * follow the true ODR of the sensor instead of the nominal one.
+ *
+ * Times are microseconds of lis2de_query_micros() and wrap around like
+ * it. The bus backend must provide micros(). Periods are kept in Q8
+ * fixed point, i.e. in units of 1/256 us. */
+
+// Weight of a phase error in the next estimate, 1/2^n
+#ifndef LIS2DE_TIMESTAMP_PHASE_SHIFT
+#define LIS2DE_TIMESTAMP_PHASE_SHIFT 3
+#endif
+
+// Weight of a phase error in the period estimate, 1/2^n per sample
+#ifndef LIS2DE_TIMESTAMP_FREQ_SHIFT
+#define LIS2DE_TIMESTAMP_FREQ_SHIFT 7
+#endif
+
+typedef struct lis2de_timed_data
+{
+    lis2de_data_t data;
+    uint32_t t_us;
+} lis2de_timed_data_t;
+
+typedef struct lis2de_timestamp
+{
+    // Nominal and estimated sample period, Q8 microseconds
+    uint32_t nominal_q8;
+    uint32_t period_q8;
+
+    // Estimated time the newest frame seen so far was taken
+    uint32_t last_us;
+    uint8_t last_frac;
+    uint8_t locked;
+
+    // Frames left in the FIFO by the previous drain
+    uint8_t leftover;
+} lis2de_timestamp_t;
+
+// Start over for a nominal output data rate, 0 for power-down
+void lis2de_timestamp_init(lis2de_timestamp_t *ts, uint16_t odr_hz);
+
+// Same, with the rate configured in CTRL_REG1 of the device
+void lis2de_timestamp_setup(lis2de_timestamp_t *ts, lis2de_dev_t *dev);
+
+// Deviation of the estimated from the nominal rate in ppm
+int32_t lis2de_timestamp_drift_ppm(const lis2de_timestamp_t *ts);
+
+/* Drain up to max frames like lis2de_read_fifo() and timestamp each
+ * of them. Returns the number of frames stored in buf. */
+uint8_t lis2de_read_fifo_timed(lis2de_dev_t *dev,
+                               lis2de_timestamp_t *ts,
+                               lis2de_timed_data_t *buf,
+                               uint8_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,379 @@
+#include "lib/lis2de-driver/include/lis2de_twi_async.h"
+
+#ifdef __AVR__
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <util/delay.h>
+#include <util/twi.h>
+
+#define TWI_STATUS()     (TW_STATUS)
+#define TWI_DATA()       (TWDR)
+#define TWI_SEND(v)      (TWDR = (v))
+#define TWI_CONTROL(v)   (TWCR = (v))
+#define TWI_IDLE()       _delay_us(LIS2DE_TWI_ASYNC_POLL_US)
+#define TWI_STOPPING()   (TWCR & (1 << TWSTO))
+#define TWI_SCL(high)    lis2de_twi_async_line(LIS2DE_TWI_ASYNC_SCL, high)
+#define TWI_SDA(high)    lis2de_twi_async_line(LIS2DE_TWI_ASYNC_SDA, high)
+#define TWI_SDA_LEVEL()  (LIS2DE_TWI_ASYNC_PIN & (1 << LIS2DE_TWI_ASYNC_SDA))
+
+// Half an SCL period while bit-banging, about 100 kHz
+#define LIS2DE_TWI_ASYNC_HALF_CLOCK_US 5
+
+/* The lines are open drain, so a pin is released by switching it to an
+ * input and pulled low by making it an output driving 0. */
+static void
+lis2de_twi_async_line(uint8_t pin,
+                      uint8_t high)
+{
+    if (high)
+    {
+        LIS2DE_TWI_ASYNC_DDR &= ~(1 << pin);
+    }
+    else
+    {
+        LIS2DE_TWI_ASYNC_PORT &= ~(1 << pin);
+        LIS2DE_TWI_ASYNC_DDR |= (1 << pin);
+    }
+    _delay_us(LIS2DE_TWI_ASYNC_HALF_CLOCK_US);
+}
+
+#else
+
+#include "lib/lis2de-driver/include/lis2de_twi_model.h"
+
+#define TWI_STATUS()     (lis2de_twi_model.twsr)
+#define TWI_DATA()       (lis2de_twi_model.twdr)
+#define TWI_SEND(v)      (lis2de_twi_model.twdr = (v))
+#define TWI_CONTROL(v)   lis2de_twi_model_control(v)
+#define TWI_IDLE()       lis2de_twi_model_step()
+#define TWI_STOPPING()   lis2de_twi_model_stopping()
+#define TWI_SCL(high)    lis2de_twi_model_scl(high)
+#define TWI_SDA(high)    lis2de_twi_model_sda(high)
+#define TWI_SDA_LEVEL()  lis2de_twi_model_sda_level()
+
+#endif
+
+// Control words for the next bus action, all with the interrupt enabled
+#define TWI_GO     ((1 << TWINT) | (1 << TWEN) | (1 << TWIE))
+#define TWI_START  (TWI_GO | (1 << TWSTA))
+#define TWI_ACK    (TWI_GO | (1 << TWEA))
+#define TWI_NAK    (TWI_GO)
+#define TWI_STOP   ((1 << TWINT) | (1 << TWEN) | (1 << TWSTO))
+
+static lis2de_twi_xfer_t *volatile twi_xfer;
+static volatile uint8_t twi_busy;
+static uint8_t twi_pos;
+static uint8_t twi_receiving;
+
+void
+lis2de_twi_async_init(void)
+{
+#ifdef __AVR__
+    TWSR = 0;
+    TWBR = ((F_CPU / LIS2DE_TWI_ASYNC_SCL_HZ) - 16) / 2;
+#endif
+    twi_xfer = 0;
+    twi_busy = 0;
+    TWI_CONTROL(1 << TWEN);
+}
+
+uint8_t
+lis2de_twi_async_submit(lis2de_twi_xfer_t *xfer)
+{
+    if (twi_busy)
+    {
+        return E_LIS2DE_I2C_BUSY;
+    }
+    twi_busy = 1;
+    twi_xfer = xfer;
+    twi_pos = 0;
+    twi_receiving = 0;
+    TWI_CONTROL(TWI_START);
+    return 0;
+}
+
+uint8_t
+lis2de_twi_async_busy(void)
+{
+    return twi_busy;
+}
+
+void
+lis2de_twi_async_abort(void)
+{
+    // With the TWI off the pins fall back to plain I/O
+    TWI_CONTROL(0);
+    twi_xfer = 0;
+    twi_busy = 0;
+    TWI_SDA(1);
+
+    // Up to nine clocks finish whatever byte the slave is sending
+    for (uint8_t pulse = 0; pulse < 9; pulse++)
+    {
+        if (TWI_SDA_LEVEL())
+        {
+            break;
+        }
+        TWI_SCL(0);
+        TWI_SCL(1);
+    }
+
+    // STOP: SDA rises while SCL is high
+    TWI_SCL(0);
+    TWI_SDA(0);
+    TWI_SCL(1);
+    TWI_SDA(1);
+
+    TWI_CONTROL(1 << TWEN);
+}
+
+/* The STOP is on the bus before the callback runs, so the callback may
+ * submit the next transfer straight away. TWSTO clears once the STOP
+ * has been sent, a START written before that would be lost. */
+static void
+lis2de_twi_async_finish(const uint8_t err)
+{
+    lis2de_twi_xfer_t *xfer = twi_xfer;
+
+    TWI_CONTROL(TWI_STOP);
+    while (TWI_STOPPING())
+    {
+    }
+    twi_xfer = 0;
+    twi_busy = 0;
+    if (xfer->done)
+    {
+        xfer->done(xfer->user, err);
+    }
+}
+
+void
+lis2de_twi_async_isr(void)
+{
+    lis2de_twi_xfer_t *xfer = twi_xfer;
+
+    if (!xfer)
+    {
+        TWI_CONTROL(TWI_STOP);
+        return;
+    }
+
+    switch (TWI_STATUS())
+    {
+    case TW_START:
+    case TW_REP_START:
+        TWI_SEND(twi_receiving ? (xfer->addr | 1) : xfer->addr);
+        TWI_CONTROL(TWI_GO);
+        break;
+
+    case TW_MT_SLA_ACK:
+        TWI_SEND(xfer->reg);
+        TWI_CONTROL(TWI_GO);
+        break;
+
+    case TW_MT_DATA_ACK:
+        if (!xfer->write)
+        {
+            // Register pointer is set, turn around for the read
+            twi_receiving = 1;
+            TWI_CONTROL(TWI_START);
+        }
+        else if (twi_pos < xfer->len)
+        {
+            TWI_SEND(xfer->buf[twi_pos++]);
+            TWI_CONTROL(TWI_GO);
+        }
+        else
+        {
+            lis2de_twi_async_finish(0);
+        }
+        break;
+
+    case TW_MR_SLA_ACK:
+        // NAK the last byte so the device releases the bus
+        TWI_CONTROL(xfer->len > 1 ? TWI_ACK : TWI_NAK);
+        break;
+
+    case TW_MR_DATA_ACK:
+        xfer->buf[twi_pos++] = TWI_DATA();
+        TWI_CONTROL(twi_pos + 1 < xfer->len ? TWI_ACK : TWI_NAK);
+        break;
+
+    case TW_MR_DATA_NACK:
+        xfer->buf[twi_pos++] = TWI_DATA();
+        lis2de_twi_async_finish(0);
+        break;
+
+    case TW_MT_SLA_NACK:
+    case TW_MT_DATA_NACK:
+        lis2de_twi_async_finish(E_LIS2DE_I2C_WRITE);
+        break;
+
+    case TW_MR_SLA_NACK:
+        lis2de_twi_async_finish(E_LIS2DE_I2C_REP_START);
+        break;
+
+    default:
+        // Arbitration lost or bus error
+        lis2de_twi_async_finish(E_LIS2DE_I2C_IO);
+        break;
+    }
+}
+
+#ifdef __AVR__
+ISR(TWI_vect)
+{
+    lis2de_twi_async_isr();
+}
+#endif
+
+uint8_t
+lis2de_twi_async_read_bytes(const lis2de_dev_t *dev,
+                            lis2de_twi_xfer_t *xfer,
+                            uint8_t reg,
+                            uint8_t *buf,
+                            uint8_t len,
+                            lis2de_twi_done_t done,
+                            void *user)
+{
+    // In order to read multiple bytes, MSB of reg must be 1
+    xfer->addr = dev->addr;
+    xfer->reg = len > 1 ? (reg | (1 << 7)) : reg;
+    xfer->buf = buf;
+    xfer->len = len;
+    xfer->write = 0;
+    xfer->done = done;
+    xfer->user = user;
+    return lis2de_twi_async_submit(xfer);
+}
+
+uint8_t
+lis2de_twi_async_write_bytes(const lis2de_dev_t *dev,
+                             lis2de_twi_xfer_t *xfer,
+                             uint8_t reg,
+                             const uint8_t *buf,
+                             uint8_t len,
+                             lis2de_twi_done_t done,
+                             void *user)
+{
+    xfer->addr = dev->addr;
+    xfer->reg = len > 1 ? (reg | (1 << 7)) : reg;
+    // Only read from while writing
+    xfer->buf = (uint8_t *) buf;
+    xfer->len = len;
+    xfer->write = 1;
+    xfer->done = done;
+    xfer->user = user;
+    return lis2de_twi_async_submit(xfer);
+}
+
+typedef struct lis2de_twi_wait
+{
+    volatile uint8_t done;
+    volatile uint8_t err;
+} lis2de_twi_wait_t;
+
+static void
+lis2de_twi_async_wake(void *user,
+                      uint8_t err)
+{
+    lis2de_twi_wait_t *wait = user;
+
+    wait->err = err;
+    wait->done = 1;
+}
+
+/* Submit and wait for completion within the time budget, 0 waits
+ * forever. The descriptor and the wait state live in this frame, and
+ * the engine lets go of both before it returns. */
+static uint8_t
+lis2de_twi_async_run(uint8_t addr,
+                     uint8_t reg,
+                     uint8_t *buf,
+                     uint8_t len,
+                     uint8_t write,
+                     uint32_t timeout_us)
+{
+    lis2de_twi_wait_t wait = { 0, 0 };
+    lis2de_twi_xfer_t xfer = { addr, reg, buf, len, write,
+                               lis2de_twi_async_wake, &wait };
+    uint32_t waited = 0;
+
+    while (lis2de_twi_async_submit(&xfer))
+    {
+        if (timeout_us && waited >= timeout_us)
+        {
+            return E_LIS2DE_I2C_TIMEOUT;
+        }
+        TWI_IDLE();
+        waited += LIS2DE_TWI_ASYNC_POLL_US;
+    }
+    while (!wait.done)
+    {
+        if (timeout_us && waited >= timeout_us)
+        {
+            lis2de_twi_async_abort();
+            return E_LIS2DE_I2C_TIMEOUT;
+        }
+        TWI_IDLE();
+        waited += LIS2DE_TWI_ASYNC_POLL_US;
+    }
+    return wait.err;
+}
+
+static uint8_t
+lis2de_twi_async_bus_init(void *ctx)
+{
+    (void) ctx;
+    lis2de_twi_async_init();
+    return 0;
+}
+
+static uint8_t
+lis2de_twi_async_bus_read(void *ctx,
+                          uint8_t addr,
+                          uint8_t reg,
+                          uint8_t *buf,
+                          uint8_t len,
+                          uint32_t timeout_us)
+{
+    (void) ctx;
+    return lis2de_twi_async_run(addr, reg, buf, len, 0, timeout_us);
+}
+
+static uint8_t
+lis2de_twi_async_bus_write(void *ctx,
+                           uint8_t addr,
+                           uint8_t reg,
+                           const uint8_t *buf,
+                           uint8_t len,
+                           uint32_t timeout_us)
+{
+    (void) ctx;
+    // Only read from while writing
+    return lis2de_twi_async_run(addr, reg, (uint8_t *) buf, len, 1,
+                                timeout_us);
+}
+
+static void
+lis2de_twi_async_bus_recover(void *ctx)
+{
+    (void) ctx;
+    lis2de_twi_async_abort();
+}
+
+const lis2de_bus_ops_t lis2de_twi_async_bus_ops =
+{
+    lis2de_twi_async_bus_init,
+    lis2de_twi_async_bus_read,
+    lis2de_twi_async_bus_write,
+    0,
+    lis2de_twi_async_bus_recover
+};
+
+const lis2de_bus_t lis2de_twi_async_bus =
+{
+    &lis2de_twi_async_bus_ops,
+    0
+};
@@ -0,0 +1,102 @@
+#ifndef LIS2DE_TWI_ASYNC_H
+#define LIS2DE_TWI_ASYNC_H
+
+#include <stdint.h>
+
+#include "lis2de.h"
+#include "lis2de_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Interrupt-driven transaction engine for the AVR TWI. A transfer is
+ * described once and handed to the TWI_vect state machine, which moves
+ * it byte by byte while the main loop keeps running. The completion
+ * callback is invoked from interrupt context with 0 or an E_* error
+ * once the STOP is on the bus, and may submit the next transfer right
+ * away.
+ *
+ * Aborting a transfer, on a timeout of the blocking bus ops or through
+ * recover(), disables the TWI, clocks SCL by hand until the slave
+ * releases SDA and sends a STOP, like lis2de_i2cmaster.c does.
+ *
+ * On hosts the engine runs against the TWI model of lis2de_twi_model.c,
+ * where lis2de_twi_model_step() takes the place of the interrupt. */
+
+// SCL rate programmed into TWBR by lis2de_twi_async_init()
+#ifndef LIS2DE_TWI_ASYNC_SCL_HZ
+#define LIS2DE_TWI_ASYNC_SCL_HZ 400000UL
+#endif
+
+// Pause between two checks for completion in the blocking bus ops
+#ifndef LIS2DE_TWI_ASYNC_POLL_US
+#define LIS2DE_TWI_ASYNC_POLL_US 10
+#endif
+
+// Pins of the TWI, defaults match the ATmega328P (SCL PC5, SDA PC4)
+#ifndef LIS2DE_TWI_ASYNC_PORT
+#define LIS2DE_TWI_ASYNC_PORT PORTC
+#define LIS2DE_TWI_ASYNC_DDR  DDRC
+#define LIS2DE_TWI_ASYNC_PIN  PINC
+#define LIS2DE_TWI_ASYNC_SCL  PC5
+#define LIS2DE_TWI_ASYNC_SDA  PC4
+#endif
+
+typedef void (*lis2de_twi_done_t)(void *user, uint8_t err);
+
+/* addr is the 8-bit device address, reg is sent as is, so the caller
+ * sets the auto-increment bit; lis2de_twi_async_read_bytes() and
+ * lis2de_twi_async_write_bytes() do that. A read needs len >= 1, the
+ * last byte is NAKed. The descriptor and buffer belong to the engine
+ * until done is called. */
+typedef struct lis2de_twi_xfer
+{
+    uint8_t addr;
+    uint8_t reg;
+    uint8_t *buf;
+    uint8_t len;
+    uint8_t write;
+    lis2de_twi_done_t done;
+    void *user;
+} lis2de_twi_xfer_t;
+
+void lis2de_twi_async_init(void);
+
+// Returns 0 or E_LIS2DE_I2C_BUSY while another transfer is in flight
+uint8_t lis2de_twi_async_submit(lis2de_twi_xfer_t *xfer);
+uint8_t lis2de_twi_async_busy(void);
+
+/* Drop the transfer in flight without calling its callback and clock
+ * the bus free */
+void lis2de_twi_async_abort(void);
+
+// TWI_vect body, wired up by the engine on AVR and by the model on hosts
+void lis2de_twi_async_isr(void);
+
+// Fill a descriptor for the device like lis2de_read_bytes() and submit it
+uint8_t lis2de_twi_async_read_bytes(const lis2de_dev_t *dev,
+                                    lis2de_twi_xfer_t *xfer,
+                                    uint8_t reg,
+                                    uint8_t *buf,
+                                    uint8_t len,
+                                    lis2de_twi_done_t done,
+                                    void *user);
+uint8_t lis2de_twi_async_write_bytes(const lis2de_dev_t *dev,
+                                     lis2de_twi_xfer_t *xfer,
+                                     uint8_t reg,
+                                     const uint8_t *buf,
+                                     uint8_t len,
+                                     lis2de_twi_done_t done,
+                                     void *user);
+
+/* Blocking bus backend on top of the engine, so the synchronous driver
+ * API shares the TWI with transfers submitted directly. */
+extern const lis2de_bus_ops_t lis2de_twi_async_bus_ops;
+extern const lis2de_bus_t lis2de_twi_async_bus;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,192 @@
+#include "lib/lis2de-driver/include/lis2de_twi_model.h"
+#include "lib/lis2de-driver/include/lis2de_twi_async.h"
+
+#define PHASE_IDLE     0
+#define PHASE_ADDRESS  1
+#define PHASE_TRANSMIT 2
+#define PHASE_RECEIVE  3
+
+lis2de_twi_model_t lis2de_twi_model;
+
+void
+lis2de_twi_model_attach(lis2de_sim_bus_t *bus)
+{
+    lis2de_twi_model.bus = bus;
+    lis2de_twi_model.twcr = 0;
+    lis2de_twi_model.twdr = 0xFF;
+    lis2de_twi_model.twsr = TW_NO_INFO;
+    lis2de_twi_model.phase = PHASE_IDLE;
+    lis2de_twi_model.started = 0;
+    lis2de_twi_model.scl = 1;
+    lis2de_twi_model.sda = 1;
+    lis2de_twi_model.clocks = 0;
+    lis2de_twi_model.lost_starts = 0;
+    lis2de_twi_model.interrupts = 0;
+}
+
+static uint8_t
+lis2de_twi_model_address(lis2de_twi_model_t *twi)
+{
+    uint8_t ack = lis2de_sim_bus_start(twi->bus, twi->twdr);
+
+    if (twi->twdr & 1)
+    {
+        twi->phase = PHASE_RECEIVE;
+        return ack ? TW_MR_SLA_ACK : TW_MR_SLA_NACK;
+    }
+    twi->phase = PHASE_TRANSMIT;
+    return ack ? TW_MT_SLA_ACK : TW_MT_SLA_NACK;
+}
+
+void
+lis2de_twi_model_control(uint8_t twcr)
+{
+    lis2de_twi_model_t *twi = &lis2de_twi_model;
+    uint8_t ack;
+
+    uint8_t stopping = twi->twcr & (1 << TWSTO);
+
+    // Writing a one clears TWINT, nothing happens without it
+    twi->twcr = twcr & ~(1 << TWINT);
+    if (!(twcr & (1 << TWEN)) || !(twcr & (1 << TWINT)))
+    {
+        if (!(twcr & (1 << TWEN)))
+        {
+            // Disabling the TWI drops whatever it was doing
+            twi->twcr &= ~(1 << TWSTO);
+            twi->phase = PHASE_IDLE;
+            twi->started = 0;
+        }
+        else
+        {
+            twi->twcr |= stopping;
+        }
+        return;
+    }
+
+    if (twcr & (1 << TWSTO))
+    {
+        // A STOP leaves TWINT cleared and raises no interrupt
+        lis2de_sim_bus_stop(twi->bus);
+        twi->twsr = TW_NO_INFO;
+        twi->phase = PHASE_IDLE;
+        twi->started = 0;
+        return;
+    }
+
+    if ((twcr & (1 << TWSTA)) && stopping)
+    {
+        twi->lost_starts++;
+        twi->twsr = TW_BUS_ERROR;
+        twi->phase = PHASE_IDLE;
+    }
+    else if ((twcr & (1 << TWSTA)) && twi->bus->stuck)
+    {
+        // Waits for a free bus that never comes
+        return;
+    }
+    else if (twcr & (1 << TWSTA))
+    {
+        twi->twsr = twi->started ? TW_REP_START : TW_START;
+        twi->phase = PHASE_ADDRESS;
+        twi->started = 1;
+    }
+    else if (twi->phase == PHASE_ADDRESS)
+    {
+        twi->twsr = lis2de_twi_model_address(twi);
+    }
+    else if (twi->phase == PHASE_TRANSMIT)
+    {
+        ack = lis2de_sim_bus_write_byte(twi->bus, twi->twdr);
+        twi->twsr = ack ? TW_MT_DATA_ACK : TW_MT_DATA_NACK;
+    }
+    else if (twi->phase == PHASE_RECEIVE)
+    {
+        ack = (twcr >> TWEA) & 1;
+        twi->twdr = lis2de_sim_bus_read_byte(twi->bus, ack);
+        twi->twsr = ack ? TW_MR_DATA_ACK : TW_MR_DATA_NACK;
+    }
+    else
+    {
+        // Data action without a START
+        twi->twsr = TW_BUS_ERROR;
+    }
+    twi->twcr |= (1 << TWINT);
+}
+
+uint8_t
+lis2de_twi_model_step(void)
+{
+    lis2de_twi_model_t *twi = &lis2de_twi_model;
+    const uint8_t pending = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+
+    if ((twi->twcr & pending) != pending)
+    {
+        return 0;
+    }
+    twi->interrupts++;
+    lis2de_twi_async_isr();
+    return 1;
+}
+
+uint8_t
+lis2de_twi_model_stopping(void)
+{
+    lis2de_twi_model_t *twi = &lis2de_twi_model;
+
+    if (!(twi->twcr & (1 << TWSTO)))
+    {
+        return 0;
+    }
+    twi->twcr &= ~(1 << TWSTO);
+    return 1;
+}
+
+void
+lis2de_twi_model_scl(uint8_t high)
+{
+    lis2de_twi_model_t *twi = &lis2de_twi_model;
+
+    if (high && !twi->scl)
+    {
+        lis2de_sim_bus_advance(twi->bus,
+                               1000000000ULL / twi->bus->scl_hz);
+        if (twi->bus->stuck && twi->clocks < LIS2DE_TWI_MODEL_HOLD_CLOCKS)
+        {
+            twi->clocks++;
+        }
+    }
+    twi->scl = high;
+}
+
+void
+lis2de_twi_model_sda(uint8_t high)
+{
+    lis2de_twi_model_t *twi = &lis2de_twi_model;
+
+    // SDA rising while SCL is high is a STOP, if the slave lets it rise
+    if (high && !twi->sda && twi->scl)
+    {
+        twi->sda = 1;
+        if (lis2de_twi_model_sda_level())
+        {
+            lis2de_sim_bus_set_stuck(twi->bus, 0);
+            lis2de_sim_bus_stop(twi->bus);
+            twi->clocks = 0;
+        }
+        return;
+    }
+    twi->sda = high;
+}
+
+uint8_t
+lis2de_twi_model_sda_level(void)
+{
+    lis2de_twi_model_t *twi = &lis2de_twi_model;
+
+    if (twi->bus->stuck && twi->clocks < LIS2DE_TWI_MODEL_HOLD_CLOCKS)
+    {
+        return 0;
+    }
+    return twi->sda;
+}
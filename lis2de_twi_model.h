@@ -0,0 +1,103 @@
+#ifndef LIS2DE_TWI_MODEL_H
+#define LIS2DE_TWI_MODEL_H
+
+#include <stdint.h>
+
+#include "lis2de_sim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Host-side model of the AVR TWI peripheral in master mode, so the
+ * interrupt-driven engine of lis2de_twi_async.c runs unmodified on a
+ * Linux host. It mirrors TWCR/TWDR/TWSR and answers every action with
+ * the status codes of <util/twi.h>, moving the bytes over a simulated
+ * bus of lis2de_sim.c.
+ *
+ * An action starts when TWCR is written with TWINT set and completes
+ * immediately; lis2de_twi_model_step() then plays the part of the
+ * TWI_vect interrupt. A STOP keeps TWSTO set until TWCR is polled once
+ * more, and a START written while it is still pending ends in a bus
+ * error. A START on a bus where the slave holds SDA low never
+ * completes.
+ *
+ * With the TWI disabled the lines can be driven by hand. A stuck slave
+ * holds SDA low for LIS2DE_TWI_MODEL_HOLD_CLOCKS SCL pulses and lets
+ * go of the bus on the STOP that follows. */
+
+// SCL pulses a stuck slave needs to finish the byte it is sending
+#define LIS2DE_TWI_MODEL_HOLD_CLOCKS 9
+
+// TWCR bits, same positions as on the AVR
+#define TWINT 7
+#define TWEA  6
+#define TWSTA 5
+#define TWSTO 4
+#define TWWC  3
+#define TWEN  2
+#define TWIE  0
+
+// Master status codes of <util/twi.h>
+#define TW_START        0x08
+#define TW_REP_START    0x10
+#define TW_MT_SLA_ACK   0x18
+#define TW_MT_SLA_NACK  0x20
+#define TW_MT_DATA_ACK  0x28
+#define TW_MT_DATA_NACK 0x30
+#define TW_MT_ARB_LOST  0x38
+#define TW_MR_SLA_ACK   0x40
+#define TW_MR_SLA_NACK  0x48
+#define TW_MR_DATA_ACK  0x50
+#define TW_MR_DATA_NACK 0x58
+#define TW_NO_INFO      0xF8
+#define TW_BUS_ERROR    0x00
+
+typedef struct lis2de_twi_model
+{
+    lis2de_sim_bus_t *bus;
+
+    uint8_t twcr;
+    uint8_t twdr;
+    uint8_t twsr;
+
+    // Bus phase after the last action
+    uint8_t phase;
+    uint8_t started;
+
+    // Lines while the TWI is disabled, 1 when released
+    uint8_t scl;
+    uint8_t sda;
+    uint8_t clocks;
+
+    // START written while the previous STOP was still pending
+    uint32_t lost_starts;
+
+    // Number of times the interrupt vector ran
+    uint32_t interrupts;
+} lis2de_twi_model_t;
+
+// The model stands in for the single TWI of the MCU
+extern lis2de_twi_model_t lis2de_twi_model;
+
+void lis2de_twi_model_attach(lis2de_sim_bus_t *bus);
+
+void lis2de_twi_model_control(uint8_t twcr);
+
+/* Run the interrupt vector once if it is pending and enabled. Returns 1
+ * when it ran, 0 when the peripheral is idle. */
+uint8_t lis2de_twi_model_step(void);
+
+// Read TWSTO, a pending STOP completes after it has been seen once
+uint8_t lis2de_twi_model_stopping(void);
+
+// Drive the lines by hand and sample SDA
+void lis2de_twi_model_scl(uint8_t high);
+void lis2de_twi_model_sda(uint8_t high);
+uint8_t lis2de_twi_model_sda_level(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
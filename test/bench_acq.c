@@ -0,0 +1,223 @@
+/* Multi-bus acquisition engine (lis2de_acq.c) on simulated buses: one
+ * worker per bus, two devices per bus at 5.376 kHz on a 1 MHz bus.
+ * For 1 to MAX_BUSES buses it reports the aggregate frame rate.
+ *
+ *   paced     the wait hook sleeps until the wall clock has caught up
+ *             with the virtual clock of the bus, bus time included, so
+ *             the sensors produce frames in real time
+ *   unpaced   the wait hook only advances the virtual clock, so the
+ *             workers run flat out and the CPU time per frame shows;
+ *             a consumer sharing the CPUs with them drops frames
+ *
+ * "delivered" counts the frames the consumer got, "drained" those the
+ * workers took from the FIFOs, per virtual second of each bus and per
+ * CPU second of the process.
+ *
+ * Unlike bench_sim these are wall-clock and CPU-time figures of the
+ * host. They depend on the machine and on the CPUs available. */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "rig.h"
+
+#include "lib/lis2de-driver/include/lis2de_acq.h"
+
+#define MAX_BUSES    8
+#define BUS_DEVICES  2
+#define QUEUE_FRAMES 4096
+
+// Wall time of one run in ns
+#define RUN_NS 500000000ULL
+
+typedef struct bench_bus
+{
+    lis2de_sim_bus_t sim_bus;
+    lis2de_sim_t sims[BUS_DEVICES];
+    lis2de_bus_t bus;
+    lis2de_dev_t devs[BUS_DEVICES];
+    lis2de_acq_frame_t queue[QUEUE_FRAMES];
+
+    // Virtual and wall time the run started at
+    uint64_t virt_start_ns;
+    uint64_t wall_start_ns;
+} bench_bus_t;
+
+static bench_bus_t buses[MAX_BUSES];
+
+static const uint8_t ADDRS[BUS_DEVICES] = {LIS2DE_ADDR_SA0_LOW, LIS2DE_ADDR_SA0_HIGH};
+
+static uint64_t
+clock_ns(clockid_t clock)
+{
+    struct timespec ts;
+
+    clock_gettime(clock, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+// Frame n of a device spreads n over the axes, so gaps can be found
+static void
+bench_waveform(void *user,
+               uint32_t index,
+               lis2de_data_t *sample)
+{
+    (void) user;
+    sample->x = (int8_t) index;
+    sample->y = (int8_t) (index >> 8);
+    sample->z = (int8_t) (index >> 16);
+}
+
+static uint32_t
+frame_index(const lis2de_data_t *data)
+{
+    return (uint32_t) (uint8_t) data->x | ((uint32_t) (uint8_t) data->y << 8) |
+           ((uint32_t) (uint8_t) data->z << 16);
+}
+
+static void
+wait_unpaced(void *user,
+             uint32_t us)
+{
+    bench_bus_t *b = user;
+
+    lis2de_sim_bus_advance(&b->sim_bus, (uint64_t) us * 1000);
+}
+
+static void
+wait_paced(void *user,
+           uint32_t us)
+{
+    bench_bus_t *b = user;
+    uint64_t until;
+    struct timespec ts;
+
+    lis2de_sim_bus_advance(&b->sim_bus, (uint64_t) us * 1000);
+    until = b->wall_start_ns + (b->sim_bus.now_ns - b->virt_start_ns);
+    ts.tv_sec = (time_t) (until / 1000000000ULL);
+    ts.tv_nsec = (long) (until % 1000000000ULL);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, 0);
+}
+
+static void
+setup_bus(bench_bus_t *b)
+{
+    lis2de_sim_bus_init(&b->sim_bus, 1000000);
+    b->bus.ops = &lis2de_sim_bus_ops;
+    b->bus.ctx = &b->sim_bus;
+    for (uint8_t d = 0; d < BUS_DEVICES; d++)
+    {
+        lis2de_dev_t *dev = &b->devs[d];
+
+        lis2de_sim_init(&b->sims[d], ADDRS[d]);
+        lis2de_sim_set_waveform(&b->sims[d], bench_waveform, 0);
+        lis2de_sim_bus_attach(&b->sim_bus, &b->sims[d]);
+        lis2de_init(dev, &b->bus, ADDRS[d]);
+        lis2de_set_operating_mode_to_low_power_mode(dev);
+        lis2de_set_data_rate_to_max(dev);
+        lis2de_disable_continuos_block_data_update(dev);
+        lis2de_set_fifo_mode_to_stream_mode(dev);
+        lis2de_enable_fifo(dev);
+    }
+}
+
+static void
+bench_buses(uint8_t count,
+            uint8_t paced)
+{
+    static lis2de_acq_frame_t buf[1024];
+    const struct timespec idle = { 0, 100000 };
+    lis2de_acq_t acq;
+    uint32_t last[MAX_BUSES * BUS_DEVICES];
+    uint8_t seen[MAX_BUSES * BUS_DEVICES] = { 0 };
+    uint64_t frames = 0;
+    uint64_t drained = 0;
+    uint64_t gaps = 0;
+    uint64_t virt_ns = 0;
+    uint32_t errors = 0;
+    uint32_t dropped = 0;
+    uint64_t wall;
+    uint64_t cpu;
+    uint32_t n;
+
+    lis2de_acq_init(&acq);
+    for (uint8_t b = 0; b < count; b++)
+    {
+        uint8_t id;
+
+        setup_bus(&buses[b]);
+        lis2de_acq_add_bus(&acq, &id, buses[b].queue, QUEUE_FRAMES, -1);
+        lis2de_acq_set_wait(&acq, id, paced ? wait_paced : wait_unpaced,
+                            &buses[b]);
+        for (uint8_t d = 0; d < BUS_DEVICES; d++)
+        {
+            lis2de_acq_add_device(&acq, id, &buses[b].devs[d]);
+        }
+    }
+
+    wall = clock_ns(CLOCK_MONOTONIC);
+    for (uint8_t b = 0; b < count; b++)
+    {
+        buses[b].virt_start_ns = buses[b].sim_bus.now_ns;
+        buses[b].wall_start_ns = wall;
+    }
+    cpu = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+    lis2de_acq_start(&acq);
+    do
+    {
+        n = lis2de_acq_read(&acq, buf, 1024);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            uint8_t d = buf[i].device;
+            uint32_t index = frame_index(&buf[i].data);
+
+            gaps += seen[d] && index != ((last[d] + 1) & 0xFFFFFF);
+            seen[d] = 1;
+            last[d] = index;
+        }
+        frames += n;
+        if (!n)
+        {
+            nanosleep(&idle, 0);
+        }
+    } while (clock_ns(CLOCK_MONOTONIC) - wall < RUN_NS);
+    lis2de_acq_stop(&acq);
+    while ((n = lis2de_acq_read(&acq, buf, 1024)))
+    {
+        frames += n;
+    }
+    wall = clock_ns(CLOCK_MONOTONIC) - wall;
+    cpu = clock_ns(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+
+    for (uint8_t b = 0; b < count; b++)
+    {
+        virt_ns += buses[b].sim_bus.now_ns - buses[b].virt_start_ns;
+        drained += acq.workers[b].frames;
+        errors += acq.workers[b].errors;
+        dropped += acq.workers[b].dropped;
+    }
+    printf("  %-8s %5u %12.0f %14.0f %14.0f %6llu %8u %6u\n",
+           paced ? "paced" : "unpaced", count, frames * 1e9 / wall,
+           drained * 1e9 / virt_ns, drained * 1e9 / cpu,
+           (unsigned long long) gaps, dropped, errors);
+}
+
+int
+main(void)
+{
+    printf("\nacquisition, %u devices per bus at 5376 Hz, 1 MHz SCL, %.1f s per run\n",
+           BUS_DEVICES, RUN_NS / 1e9);
+    printf("  %-8s %5s %12s %14s %14s %6s %8s %6s\n", "", "", "delivered",
+           "drained", "drained", "", "", "");
+    printf("  %-8s %5s %12s %14s %14s %6s %8s %6s\n", "mode", "buses",
+           "frames/s", "/virt s/bus", "/CPU s", "gaps", "drops", "errors");
+    for (uint8_t count = 1; count <= MAX_BUSES; count *= 2)
+    {
+        bench_buses(count, 1);
+    }
+    for (uint8_t count = 1; count <= MAX_BUSES; count *= 2)
+    {
+        bench_buses(count, 0);
+    }
+    return 0;
+}
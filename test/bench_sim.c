@@ -0,0 +1,199 @@
+/* Deterministic benchmarks of the driver against the simulated device.
+ * All times are virtual bus time, so the numbers only depend on the
+ * SCL rate and the bytes on the bus and are the same on every run. */
+
+#include <stdio.h>
+
+#include "rig.h"
+
+// Virtual run time of the throughput benchmarks
+#define RUN_NS 10000000000ULL
+
+static const uint32_t SCL_RATES[] = {100000, 400000, 1000000};
+
+static uint64_t
+advance_to(test_rig_t *rig,
+           uint64_t t_ns)
+{
+    if (t_ns > rig->sim_bus.now_ns)
+    {
+        lis2de_sim_bus_advance(&rig->sim_bus, t_ns - rig->sim_bus.now_ns);
+    }
+    return rig->sim_bus.now_ns;
+}
+
+static void
+setup_stream(test_rig_t *rig,
+             uint32_t scl_hz)
+{
+    test_rig_init(rig, scl_hz);
+    lis2de_sim_set_waveform(&rig->sim, test_waveform, 0);
+    lis2de_disable_continuos_block_data_update(&rig->dev);
+    lis2de_set_data_rate_to_max(&rig->dev);
+    lis2de_set_fifo_mode_to_stream_mode(&rig->dev);
+    lis2de_enable_fifo(&rig->dev);
+}
+
+static void
+bench_transactions(void)
+{
+    test_rig_t rig;
+    lis2de_data_t buf[LIS2DE_FIFO_DEPTH];
+    lis2de_data_t data;
+    uint32_t before;
+
+    printf("\ntransactions per operation\n");
+    setup_stream(&rig, 400000);
+    lis2de_sim_bus_advance(&rig.sim_bus, 100000000ULL);
+
+    before = rig.sim_bus.transactions;
+    lis2de_read_fifo(&rig.dev, buf, LIS2DE_FIFO_DEPTH);
+    printf("  %-44s %u\n", "FIFO drain, 32 frames", rig.sim_bus.transactions - before);
+
+    lis2de_set_fifo_mode_to_bypass_mode(&rig.dev);
+    before = rig.sim_bus.transactions;
+    data = lis2de_query_accel_data(&rig.dev);
+    printf("  %-44s %u\n", "sample read", rig.sim_bus.transactions - before);
+    before = rig.sim_bus.transactions;
+    lis2de_try_read_sample(&rig.dev, &data, 0);
+    printf("  %-44s %u\n", "data-ready gated sample read", rig.sim_bus.transactions - before);
+
+    before = rig.sim_bus.transactions;
+    lis2de_set_fth(&rig.dev, 16);
+    printf("  %-44s %u\n", "setter without shadow", rig.sim_bus.transactions - before);
+    lis2de_enable_shadow_registers(&rig.dev);
+    lis2de_shadow_registers_resync(&rig.dev);
+    before = rig.sim_bus.transactions;
+    lis2de_set_fth(&rig.dev, 8);
+    printf("  %-44s %u\n", "setter with shadow", rig.sim_bus.transactions - before);
+    lis2de_disable_shadow_registers(&rig.dev);
+
+    before = rig.sim_bus.transactions;
+    lis2de_set_data_rate_to_400hz(&rig.dev);
+    lis2de_disable_continuos_block_data_update(&rig.dev);
+    lis2de_set_full_scale_to_8g(&rig.dev);
+    lis2de_set_fifo_mode_to_stream_mode(&rig.dev);
+    lis2de_set_fth(&rig.dev, 16);
+    lis2de_enable_fifo(&rig.dev);
+    printf("  %-44s %u\n", "bring-up with 6 setters", rig.sim_bus.transactions - before);
+
+    before = rig.sim_bus.transactions;
+    lis2de_begin_configuration(&rig.dev);
+    lis2de_set_data_rate_to_200hz(&rig.dev);
+    lis2de_enable_continuos_block_data_update(&rig.dev);
+    lis2de_set_full_scale_to_4g(&rig.dev);
+    lis2de_set_fifo_mode_to_fifo_mode(&rig.dev);
+    lis2de_set_fth(&rig.dev, 8);
+    lis2de_disable_fifo(&rig.dev);
+    lis2de_commit_configuration(&rig.dev);
+    printf("  %-44s %u\n", "bring-up with 6 setters in a batch", rig.sim_bus.transactions - before);
+    (void) data;
+}
+
+static void
+bench_latency(void)
+{
+    printf("\nbus time per operation in us\n");
+    printf("  %-20s %10s %10s %10s\n", "SCL Hz", "sample", "drain 16", "drain 32");
+    for (uint8_t r = 0; r < sizeof(SCL_RATES) / sizeof(SCL_RATES[0]); r++)
+    {
+        test_rig_t rig;
+        lis2de_data_t buf[LIS2DE_FIFO_DEPTH];
+        uint64_t t0;
+        uint64_t sample_ns;
+        uint64_t half_ns;
+        uint64_t full_ns;
+
+        setup_stream(&rig, SCL_RATES[r]);
+        lis2de_sim_bus_advance(&rig.sim_bus, 100000000ULL);
+        t0 = rig.sim_bus.now_ns;
+        lis2de_read_fifo(&rig.dev, buf, LIS2DE_FIFO_DEPTH);
+        full_ns = rig.sim_bus.now_ns - t0;
+
+        lis2de_read_fifo(&rig.dev, buf, LIS2DE_FIFO_DEPTH);
+        lis2de_sim_bus_advance(&rig.sim_bus, 16 * 1000000000ULL / 1344);
+        t0 = rig.sim_bus.now_ns;
+        lis2de_read_fifo(&rig.dev, buf, 16);
+        half_ns = rig.sim_bus.now_ns - t0;
+
+        t0 = rig.sim_bus.now_ns;
+        lis2de_query_accel_data(&rig.dev);
+        sample_ns = rig.sim_bus.now_ns - t0;
+
+        printf("  %-20u %10.1f %10.1f %10.1f\n", SCL_RATES[r],
+               sample_ns / 1000.0, half_ns / 1000.0, full_ns / 1000.0);
+    }
+}
+
+/* Sustained acquisition at 1.344 kHz for RUN_NS, either polling every
+ * sample period with a data-ready gated read or draining the FIFO each
+ * time it is half full. Missed frames were generated but not delivered,
+ * for the FIFO including those still in it at the end. */
+static void
+bench_throughput(void)
+{
+    const uint64_t period_ns = 1000000000ULL / 1344;
+
+    printf("\nsustained acquisition at 1344 Hz for %llu s\n",
+           (unsigned long long) (RUN_NS / 1000000000ULL));
+    printf("  %-8s %-10s %12s %8s %10s %10s\n",
+           "SCL Hz", "method", "frames/s", "missed", "tx/frame", "bus busy");
+    for (uint8_t r = 0; r < sizeof(SCL_RATES) / sizeof(SCL_RATES[0]); r++)
+    {
+        for (uint8_t fifo = 0; fifo < 2; fifo++)
+        {
+            test_rig_t rig;
+            lis2de_data_t buf[LIS2DE_FIFO_DEPTH];
+            uint64_t next;
+            uint64_t start;
+            uint64_t busy = 0;
+            uint32_t frames = 0;
+            uint32_t tx;
+
+            setup_stream(&rig, SCL_RATES[r]);
+            if (!fifo)
+            {
+                lis2de_set_fifo_mode_to_bypass_mode(&rig.dev);
+                lis2de_disable_fifo(&rig.dev);
+            }
+            start = rig.sim_bus.now_ns;
+            rig.sim.sample_index = 0;
+            tx = rig.sim_bus.transactions;
+            next = start;
+            while (rig.sim_bus.now_ns - start < RUN_NS)
+            {
+                uint64_t t0;
+
+                next += fifo ? period_ns * (LIS2DE_FIFO_DEPTH / 2) : period_ns;
+                advance_to(&rig, next);
+                t0 = rig.sim_bus.now_ns;
+                if (fifo)
+                {
+                    frames += lis2de_read_fifo(&rig.dev, buf, LIS2DE_FIFO_DEPTH);
+                }
+                else
+                {
+                    frames += lis2de_try_read_sample(&rig.dev, buf, 0);
+                }
+                busy += rig.sim_bus.now_ns - t0;
+            }
+            tx = rig.sim_bus.transactions - tx;
+
+            printf("  %-8u %-10s %12.1f %8u %10.2f %9.1f%%\n", SCL_RATES[r],
+                   fifo ? "fifo" : "poll",
+                   frames * 1e9 / (double) (rig.sim_bus.now_ns - start),
+                   rig.sim.sample_index - frames,
+                   frames ? (double) tx / frames : 0.0,
+                   100.0 * busy / (double) (rig.sim_bus.now_ns - start));
+        }
+    }
+}
+
+int
+main(void)
+{
+    bench_transactions();
+    bench_latency();
+    bench_throughput();
+    return 0;
+}
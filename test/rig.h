@@ -0,0 +1,51 @@
+#ifndef LIS2DE_TEST_RIG_H
+#define LIS2DE_TEST_RIG_H
+
+#include <stdint.h>
+
+#include "lib/lis2de-driver/include/lis2de_sim.h"
+
+// One simulated device at LIS2DE_ADDR_SA0_LOW on a bus of its own
+typedef struct test_rig
+{
+    lis2de_sim_bus_t sim_bus;
+    lis2de_sim_t sim;
+    lis2de_bus_t bus;
+    lis2de_dev_t dev;
+} test_rig_t;
+
+static inline void
+test_rig_init(test_rig_t *rig,
+              uint32_t scl_hz)
+{
+    lis2de_sim_bus_init(&rig->sim_bus, scl_hz);
+    lis2de_sim_init(&rig->sim, LIS2DE_ADDR_SA0_LOW);
+    lis2de_sim_bus_attach(&rig->sim_bus, &rig->sim);
+    rig->bus.ops = &lis2de_sim_bus_ops;
+    rig->bus.ctx = &rig->sim_bus;
+    lis2de_init(&rig->dev, &rig->bus, LIS2DE_ADDR_SA0_LOW);
+}
+
+// Sample n of the counting waveform used by the tests
+static inline void
+test_waveform(void *user,
+              uint32_t index,
+              lis2de_data_t *sample)
+{
+    (void) user;
+    sample->x = (int8_t) index;
+    sample->y = (int8_t) (index + 64);
+    sample->z = (int8_t) (index + 128);
+}
+
+static inline uint8_t
+test_is_sample(const lis2de_data_t *data,
+               uint32_t index)
+{
+    lis2de_data_t want;
+
+    test_waveform(0, index, &want);
+    return data->x == want.x && data->y == want.y && data->z == want.z;
+}
+
+#endif
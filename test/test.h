@@ -0,0 +1,49 @@
+#ifndef LIS2DE_TEST_H
+#define LIS2DE_TEST_H
+
+#include <stdio.h>
+
+#include "rig.h"
+
+/* Minimal harness of the host tests. CHECK() and CHECK_EQ() report a
+ * failed condition with its location and count it, TEST_END() turns
+ * the count into the exit status of main(). */
+
+static int test_failures;
+
+#define CHECK(cond) \
+    do \
+    { \
+        if (!(cond)) \
+        { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) \
+    do \
+    { \
+        long long a_ = (long long) (a); \
+        long long b_ = (long long) (b); \
+        if (a_ != b_) \
+        { \
+            printf("%s:%d: %s == %s failed: %lld != %lld\n", \
+                   __FILE__, __LINE__, #a, #b, a_, b_); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_END() \
+    do \
+    { \
+        if (test_failures) \
+        { \
+            printf("%s: %d check(s) failed\n", __FILE__, test_failures); \
+            return 1; \
+        } \
+        printf("%s: ok\n", __FILE__); \
+        return 0; \
+    } while (0)
+
+#endif
@@ -0,0 +1,248 @@
+/* Transaction queue in front of a gated backend: a transaction holds
+ * the bus until the test opens the gate, so the waiters behind it pile
+ * up in a known state. Covers the starvation bound of the strict
+ * priority and the time budget spent waiting in the queue. */
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "test.h"
+
+#include "lib/lis2de-driver/include/lis2de_bus_queue.h"
+
+#define DATA_READERS 12
+
+typedef struct gate
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint8_t open;
+    uint8_t held;
+
+    // Registers in the order the transactions reached the bus
+    uint8_t log[32];
+    uint8_t logged;
+    uint32_t last_timeout_us;
+} gate_t;
+
+static gate_t gate = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+                       0, 0, { 0 }, 0, 0 };
+
+// WHO_AM_I reads wait for the gate, everything else passes
+static uint8_t
+gate_transfer(uint8_t reg,
+              uint32_t timeout_us)
+{
+    pthread_mutex_lock(&gate.lock);
+    gate.log[gate.logged++] = reg & 0x7F;
+    gate.last_timeout_us = timeout_us;
+    if ((reg & 0x7F) == 0x0F)
+    {
+        gate.held = 1;
+        pthread_cond_broadcast(&gate.cond);
+        while (!gate.open)
+        {
+            pthread_cond_wait(&gate.cond, &gate.lock);
+        }
+        gate.held = 0;
+    }
+    pthread_mutex_unlock(&gate.lock);
+    return 0;
+}
+
+static uint8_t
+gate_read(void *ctx,
+          uint8_t addr,
+          uint8_t reg,
+          uint8_t *buf,
+          uint8_t len,
+          uint32_t timeout_us)
+{
+    (void) ctx;
+    (void) addr;
+    for (uint8_t i = 0; i < len; i++)
+    {
+        buf[i] = 0;
+    }
+    return gate_transfer(reg, timeout_us);
+}
+
+static uint8_t
+gate_write(void *ctx,
+           uint8_t addr,
+           uint8_t reg,
+           const uint8_t *buf,
+           uint8_t len,
+           uint32_t timeout_us)
+{
+    (void) ctx;
+    (void) addr;
+    (void) buf;
+    (void) len;
+    return gate_transfer(reg, timeout_us);
+}
+
+static const lis2de_bus_ops_t gate_ops = { 0, gate_read, gate_write, 0, 0 };
+static const lis2de_bus_t gate_bus = { &gate_ops, 0 };
+
+static lis2de_bus_queue_t queue;
+
+static void
+gate_reset(void)
+{
+    gate.open = 0;
+    gate.held = 0;
+    gate.logged = 0;
+}
+
+static void
+gate_wait_held(void)
+{
+    pthread_mutex_lock(&gate.lock);
+    while (!gate.held)
+    {
+        pthread_cond_wait(&gate.cond, &gate.lock);
+    }
+    pthread_mutex_unlock(&gate.lock);
+}
+
+static void
+gate_open(void)
+{
+    pthread_mutex_lock(&gate.lock);
+    gate.open = 1;
+    pthread_cond_broadcast(&gate.cond);
+    pthread_mutex_unlock(&gate.lock);
+}
+
+static void
+wait_depth(lis2de_bus_class_t cls,
+           uint32_t depth)
+{
+    lis2de_bus_queue_class_stats_t stats[LIS2DE_BUS_CLASSES];
+
+    do
+    {
+        usleep(100);
+        lis2de_bus_queue_query_stats(&queue, stats);
+    } while (stats[cls].depth != depth);
+}
+
+static void *
+hold(void *arg)
+{
+    uint8_t val;
+
+    (void) arg;
+    queue.bus.ops->read(queue.bus.ctx, LIS2DE_ADDR_SA0_LOW, 0x0F, &val, 1, 0);
+    return 0;
+}
+
+static void *
+read_data(void *arg)
+{
+    uint8_t buf[6];
+
+    (void) arg;
+    queue.bus.ops->read(queue.bus.ctx, LIS2DE_ADDR_SA0_LOW, 0xA8, buf, 6, 0);
+    return 0;
+}
+
+static void *
+write_config(void *arg)
+{
+    uint8_t val = 0x57;
+
+    (void) arg;
+    queue.bus.ops->write(queue.bus.ctx, LIS2DE_ADDR_SA0_LOW, 0x20, &val, 1, 0);
+    return 0;
+}
+
+static void
+test_starvation_bound(void)
+{
+    lis2de_bus_queue_class_stats_t stats[LIS2DE_BUS_CLASSES];
+    pthread_t holder;
+    pthread_t config;
+    pthread_t readers[DATA_READERS];
+
+    gate_reset();
+    lis2de_bus_queue_init(&queue, &gate_bus);
+    pthread_create(&holder, 0, hold, 0);
+    gate_wait_held();
+
+    // The configuration write arrives first, the data reads pile up behind
+    pthread_create(&config, 0, write_config, 0);
+    wait_depth(LIS2DE_BUS_CLASS_CONFIG, 1);
+    for (uint8_t i = 0; i < DATA_READERS; i++)
+    {
+        pthread_create(&readers[i], 0, read_data, 0);
+    }
+    wait_depth(LIS2DE_BUS_CLASS_DATA, DATA_READERS);
+
+    gate_open();
+    pthread_join(holder, 0);
+    pthread_join(config, 0);
+    for (uint8_t i = 0; i < DATA_READERS; i++)
+    {
+        pthread_join(readers[i], 0);
+    }
+
+    // Data goes first until the write has let MAX_BYPASS reads pass
+    CHECK_EQ(gate.logged, 2 + DATA_READERS);
+    CHECK_EQ(gate.log[0], 0x0F);
+    for (uint8_t i = 1; i <= LIS2DE_BUS_QUEUE_MAX_BYPASS; i++)
+    {
+        CHECK_EQ(gate.log[i], 0x28);
+    }
+    CHECK_EQ(gate.log[1 + LIS2DE_BUS_QUEUE_MAX_BYPASS], 0x20);
+
+    lis2de_bus_queue_query_stats(&queue, stats);
+    CHECK_EQ(stats[LIS2DE_BUS_CLASS_CONFIG].aged, 1);
+    CHECK_EQ(stats[LIS2DE_BUS_CLASS_DATA].aged, 0);
+    CHECK_EQ(stats[LIS2DE_BUS_CLASS_DATA].transactions, DATA_READERS);
+    lis2de_bus_queue_destroy(&queue);
+}
+
+static void
+test_budget(void)
+{
+    lis2de_bus_queue_class_stats_t stats[LIS2DE_BUS_CLASSES];
+    pthread_t holder;
+    uint8_t buf[6];
+    uint8_t err;
+
+    gate_reset();
+    lis2de_bus_queue_init(&queue, &gate_bus);
+    pthread_create(&holder, 0, hold, 0);
+    gate_wait_held();
+
+    // The budget runs out in the queue, the bus is never touched
+    err = queue.bus.ops->read(queue.bus.ctx, LIS2DE_ADDR_SA0_LOW, 0xA8,
+                              buf, 6, 2000);
+    CHECK_EQ(err, E_LIS2DE_I2C_BUSY);
+    lis2de_bus_queue_query_stats(&queue, stats);
+    CHECK_EQ(stats[LIS2DE_BUS_CLASS_DATA].timeouts, 1);
+    CHECK_EQ(stats[LIS2DE_BUS_CLASS_DATA].depth, 0);
+    CHECK_EQ(stats[LIS2DE_BUS_CLASS_DATA].transactions, 0);
+
+    gate_open();
+    pthread_join(holder, 0);
+    CHECK_EQ(gate.logged, 1);
+
+    // On a free bus the transfer gets what is left of the budget
+    err = queue.bus.ops->read(queue.bus.ctx, LIS2DE_ADDR_SA0_LOW, 0xA8,
+                              buf, 6, 2000);
+    CHECK_EQ(err, 0);
+    CHECK_EQ(gate.logged, 2);
+    CHECK(gate.last_timeout_us > 0 && gate.last_timeout_us <= 2000);
+    lis2de_bus_queue_destroy(&queue);
+}
+
+int
+main(void)
+{
+    test_starvation_bound();
+    test_budget();
+    TEST_END();
+}
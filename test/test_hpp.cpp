@@ -0,0 +1,111 @@
+/* The C++ front end (lis2de.hpp), built as gnu++11 like the AVR
+ * toolchain builds it: the examples of its documentation against the
+ * simulated device, the masks and values of multi-field writes folded
+ * at compile time, and one transaction per write when the shadow holds
+ * the register. Built with LIS2DE_HPP_REJECT set to 1, 2 or 3 it holds
+ * one of the writes that must not compile, and the Makefile checks that
+ * each fails on its own static_assert. */
+
+#include "test.h"
+
+#include "lib/lis2de-driver/include/lis2de.hpp"
+
+using namespace lis2de;
+
+using DataRateLowPower = detail::Fields<reg::CtrlReg1, field::DataRate, field::LowPower>;
+using Odr100Xyz = detail::Fields<reg::CtrlReg1, field::DataRate, field::ZEnable,
+                                 field::YEnable, field::XEnable>;
+
+static_assert(DataRateLowPower::same_register, "one register");
+static_assert(DataRateLowPower::mask == 0xF8, "DataRate | LowPower");
+static_assert(DataRateLowPower::encode(Odr::Hz100, true) == 0x58, "100 Hz low-power");
+static_assert(Odr100Xyz::mask == 0xF7, "DataRate | ZEnable | YEnable | XEnable");
+static_assert(Odr100Xyz::encode(Odr::Hz100, true, true, true) == 0x57, "100 Hz XYZ");
+static_assert(!detail::Fields<reg::CtrlReg1, field::DataRate,
+                              field::FullScaleSelection>::same_register, "two registers");
+
+#if LIS2DE_HPP_REJECT == 1
+void
+reject(Device &acc)
+{
+    acc.write<field::FifoUnreadSamples>(3);
+}
+#elif LIS2DE_HPP_REJECT == 2
+void
+reject(Device &acc)
+{
+    acc.write<field::DataRate, field::FullScaleSelection>(Odr::Hz100, FullScale::G8);
+}
+#elif LIS2DE_HPP_REJECT == 3
+void
+reject(Device &acc)
+{
+    acc.write<field::LowPower, Field<reg::CtrlReg1, 0x18>>(true, 1);
+}
+#endif
+
+static void
+test_examples(void)
+{
+    test_rig_t rig;
+    lis2de_dev_t &dev = rig.dev;
+
+    test_rig_init(&rig, 400000);
+
+    // From the comment of lis2de.hpp, the axes keep their reset value
+    Device acc(&dev);
+    acc.write<field::DataRate, field::LowPower>(Odr::Hz100, false);
+    FullScale fs = acc.read<field::FullScaleSelection>();
+    CHECK_EQ(rig.sim.regs[0x20], 0x57);
+    CHECK(fs == FullScale::G2);
+
+    // From the README
+    acc.write<field::DataRate, field::ZEnable, field::YEnable, field::XEnable>(
+        Odr::Hz1, true, false, true);
+    CHECK_EQ(rig.sim.regs[0x20], 0x15);
+
+    acc.write<field::FullScaleSelection>(FullScale::G8);
+    CHECK_EQ(rig.sim.regs[0x23], 0x20);
+    CHECK(acc.read<field::FullScaleSelection>() == FullScale::G8);
+    CHECK(acc.read<field::DataRate>() == Odr::Hz1);
+    CHECK_EQ(acc.read<field::DeviceId>(), LIS2DE_DEVICE_ID);
+    CHECK_EQ(lis2de_query_error(&dev), 0);
+}
+
+static void
+test_transactions(void)
+{
+    test_rig_t rig;
+    uint32_t before;
+
+    test_rig_init(&rig, 400000);
+    Device acc(&rig.dev);
+
+    // A field of the whole register is a plain write
+    before = rig.sim_bus.transactions;
+    acc.write<field::TimeLatency>(0x42);
+    CHECK_EQ(rig.sim_bus.transactions - before, 1);
+    CHECK_EQ(rig.sim.regs[0x3C], 0x42);
+
+    // Read-modify-write, the read served from the shadow once it is on
+    before = rig.sim_bus.transactions;
+    acc.write<field::LowPower, field::XEnable>(true, false);
+    CHECK_EQ(rig.sim_bus.transactions - before, 2);
+    CHECK_EQ(rig.sim.regs[0x20], 0x0E);
+
+    lis2de_enable_shadow_registers(&rig.dev);
+    lis2de_shadow_registers_resync(&rig.dev);
+    before = rig.sim_bus.transactions;
+    acc.write<field::LowPower, field::XEnable>(false, true);
+    CHECK_EQ(rig.sim_bus.transactions - before, 1);
+    CHECK_EQ(rig.sim.regs[0x20], 0x07);
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+int
+main(void)
+{
+    test_examples();
+    test_transactions();
+    TEST_END();
+}
@@ -0,0 +1,110 @@
+/* Polling scheduler (lis2de_poll.c) against the simulated device with
+ * its ODR detuned: every sample the device makes is read exactly once,
+ * none lost between two polls or consumed unflagged by a poll that
+ * raced the sample instant, and no overruns. Swept over the output
+ * data rates and a range of ODR errors, on a 1 MHz bus with BDU on.
+ * Detuned far beyond that range samples do get lost, and the scheduler
+ * must count every one of them. */
+
+#include "test.h"
+
+#include "lib/lis2de-driver/include/lis2de_poll.h"
+
+// Samples read per rate and ODR error, after the first one
+#define SAMPLES 2000
+
+typedef struct rate
+{
+    uint16_t hz;
+    uint8_t low_power;
+    void (*set)(lis2de_dev_t *dev);
+} rate_t;
+
+static const rate_t RATES[] =
+{
+    {1, 0, lis2de_set_data_rate_to_1hz},
+    {10, 0, lis2de_set_data_rate_to_10hz},
+    {25, 0, lis2de_set_data_rate_to_25hz},
+    {50, 0, lis2de_set_data_rate_to_50hz},
+    {100, 0, lis2de_set_data_rate_to_100hz},
+    {200, 0, lis2de_set_data_rate_to_200hz},
+    {400, 0, lis2de_set_data_rate_to_400hz},
+    {1344, 0, lis2de_set_data_rate_to_max},
+    {1620, 1, lis2de_set_low_power_mode},
+    {5376, 1, lis2de_set_data_rate_to_max},
+};
+
+static const int32_t PPMS[] = {-5000, -2000, -500, 0, 500, 3000};
+static const int32_t OFF_PPMS[] = {-60000, -30000, 30000, 60000};
+
+static void
+test_rate(const rate_t *rate,
+          int32_t ppm,
+          uint8_t in_range)
+{
+    test_rig_t rig;
+    lis2de_poll_t poll;
+    lis2de_data_t sample;
+    uint32_t samples = 0;
+    uint32_t lost = 0;
+    uint8_t last = 0;
+
+    test_rig_init(&rig, 1000000);
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+    rig.sim.odr_error_ppm = ppm;
+    lis2de_enable_continuos_block_data_update(&rig.dev);
+    if (rate->low_power)
+    {
+        lis2de_set_operating_mode_to_low_power_mode(&rig.dev);
+    }
+    rate->set(&rig.dev);
+    lis2de_poll_setup(&poll, &rig.dev);
+    CHECK_EQ(poll.nominal_q8, (uint32_t) ((256000000ULL + rate->hz / 2) / rate->hz));
+
+    while (samples <= SAMPLES)
+    {
+        lis2de_sim_bus_advance(&rig.sim_bus,
+                               (uint64_t) lis2de_poll_wait_us(&poll, &rig.dev) * 1000);
+        if (!(lis2de_poll_run(&poll, &rig.dev, &sample) & LIS2DE_POLL_SAMPLE))
+        {
+            continue;
+        }
+        // The waveform counts in x, a gap is a sample nobody returned
+        if (samples++)
+        {
+            lost += (uint8_t) ((uint8_t) sample.x - last - 1);
+        }
+        last = (uint8_t) sample.x;
+    }
+
+    if (in_range && lost + poll.overruns + poll.lost)
+    {
+        printf("%u Hz at %d ppm: %u lost, %u overruns, %u counted lost\n",
+               rate->hz, (int) ppm, (unsigned) lost, (unsigned) poll.overruns,
+               (unsigned) poll.lost);
+    }
+    if (in_range)
+    {
+        CHECK_EQ(lost, 0);
+    }
+    CHECK_EQ(poll.lost, lost);
+    CHECK_EQ(poll.overruns, 0);
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+int
+main(void)
+{
+    for (uint8_t r = 0; r < sizeof(RATES) / sizeof(RATES[0]); r++)
+    {
+        for (uint8_t p = 0; p < sizeof(PPMS) / sizeof(PPMS[0]); p++)
+        {
+            test_rate(&RATES[r], PPMS[p], 1);
+        }
+        for (uint8_t p = 0; p < sizeof(OFF_PPMS) / sizeof(OFF_PPMS[0]); p++)
+        {
+            test_rate(&RATES[r], OFF_PPMS[p], 0);
+        }
+    }
+    TEST_END();
+}
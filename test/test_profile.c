@@ -0,0 +1,122 @@
+/* Profile images written as a diff against the shadow: one transaction
+ * per run of writable registers that changes, none for a profile the
+ * device already runs, and never a write across the read-only source
+ * registers. */
+
+#include "test.h"
+
+#include "lib/lis2de-driver/include/lis2de_profile.h"
+
+// Runs of writable registers in 0x1F..0x3F between the read-only ones
+#define WRITABLE_RUNS 6
+
+static const lis2de_profile_t slow =
+{
+    .odr_hz = 100, .axes = LIS2DE_AXES_XYZ, .full_scale_g = 2,
+    .block_data_update = 1,
+    .fifo_mode = LIS2DE_FIFO_STREAM, .fifo_watermark = 16,
+    .click = {.events = LIS2DE_CLICK_Z_SINGLE, .threshold = 40, .time_limit = 10},
+    .int1 = LIS2DE_INT1_CLICK | LIS2DE_INT1_FIFO_WATERMARK,
+    .ig1 = {.mode = LIS2DE_IG_OR, .events = LIS2DE_IG_Z_HIGH, .threshold = 20},
+    .ig2 = {.mode = LIS2DE_IG_OR, .events = LIS2DE_IG_X_HIGH, .threshold = 30},
+    .activity_threshold = 5, .activity_duration = 3,
+};
+
+// Differs from slow in ODR, full scale and click threshold
+static const lis2de_profile_t fast =
+{
+    .odr_hz = 400, .axes = LIS2DE_AXES_XYZ, .full_scale_g = 8,
+    .block_data_update = 1,
+    .fifo_mode = LIS2DE_FIFO_STREAM, .fifo_watermark = 16,
+    .click = {.events = LIS2DE_CLICK_Z_SINGLE, .threshold = 60, .time_limit = 10},
+    .int1 = LIS2DE_INT1_CLICK | LIS2DE_INT1_FIFO_WATERMARK,
+    .ig1 = {.mode = LIS2DE_IG_OR, .events = LIS2DE_IG_Z_HIGH, .threshold = 20},
+    .ig2 = {.mode = LIS2DE_IG_OR, .events = LIS2DE_IG_X_HIGH, .threshold = 30},
+    .activity_threshold = 5, .activity_duration = 3,
+};
+
+static uint32_t
+transactions(const test_rig_t *rig)
+{
+    return rig->sim_bus.transactions;
+}
+
+static void
+check_image(const test_rig_t *rig,
+            const lis2de_profile_t *profile)
+{
+    lis2de_profile_image_t image = lis2de_profile_compile(profile);
+
+    CHECK_EQ(image.error, 0);
+    for (uint8_t reg = 0x20; reg <= 0x3F; reg++)
+    {
+        // Only the writable registers, REFERENCE aside as it is not in use
+        if (reg == 0x26 || (reg >= 0x27 && reg <= 0x2D) || reg == 0x2F ||
+            reg == 0x31 || reg == 0x35 || reg == 0x39)
+        {
+            continue;
+        }
+        CHECK_EQ(rig->sim.regs[reg], image.regs[LIS2DE_IMAGE_INDEX(reg)]);
+    }
+}
+
+static void
+test_switch(void)
+{
+    test_rig_t rig;
+    uint32_t before;
+
+    test_rig_init(&rig, 400000);
+    lis2de_enable_shadow_registers(&rig.dev);
+
+    // Nothing is known yet: one write per writable run, no reads
+    before = transactions(&rig);
+    CHECK_EQ(lis2de_apply_profile(&rig.dev, &slow), 0);
+    CHECK_EQ(transactions(&rig) - before, WRITABLE_RUNS);
+    check_image(&rig, &slow);
+
+    // CTRL_REG1 and CTRL_REG4 share a run, CLICK_THS is in another one
+    before = transactions(&rig);
+    CHECK_EQ(lis2de_apply_profile(&rig.dev, &fast), 0);
+    CHECK_EQ(transactions(&rig) - before, 2);
+    check_image(&rig, &fast);
+
+    // The device already runs it
+    before = transactions(&rig);
+    CHECK_EQ(lis2de_apply_profile(&rig.dev, &fast), 0);
+    CHECK_EQ(transactions(&rig), before);
+
+    before = transactions(&rig);
+    CHECK_EQ(lis2de_apply_profile(&rig.dev, &slow), 0);
+    CHECK_EQ(transactions(&rig) - before, 2);
+    check_image(&rig, &slow);
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+static void
+test_setters(void)
+{
+    test_rig_t rig;
+    uint32_t before;
+
+    test_rig_init(&rig, 400000);
+    lis2de_enable_shadow_registers(&rig.dev);
+    CHECK_EQ(lis2de_apply_profile(&rig.dev, &slow), 0);
+
+    // The same kind of change made with setters, one write each
+    before = transactions(&rig);
+    lis2de_set_data_rate_to_400hz(&rig.dev);
+    lis2de_set_full_scale_to_8g(&rig.dev);
+    lis2de_set_click_threshold(&rig.dev, 60);
+    CHECK_EQ(transactions(&rig) - before, 3);
+    check_image(&rig, &fast);
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+int
+main(void)
+{
+    test_switch();
+    test_setters();
+    TEST_END();
+}
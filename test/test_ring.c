@@ -0,0 +1,78 @@
+/* Ring drain of the sensor FIFO: wrap-around of the free space, frames
+ * the ring has no room for left in the FIFO, a full ring leaving the
+ * bus alone, and an overrun FIFO counted as overflow. */
+
+#include "test.h"
+
+#include "lib/lis2de-driver/include/lis2de_ring.h"
+
+// Sample period at 400 Hz in ns
+#define PERIOD_400HZ 2500000ULL
+
+#define CAPACITY 8
+
+static void
+test_drain(void)
+{
+    test_rig_t rig;
+    lis2de_ring_t ring;
+    lis2de_data_t buf[CAPACITY];
+    lis2de_data_t sample;
+    uint32_t before;
+    uint8_t count;
+
+    test_rig_init(&rig, 400000);
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+    lis2de_set_data_rate_to_400hz(&rig.dev);
+    lis2de_set_fifo_mode_to_stream_mode(&rig.dev);
+    lis2de_enable_fifo(&rig.dev);
+    CHECK_EQ(lis2de_ring_init(&ring, buf, CAPACITY), 0);
+    lis2de_sim_bus_advance(&rig.sim_bus, 20 * PERIOD_400HZ);
+
+    // The ring takes 8 of the 20 frames, 12 stay in the FIFO and are not lost
+    before = rig.sim_bus.transactions;
+    count = lis2de_ring_drain_fifo(&ring, &rig.dev);
+    CHECK_EQ(count, CAPACITY);
+    CHECK_EQ(rig.sim_bus.transactions - before,
+             1 + (CAPACITY + LIS2DE_FIFO_BURST_FRAMES - 1) / LIS2DE_FIFO_BURST_FRAMES);
+    CHECK_EQ(ring.overflow, 0);
+    CHECK_EQ(lis2de_ring_count(&ring), CAPACITY);
+
+    // A full ring skips the drain without a bus transaction
+    before = rig.sim_bus.transactions;
+    CHECK_EQ(lis2de_ring_drain_fifo(&ring, &rig.dev), 0);
+    CHECK_EQ(rig.sim_bus.transactions, before);
+    CHECK_EQ(ring.skipped_drains, 1);
+    CHECK_EQ(ring.overflow, 0);
+
+    // Freed slots at the start of the buffer are filled after the wrap
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        CHECK(lis2de_ring_pop(&ring, &sample));
+        CHECK(test_is_sample(&sample, i));
+    }
+    count = lis2de_ring_drain_fifo(&ring, &rig.dev);
+    CHECK_EQ(count, 4);
+    CHECK_EQ(ring.overflow, 0);
+    for (uint8_t i = 4; i < 12; i++)
+    {
+        CHECK(lis2de_ring_pop(&ring, &sample));
+        CHECK(test_is_sample(&sample, i));
+    }
+    CHECK(!lis2de_ring_pop(&ring, &sample));
+
+    // Left alone, the FIFO overruns and the oldest frames are gone
+    lis2de_sim_bus_advance(&rig.sim_bus, 2 * LIS2DE_FIFO_DEPTH * PERIOD_400HZ);
+    CHECK_EQ(lis2de_ring_drain_fifo(&ring, &rig.dev), CAPACITY);
+    CHECK_EQ(ring.overflow, 1);
+    CHECK(lis2de_ring_pop(&ring, &sample));
+    CHECK(!test_is_sample(&sample, 12));
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+int
+main(void)
+{
+    test_drain();
+    TEST_END();
+}
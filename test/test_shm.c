@@ -0,0 +1,195 @@
+/* Shared-memory ring with a writer and a reader thread. A reader that
+ * keeps up gets every frame, whole and in order; one that cannot gets
+ * frames in order and learns about every other one from shm->lost. */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "test.h"
+
+#include "lib/lis2de-driver/include/lis2de_shm.h"
+
+#ifndef FRAMES
+#define FRAMES (1UL << 21)
+#endif
+#define BATCH  32
+
+typedef struct run
+{
+    char name[64];
+    uint32_t capacity;
+    // The writer stays within a lap of the reader when set
+    uint8_t paced;
+
+    _Atomic uint32_t read_next;
+    _Atomic uint8_t done;
+
+    // Reader results
+    uint32_t frames;
+    uint32_t lost;
+    uint32_t torn;
+    uint32_t disordered;
+} run_t;
+
+// Frame n carries n in its timestamp and spread over the axes
+static void
+make_frame(uint32_t n,
+           lis2de_shm_frame_t *frame)
+{
+    frame->t_us = n;
+    frame->data.x = (int8_t) n;
+    frame->data.y = (int8_t) (n >> 8);
+    frame->data.z = (int8_t) (n >> 16);
+}
+
+static uint8_t
+is_frame(const lis2de_shm_frame_t *frame)
+{
+    lis2de_shm_frame_t want;
+
+    make_frame((uint32_t) frame->t_us, &want);
+    return frame->t_us < FRAMES && frame->data.x == want.data.x &&
+           frame->data.y == want.data.y && frame->data.z == want.data.z;
+}
+
+static void *
+writer(void *arg)
+{
+    run_t *run = arg;
+    lis2de_shm_t shm;
+    lis2de_shm_frame_t batch[BATCH];
+
+    if (lis2de_shm_create(&shm, run->name, run->capacity))
+    {
+        perror("lis2de_shm_create");
+        atomic_store(&run->done, 2);
+        return 0;
+    }
+    // Wait for the reader to map the ring before the first frame
+    atomic_store(&run->done, 3);
+    while (atomic_load(&run->done) == 3)
+    {
+        sched_yield();
+    }
+
+    for (uint32_t n = 0; n < FRAMES; n += BATCH)
+    {
+        while (run->paced && n - atomic_load(&run->read_next) > run->capacity - BATCH)
+        {
+            sched_yield();
+        }
+        for (uint32_t i = 0; i < BATCH; i++)
+        {
+            make_frame(n + i, &batch[i]);
+        }
+        lis2de_shm_publish(&shm, batch, BATCH);
+    }
+    atomic_store(&run->done, 1);
+    // Readers keep their mapping after the object is removed
+    lis2de_shm_destroy(&shm);
+    return 0;
+}
+
+static void
+reader(run_t *run)
+{
+    lis2de_shm_t shm;
+    lis2de_shm_frame_t buf[BATCH / 4];
+    uint64_t last = 0;
+    uint8_t first = 1;
+
+    while (atomic_load(&run->done) != 3)
+    {
+        if (atomic_load(&run->done) == 2)
+        {
+            return;
+        }
+        sched_yield();
+    }
+    CHECK_EQ(lis2de_shm_open(&shm, run->name), 0);
+    atomic_store(&run->done, 0);
+
+    for (;;)
+    {
+        uint8_t done = atomic_load(&run->done);
+        uint32_t count = lis2de_shm_read(&shm, buf, BATCH / 4);
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            run->torn += !is_frame(&buf[i]);
+            run->disordered += !first && buf[i].t_us <= last;
+            last = buf[i].t_us;
+            first = 0;
+        }
+        run->frames += count;
+        atomic_store(&run->read_next, shm.next);
+        if (!count && done)
+        {
+            break;
+        }
+        if (!count)
+        {
+            sched_yield();
+        }
+    }
+    run->lost = shm.lost;
+    lis2de_shm_close(&shm);
+}
+
+static void
+run_pair(run_t *run,
+         const char *tag,
+         uint32_t capacity,
+         uint8_t paced)
+{
+    pthread_t thread;
+
+    snprintf(run->name, sizeof(run->name), "/lis2de-test-%s-%d", tag, (int) getpid());
+    run->capacity = capacity;
+    run->paced = paced;
+    atomic_store(&run->read_next, 0);
+    atomic_store(&run->done, 0);
+    run->frames = 0;
+    run->lost = 0;
+    run->torn = 0;
+    run->disordered = 0;
+
+    pthread_create(&thread, 0, writer, run);
+    reader(run);
+    pthread_join(thread, 0);
+}
+
+static void
+test_no_loss(void)
+{
+    run_t run;
+
+    run_pair(&run, "paced", 1024, 1);
+    CHECK_EQ(run.frames, FRAMES);
+    CHECK_EQ(run.lost, 0);
+    CHECK_EQ(run.torn, 0);
+    CHECK_EQ(run.disordered, 0);
+}
+
+static void
+test_lapped(void)
+{
+    run_t run;
+
+    // Nothing holds the writer back, the small ring is lapped again and again
+    run_pair(&run, "lapped", 64, 0);
+    CHECK_EQ(run.frames + run.lost, FRAMES);
+    CHECK_EQ(run.torn, 0);
+    CHECK_EQ(run.disordered, 0);
+}
+
+int
+main(void)
+{
+    test_no_loss();
+    test_lapped();
+    TEST_END();
+}
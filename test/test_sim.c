@@ -0,0 +1,471 @@
+/* Driver against the simulated device: burst reads, the FIFO address
+ * wrap at OUT_Z, reads across it with and without the shadow, BDU, the
+ * data-ready gated sample read, the FIFO drain, block writes split at
+ * the source registers, configuration batches and the error codes of a
+ * build without CException, with the bus transactions each of them
+ * takes. */
+
+#include "test.h"
+
+// Sample periods of the rates used below, in ns
+#define PERIOD_100HZ 10000000ULL
+#define PERIOD_400HZ 2500000ULL
+
+static uint32_t
+transactions(const test_rig_t *rig)
+{
+    return rig->sim_bus.transactions;
+}
+
+static void
+test_burst_read(void)
+{
+    test_rig_t rig;
+    lis2de_data_t data;
+    uint8_t regs[6];
+    uint32_t before;
+
+    test_rig_init(&rig, 400000);
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+    lis2de_set_data_rate_to_100hz(&rig.dev);
+    lis2de_sim_bus_advance(&rig.sim_bus, PERIOD_100HZ);
+
+    // All three axes come with one transaction
+    before = transactions(&rig);
+    data = lis2de_query_accel_data(&rig.dev);
+    CHECK_EQ(transactions(&rig) - before, 1);
+    CHECK(test_is_sample(&data, 0));
+
+    // Auto-increment over CTRL_REG1..CTRL_REG6
+    before = transactions(&rig);
+    lis2de_read_registers(&rig.dev, 0x20, regs, sizeof(regs));
+    CHECK_EQ(transactions(&rig) - before, 1);
+    for (uint8_t i = 0; i < sizeof(regs); i++)
+    {
+        CHECK_EQ(regs[i], rig.sim.regs[0x20 + i]);
+    }
+    CHECK_EQ(regs[0] >> 4, 0b0101);
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+static void
+test_fifo_wrap(void)
+{
+    test_rig_t rig;
+    lis2de_data_t buf[LIS2DE_FIFO_DEPTH];
+    uint8_t regs[7];
+    uint32_t before;
+    uint8_t count;
+
+    test_rig_init(&rig, 400000);
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+
+    // FIFO disabled: the pointer runs on from OUT_Z to FIFO_CTRL_REG
+    lis2de_set_fth(&rig.dev, 5);
+    lis2de_read_registers(&rig.dev, 0x28, regs, sizeof(regs));
+    CHECK_EQ(regs[6], 5);
+
+    lis2de_set_data_rate_to_400hz(&rig.dev);
+    lis2de_set_fifo_mode_to_stream_mode(&rig.dev);
+    lis2de_enable_fifo(&rig.dev);
+    lis2de_sim_bus_advance(&rig.sim_bus, 10 * PERIOD_400HZ);
+
+    // FIFO enabled: one burst of ten frames, wrapping at OUT_Z each time
+    before = transactions(&rig);
+    count = lis2de_read_fifo(&rig.dev, buf, LIS2DE_FIFO_DEPTH);
+    CHECK_EQ(count, 10);
+    CHECK_EQ(transactions(&rig) - before,
+             1 + (count + LIS2DE_FIFO_BURST_FRAMES - 1) / LIS2DE_FIFO_BURST_FRAMES);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        CHECK(test_is_sample(&buf[i], i));
+    }
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+// Reads across OUT_Z from before and after CTRL_REG5
+static void
+test_split_read(uint8_t fifo,
+                uint8_t shadow)
+{
+    test_rig_t rig;
+    uint8_t regs[11];
+    uint32_t before;
+    uint8_t known_off = shadow && !fifo;
+
+    test_rig_init(&rig, 400000);
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+    if (shadow)
+    {
+        lis2de_enable_shadow_registers(&rig.dev);
+        lis2de_shadow_registers_resync(&rig.dev);
+    }
+    lis2de_set_fth(&rig.dev, 5);
+    lis2de_set_data_rate_to_400hz(&rig.dev);
+    lis2de_set_fifo_mode_to_stream_mode(&rig.dev);
+    if (fifo)
+    {
+        lis2de_enable_fifo(&rig.dev);
+    }
+    lis2de_sim_bus_advance(&rig.sim_bus, 4 * PERIOD_400HZ);
+
+    // OUT_X_L..FIFO_SRC_REG: only a FIFO the shadow knows is off saves the split
+    before = transactions(&rig);
+    lis2de_read_registers(&rig.dev, 0x28, regs, 8);
+    CHECK_EQ(transactions(&rig) - before, known_off ? 1 : 2);
+    CHECK_EQ(regs[6], rig.sim.regs[0x2E]);
+    CHECK_EQ(regs[6] & 0x1F, 5);
+
+    // CTRL_REG5..FIFO_SRC_REG: CTRL_REG5 itself tells
+    before = transactions(&rig);
+    lis2de_read_registers(&rig.dev, 0x24, regs, 11);
+    CHECK_EQ(transactions(&rig) - before, fifo ? 2 : 1);
+    CHECK_EQ(regs[0], rig.sim.regs[0x24]);
+    CHECK_EQ(regs[10] & 0x1F, 5);
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+static void
+test_bdu(void)
+{
+    test_rig_t rig;
+
+    test_rig_init(&rig, 400000);
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+    lis2de_disable_continuos_block_data_update(&rig.dev);
+    lis2de_set_data_rate_to_100hz(&rig.dev);
+    lis2de_sim_bus_advance(&rig.sim_bus, PERIOD_100HZ);
+
+    // Sample 1 arrives between the reads of OUT_X and OUT_Z, BDU holds it back
+    CHECK_EQ((int8_t) lis2de_query_register(&rig.dev, 0x29), 0);
+    lis2de_sim_bus_advance(&rig.sim_bus, PERIOD_100HZ);
+    CHECK_EQ((int8_t) lis2de_query_register(&rig.dev, 0x2B), 64);
+    CHECK_EQ((int8_t) lis2de_query_register(&rig.dev, 0x2D), -128);
+
+    // Released once OUT_Z has been read
+    CHECK_EQ((int8_t) lis2de_query_register(&rig.dev, 0x29), 1);
+    CHECK_EQ((int8_t) lis2de_query_register(&rig.dev, 0x2B), 65);
+    CHECK_EQ((int8_t) lis2de_query_register(&rig.dev, 0x2D), -127);
+
+    // Without BDU the outputs change in the middle of a frame
+    lis2de_enable_continuos_block_data_update(&rig.dev);
+    lis2de_sim_bus_advance(&rig.sim_bus, PERIOD_100HZ);
+    CHECK_EQ((int8_t) lis2de_query_register(&rig.dev, 0x29), 2);
+    lis2de_sim_bus_advance(&rig.sim_bus, PERIOD_100HZ);
+    CHECK_EQ((int8_t) lis2de_query_register(&rig.dev, 0x2B), 67);
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+/* lis2de_try_read_sample(): STATUS_REG2 and the outputs in one burst,
+ * the outputs left alone without new data and a ZYXOR reported. */
+static void
+test_try_read(void)
+{
+    test_rig_t rig;
+    lis2de_data_t sample = {11, 22, 33};
+    lis2de_status_t status;
+    uint32_t before;
+    uint32_t bursts;
+
+    test_rig_init(&rig, 400000);
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+    lis2de_enable_continuos_block_data_update(&rig.dev);
+    lis2de_set_data_rate_to_100hz(&rig.dev);
+
+    before = transactions(&rig);
+    bursts = rig.dev.stats.reg_accesses[0x27];
+    CHECK_EQ(lis2de_try_read_sample(&rig.dev, &sample, &status), 0);
+    CHECK_EQ(transactions(&rig) - before, 1);
+    CHECK_EQ(rig.dev.stats.reg_accesses[0x27] - bursts, 1);
+    CHECK_EQ(status.zyx_new_data, 0);
+    CHECK(sample.x == 11 && sample.y == 22 && sample.z == 33);
+
+    lis2de_sim_bus_advance(&rig.sim_bus, PERIOD_100HZ);
+    before = transactions(&rig);
+    bursts = rig.dev.stats.reg_accesses[0x27];
+    CHECK_EQ(lis2de_try_read_sample(&rig.dev, &sample, &status), 1);
+    CHECK_EQ(transactions(&rig) - before, 1);
+    CHECK_EQ(rig.dev.stats.reg_accesses[0x27] - bursts, 1);
+    CHECK_EQ(status.zyx_new_data, 1);
+    CHECK_EQ(status.zyx_overrun, 0);
+    CHECK(test_is_sample(&sample, 0));
+
+    // Read along with the outputs, ZYXDA is clear until the next sample
+    CHECK_EQ(lis2de_try_read_sample(&rig.dev, &sample, 0), 0);
+    CHECK(test_is_sample(&sample, 0));
+
+    // Samples 2 and 3 replace unread ones
+    lis2de_sim_bus_advance(&rig.sim_bus, 3 * PERIOD_100HZ);
+    CHECK_EQ(lis2de_try_read_sample(&rig.dev, &sample, &status), 1);
+    CHECK_EQ(status.zyx_overrun, 1);
+    CHECK_EQ(rig.dev.stats.overruns, 1);
+    CHECK(test_is_sample(&sample, 3));
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+static void
+test_fifo_drain(void)
+{
+    test_rig_t rig;
+    lis2de_data_t buf[LIS2DE_FIFO_DEPTH];
+    lis2de_fifo_src_t src;
+    uint8_t count;
+
+    // Stream mode keeps the newest 32 frames and reports the overrun
+    test_rig_init(&rig, 400000);
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+    lis2de_set_data_rate_to_400hz(&rig.dev);
+    lis2de_set_fifo_mode_to_stream_mode(&rig.dev);
+    lis2de_enable_fifo(&rig.dev);
+    lis2de_sim_bus_advance(&rig.sim_bus, 40 * PERIOD_400HZ);
+
+    src = lis2de_query_fifo_src(&rig.dev);
+    CHECK(src.overrun);
+    CHECK_EQ(lis2de_fifo_src_frames(&src), LIS2DE_FIFO_DEPTH);
+    count = lis2de_read_fifo_frames(&rig.dev, &src, buf, LIS2DE_FIFO_DEPTH, 0, 0);
+    CHECK_EQ(count, LIS2DE_FIFO_DEPTH);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        CHECK(test_is_sample(&buf[i], 40 - LIS2DE_FIFO_DEPTH + i));
+    }
+    CHECK(!lis2de_query_fifo_overrun(&rig.dev));
+
+    // FIFO mode stops collecting once full and keeps the oldest frames
+    test_rig_init(&rig, 400000);
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+    lis2de_set_data_rate_to_400hz(&rig.dev);
+    lis2de_set_fifo_mode_to_fifo_mode(&rig.dev);
+    lis2de_enable_fifo(&rig.dev);
+    lis2de_sim_bus_advance(&rig.sim_bus, 40 * PERIOD_400HZ);
+
+    count = lis2de_read_fifo(&rig.dev, buf, LIS2DE_FIFO_DEPTH);
+    CHECK_EQ(count, LIS2DE_FIFO_DEPTH);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        CHECK(test_is_sample(&buf[i], i));
+    }
+
+    // A split destination is filled in order within the same drain
+    test_rig_init(&rig, 400000);
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+    lis2de_set_data_rate_to_400hz(&rig.dev);
+    lis2de_set_fifo_mode_to_stream_mode(&rig.dev);
+    lis2de_enable_fifo(&rig.dev);
+    lis2de_sim_bus_advance(&rig.sim_bus, 12 * PERIOD_400HZ);
+
+    count = lis2de_read_fifo_split(&rig.dev, &buf[20], 4, buf, 20);
+    CHECK_EQ(count, 12);
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        CHECK(test_is_sample(&buf[20 + i], i));
+    }
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        CHECK(test_is_sample(&buf[i], 4 + i));
+    }
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+// Register and length of each write that reached the bus
+static uint8_t write_reg[8];
+static uint8_t write_len[8];
+static uint8_t writes;
+
+static uint8_t
+logged_write(void *ctx,
+             uint8_t addr,
+             uint8_t reg,
+             const uint8_t *buf,
+             uint8_t len,
+             uint32_t timeout_us)
+{
+    if (writes < sizeof(write_reg))
+    {
+        write_reg[writes] = reg & 0x7F;
+        write_len[writes] = len;
+    }
+    writes++;
+    return lis2de_sim_bus_ops.write(ctx, addr, reg, buf, len, timeout_us);
+}
+
+/* IG1_CFG..Act_DUR written as one block: one transaction per run of
+ * writable registers, none of them covering IG1_SOURCE, IG2_SOURCE or
+ * CLICK_SRC. */
+static void
+test_block_write(void)
+{
+    static const uint8_t RUN_REG[] = {0x30, 0x32, 0x36, 0x3A};
+    static const uint8_t RUN_LEN[] = {1, 3, 3, 6};
+    test_rig_t rig;
+    lis2de_bus_ops_t ops = lis2de_sim_bus_ops;
+    uint8_t val[16];
+    uint32_t before;
+
+    test_rig_init(&rig, 400000);
+    ops.write = logged_write;
+    rig.bus.ops = &ops;
+    for (uint8_t i = 0; i < sizeof(val); i++)
+    {
+        val[i] = (uint8_t) (i + 1);
+    }
+
+    writes = 0;
+    before = transactions(&rig);
+    lis2de_write_registers(&rig.dev, 0x30, val, sizeof(val));
+    CHECK_EQ(transactions(&rig) - before, 4);
+    CHECK_EQ(writes, 4);
+    for (uint8_t i = 0; i < writes && i < 4; i++)
+    {
+        CHECK_EQ(write_reg[i], RUN_REG[i]);
+        CHECK_EQ(write_len[i], RUN_LEN[i]);
+    }
+    for (uint8_t reg = 0x30; reg <= 0x3F; reg++)
+    {
+        // The model ignores writes to sources, the log above shows there were none
+        if (reg != 0x31 && reg != 0x35 && reg != 0x39)
+        {
+            CHECK_EQ(rig.sim.regs[reg], val[reg - 0x30]);
+        }
+    }
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+/* Setters inside a batch stay off the bus, the commit writes each
+ * writable run that changed in one transaction, discard leaves the
+ * shadow as it was and a reboot drops the batch. */
+static void
+test_batch(void)
+{
+    test_rig_t rig;
+    uint32_t before;
+
+    test_rig_init(&rig, 400000);
+    lis2de_enable_shadow_registers(&rig.dev);
+    lis2de_shadow_registers_resync(&rig.dev);
+
+    before = transactions(&rig);
+    lis2de_begin_configuration(&rig.dev);
+    // CTRL_REG1..4, in the run TEMP_CFG_REG..REFERENCE
+    lis2de_set_data_rate_to_100hz(&rig.dev);
+    lis2de_set_high_pass_filter_cut_off_freq_to_16(&rig.dev);
+    lis2de_enable_drdy1_interrupt_on_int1(&rig.dev);
+    lis2de_set_full_scale_to_8g(&rig.dev);
+    // FIFO_CTRL_REG and IG1_CFG, either side of FIFO_SRC_REG
+    lis2de_set_fth(&rig.dev, 12);
+    lis2de_set_ig1_and_combination_of_interrupt_events(&rig.dev);
+    // IG1_THS to the value it holds, its run stays unwritten
+    lis2de_set_ig1_threshold(&rig.dev, 0);
+    lis2de_set_click_threshold(&rig.dev, 60);
+    CHECK_EQ(lis2de_query_full_scale_selection(&rig.dev), 0b10);
+    CHECK_EQ(lis2de_query_click_threshold(&rig.dev), 60);
+    CHECK_EQ(transactions(&rig) - before, 0);
+    CHECK_EQ(rig.sim.regs[0x20], 0x07);
+
+    lis2de_commit_configuration(&rig.dev);
+    CHECK_EQ(transactions(&rig) - before, 4);
+    CHECK_EQ(rig.sim.regs[0x20], 0x57);
+    CHECK_EQ(rig.sim.regs[0x21], 0x10);
+    CHECK_EQ(rig.sim.regs[0x22], 0x10);
+    CHECK_EQ(rig.sim.regs[0x23], 0x20);
+    CHECK_EQ(rig.sim.regs[0x2E], 12);
+    CHECK_EQ(rig.sim.regs[0x30], 0x80);
+    CHECK_EQ(rig.sim.regs[0x3A], 60);
+
+    // Discarded changes never reach the bus or the shadow
+    before = transactions(&rig);
+    lis2de_begin_configuration(&rig.dev);
+    lis2de_set_full_scale_to_16g(&rig.dev);
+    lis2de_set_click_threshold(&rig.dev, 20);
+    CHECK_EQ(lis2de_query_full_scale_selection(&rig.dev), 0b11);
+    lis2de_discard_configuration(&rig.dev);
+    CHECK_EQ(lis2de_query_full_scale_selection(&rig.dev), 0b10);
+    CHECK_EQ(lis2de_query_click_threshold(&rig.dev), 60);
+    lis2de_commit_configuration(&rig.dev);
+    CHECK_EQ(transactions(&rig) - before, 0);
+    CHECK_EQ(rig.sim.regs[0x23], 0x20);
+
+    // A reboot inside a batch drops it, the commit has nothing to write
+    lis2de_begin_configuration(&rig.dev);
+    lis2de_set_full_scale_to_16g(&rig.dev);
+    lis2de_reboot_memory_content(&rig.dev);
+    lis2de_sim_bus_advance(&rig.sim_bus, LIS2DE_SIM_BOOT_NS);
+    before = transactions(&rig);
+    lis2de_commit_configuration(&rig.dev);
+    CHECK_EQ(transactions(&rig) - before, 0);
+    CHECK_EQ(rig.sim.regs[0x23], 0);
+    CHECK_EQ(rig.sim.regs[0x24] & 0x80, 0);
+    CHECK_EQ(lis2de_query_full_scale_selection(&rig.dev), 0);
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+/* Without CException the first error sticks: later ones do not replace
+ * it and no bus traffic goes out until lis2de_clear_error(). */
+static void
+test_error_codes(void)
+{
+    test_rig_t rig;
+    lis2de_dev_t other;
+    uint32_t before;
+
+    test_rig_init(&rig, 400000);
+
+    // A stuck bus times out and is recovered, the error stays
+    lis2de_sim_bus_set_stuck(&rig.sim_bus, 1);
+    CHECK_EQ(lis2de_query_register(&rig.dev, 0x0F), 0);
+    CHECK_EQ(lis2de_query_error(&rig.dev), E_LIS2DE_I2C_TIMEOUT);
+    CHECK_EQ(rig.dev.stats.timeouts, 1);
+    CHECK_EQ(rig.sim_bus.stuck, 0);
+
+    before = transactions(&rig);
+    lis2de_set_data_rate_to_100hz(&rig.dev);
+    CHECK_EQ(lis2de_query_register(&rig.dev, 0x0F), 0);
+    lis2de_modify_register(&rig.dev, 0x27, 0xFF, 0);
+    CHECK_EQ(transactions(&rig) - before, 0);
+    CHECK_EQ(rig.sim.regs[0x20], 0x07);
+    CHECK_EQ(lis2de_query_error(&rig.dev), E_LIS2DE_I2C_TIMEOUT);
+
+    lis2de_clear_error(&rig.dev);
+    lis2de_set_data_rate_to_100hz(&rig.dev);
+    CHECK_EQ(rig.sim.regs[0x20], 0x57);
+    CHECK_EQ(lis2de_query_register(&rig.dev, 0x0F), LIS2DE_DEVICE_ID);
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+
+    // Nobody acknowledges the other address, a later stuck bus is not tried
+    lis2de_init(&other, &rig.bus, LIS2DE_ADDR_SA0_HIGH);
+    CHECK_EQ(lis2de_query_register(&other, 0x0F), 0);
+    CHECK_EQ(lis2de_query_error(&other), E_LIS2DE_I2C_WRITE);
+    lis2de_sim_bus_set_stuck(&rig.sim_bus, 1);
+    before = transactions(&rig);
+    lis2de_set_full_scale_to_8g(&other);
+    CHECK_EQ(transactions(&rig) - before, 0);
+    CHECK_EQ(lis2de_query_error(&other), E_LIS2DE_I2C_WRITE);
+    CHECK_EQ(other.stats.timeouts, 0);
+
+    // Errors are per device, the first one still reaches the stuck bus
+    lis2de_query_register(&rig.dev, 0x0F);
+    CHECK_EQ(lis2de_query_error(&rig.dev), E_LIS2DE_I2C_TIMEOUT);
+    lis2de_clear_error(&other);
+    CHECK_EQ(lis2de_query_register(&other, 0x0F), 0);
+    CHECK_EQ(lis2de_query_error(&other), E_LIS2DE_I2C_WRITE);
+}
+
+int
+main(void)
+{
+    test_burst_read();
+    test_fifo_wrap();
+    for (uint8_t fifo = 0; fifo < 2; fifo++)
+    {
+        for (uint8_t shadow = 0; shadow < 2; shadow++)
+        {
+            test_split_read(fifo, shadow);
+        }
+    }
+    test_bdu();
+    test_try_read();
+    test_fifo_drain();
+    test_block_write();
+    test_batch();
+    test_error_codes();
+    TEST_END();
+}
@@ -0,0 +1,103 @@
+/* Cold start against the simulated device: the times of the report
+ * are those of the bus clock, the boot and first-sample waits end
+ * within a poll or two of the events they wait for, and the first
+ * sample reported is one of the new configuration. */
+
+#include "test.h"
+
+#include "lib/lis2de-driver/include/lis2de_startup.h"
+
+// Sample period at 100 Hz in us
+#define PERIOD_US 10000UL
+
+/* One single-byte read at 400 kHz with its STARTs and STOP is well
+ * within this, so a wait may overshoot its event by no more */
+#define POLL_US 200UL
+
+static const lis2de_profile_t profile =
+{
+    .odr_hz = 100, .axes = LIS2DE_AXES_XYZ, .full_scale_g = 2,
+    .block_data_update = 1,
+};
+
+static uint32_t
+now_us(const test_rig_t *rig)
+{
+    return (uint32_t) (rig->sim_bus.now_ns / 1000);
+}
+
+// When the device produced its latest sample, on the bus clock
+static uint32_t
+sample_us(const test_rig_t *rig)
+{
+    return (uint32_t) ((rig->sim.next_sample_ns - PERIOD_US * 1000) / 1000);
+}
+
+static void
+test_reboot(void)
+{
+    test_rig_t rig;
+    lis2de_startup_report_t report;
+    uint32_t start;
+
+    test_rig_init(&rig, 400000);
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+    lis2de_enable_shadow_registers(&rig.dev);
+
+    start = now_us(&rig);
+    CHECK_EQ(lis2de_startup(&rig.dev, &profile, 1, &report), 0);
+    CHECK_EQ(report.device_id, LIS2DE_DEVICE_ID);
+
+    /* BOOT is seen clear within a poll of the reload, which starts
+     * after the read-modify-write of CTRL_REG5 */
+    CHECK(report.boot_us >= LIS2DE_SIM_BOOT_NS / 1000);
+    CHECK(report.boot_us <= LIS2DE_SIM_BOOT_NS / 1000 + 2 * POLL_US);
+    CHECK(report.config_us > report.boot_us);
+
+    // ZYXDA is seen within a poll of the first sample, then it is fetched
+    CHECK_EQ(rig.sim.sample_index, 1);
+    CHECK(report.first_sample_us >= sample_us(&rig) - start);
+    CHECK(report.first_sample_us <= sample_us(&rig) - start + POLL_US);
+    CHECK(report.first_sample_us - report.config_us <= PERIOD_US);
+    CHECK(now_us(&rig) - start <= report.first_sample_us + 2 * POLL_US);
+    CHECK(test_is_sample(&report.sample, 0));
+
+    // The polls of BOOT did not leave it in the shadow
+    CHECK_EQ(rig.sim.regs[0x24] & 0x80, 0);
+    CHECK_EQ(lis2de_query_reboot_memory_content(&rig.dev), 0);
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+static void
+test_warm(void)
+{
+    test_rig_t rig;
+    lis2de_startup_report_t report;
+    uint32_t start;
+    uint32_t index;
+
+    test_rig_init(&rig, 400000);
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+    lis2de_set_data_rate_to_400hz(&rig.dev);
+    lis2de_sim_bus_advance(&rig.sim_bus, 3 * PERIOD_US * 1000);
+
+    // A sample of the old configuration is pending and must not count
+    CHECK(lis2de_query_new_data_available_on_xyz_axes(&rig.dev));
+    index = rig.sim.sample_index;
+    start = now_us(&rig);
+    CHECK_EQ(lis2de_startup(&rig.dev, &profile, 0, &report), 0);
+    CHECK_EQ(report.boot_us, 0);
+    CHECK_EQ(rig.sim.sample_index, index + 1);
+    CHECK(report.first_sample_us >= sample_us(&rig) - start);
+    CHECK(report.first_sample_us <= sample_us(&rig) - start + POLL_US);
+    CHECK(test_is_sample(&report.sample, index));
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+int
+main(void)
+{
+    test_reboot();
+    test_warm();
+    TEST_END();
+}
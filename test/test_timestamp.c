@@ -0,0 +1,164 @@
+/* FIFO timestamps against the true sample times of the simulated
+ * device: the tracking loop has to find an ODR that is off by
+ * DRIFT_PPM from the nominal rate while drains come at irregular
+ * intervals, and must not take frames a failed burst gave away for
+ * frames still in the FIFO. */
+
+#include <stdlib.h>
+
+#include "test.h"
+
+#include "lib/lis2de-driver/include/lis2de_timestamp.h"
+
+#define DRIFT_PPM 3000
+#define DRAINS    2000
+
+// Nominal sample period at 400 Hz in ns
+#define PERIOD_400HZ 2500000ULL
+
+// Pseudo-random drain intervals, the same on every run
+static uint32_t
+next_random(uint32_t *state)
+{
+    *state = *state * 1103515245U + 12345U;
+    return *state >> 16;
+}
+
+static void
+test_drift(void)
+{
+    test_rig_t rig;
+    lis2de_timestamp_t ts;
+    lis2de_timed_data_t buf[LIS2DE_FIFO_DEPTH];
+    uint64_t true_period = (PERIOD_400HZ * 1000000ULL) / (1000000 + DRIFT_PPM);
+    uint64_t first_ns;
+    int64_t drift_sum = 0;
+    uint64_t error_sum = 0;
+    uint32_t error_count = 0;
+    uint32_t index = 0;
+    uint32_t state = 1;
+    uint32_t lost = 0;
+
+    test_rig_init(&rig, 400000);
+    rig.sim.odr_error_ppm = DRIFT_PPM;
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+    lis2de_set_fifo_mode_to_stream_mode(&rig.dev);
+    lis2de_enable_fifo(&rig.dev);
+    lis2de_set_data_rate_to_400hz(&rig.dev);
+    first_ns = rig.sim.next_sample_ns;
+    lis2de_timestamp_setup(&ts, &rig.dev);
+    CHECK_EQ(lis2de_timestamp_drift_ppm(&ts), 0);
+
+    for (uint32_t drain = 0; drain < DRAINS; drain++)
+    {
+        // Between 4 and 24 periods, well short of an overrun
+        uint64_t gap = (4 + next_random(&state) % 21) * PERIOD_400HZ;
+        uint8_t count;
+
+        lis2de_sim_bus_advance(&rig.sim_bus, gap);
+        count = lis2de_read_fifo_timed(&rig.dev, &ts, buf, LIS2DE_FIFO_DEPTH);
+        if (drain >= DRAINS / 2)
+        {
+            drift_sum += lis2de_timestamp_drift_ppm(&ts);
+        }
+        for (uint8_t i = 0; i < count; i++, index++)
+        {
+            int64_t error = (int64_t) buf[i].t_us * 1000 -
+                            (int64_t) (first_ns + index * true_period);
+
+            lost += !test_is_sample(&buf[i].data, index);
+            // The second half shows the loop after it settled
+            if (drain >= DRAINS / 2)
+            {
+                error_sum += (uint64_t) llabs(error);
+                error_count++;
+            }
+        }
+    }
+
+    CHECK_EQ(lost, 0);
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+    CHECK(error_count > 0);
+    if (error_count)
+    {
+        uint64_t mean_ns = error_sum / error_count;
+        int32_t drift = (int32_t) (drift_sum / (DRAINS / 2));
+
+        // The estimate settles near the true rate, within 10% of a period
+        printf("drift %d ppm, mean error %llu ns (%.1f%% of a period)\n",
+               (int) drift, (unsigned long long) mean_ns,
+               100.0 * mean_ns / true_period);
+        CHECK(abs(drift - DRIFT_PPM) < 300);
+        CHECK(mean_ns < true_period / 10);
+    }
+}
+
+// Fails the next FIFO burst after the device has clocked it out
+static uint8_t fail_burst;
+
+static uint8_t
+flaky_read(void *ctx,
+           uint8_t addr,
+           uint8_t reg,
+           uint8_t *buf,
+           uint8_t len,
+           uint32_t timeout_us)
+{
+    uint8_t err = lis2de_sim_bus_ops.read(ctx, addr, reg, buf, len, timeout_us);
+
+    if (!err && fail_burst && (reg & 0x7F) == 0x28)
+    {
+        fail_burst = 0;
+        err = E_LIS2DE_I2C_IO;
+    }
+    return err;
+}
+
+static void
+test_failed_burst(void)
+{
+    test_rig_t rig;
+    lis2de_timestamp_t ts;
+    lis2de_timed_data_t buf[LIS2DE_FIFO_DEPTH];
+    lis2de_bus_ops_t ops = lis2de_sim_bus_ops;
+    uint64_t last_ns;
+    uint8_t count;
+
+    test_rig_init(&rig, 400000);
+    ops.read = flaky_read;
+    rig.bus.ops = &ops;
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+    lis2de_set_fifo_mode_to_stream_mode(&rig.dev);
+    lis2de_enable_fifo(&rig.dev);
+    lis2de_set_data_rate_to_400hz(&rig.dev);
+    lis2de_timestamp_setup(&ts, &rig.dev);
+
+    lis2de_sim_bus_advance(&rig.sim_bus, 10 * PERIOD_400HZ);
+    CHECK_EQ(lis2de_read_fifo_timed(&rig.dev, &ts, buf, LIS2DE_FIFO_DEPTH), 10);
+
+    // The burst empties the FIFO but fails: nothing is left behind
+    lis2de_sim_bus_advance(&rig.sim_bus, 20 * PERIOD_400HZ);
+    fail_burst = 1;
+    CHECK_EQ(lis2de_read_fifo_timed(&rig.dev, &ts, buf, LIS2DE_FIFO_DEPTH), 0);
+    CHECK_EQ(lis2de_query_error(&rig.dev), E_LIS2DE_I2C_IO);
+    CHECK_EQ(ts.leftover, 0);
+    CHECK(rig.sim.fifo_count <= 1);
+    lis2de_clear_error(&rig.dev);
+
+    // The newest of the next frames is timed within a period of its sample
+    lis2de_sim_bus_advance(&rig.sim_bus, 6 * PERIOD_400HZ);
+    count = lis2de_read_fifo_timed(&rig.dev, &ts, buf, LIS2DE_FIFO_DEPTH);
+    CHECK(count >= 6);
+    last_ns = rig.sim.next_sample_ns - PERIOD_400HZ;
+    CHECK(count > 0 && (uint64_t) buf[count - 1].t_us * 1000 + PERIOD_400HZ > last_ns);
+    CHECK(count > 0 && (uint64_t) buf[count - 1].t_us * 1000 < last_ns + PERIOD_400HZ);
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+int
+main(void)
+{
+    test_drift();
+    test_failed_burst();
+    TEST_END();
+}
@@ -0,0 +1,178 @@
+/* Interrupt-driven TWI engine against the TWI model: transfers driven
+ * interrupt by interrupt, a callback chaining the next transfer, the
+ * blocking bus ops under the driver and the recovery of a stuck bus. */
+
+#include "test.h"
+
+#include "lib/lis2de-driver/include/lis2de_twi_async.h"
+#include "lib/lis2de-driver/include/lis2de_twi_model.h"
+
+// Bound on the interrupts one test may take before it counts as hung
+#define MAX_STEPS 1000
+
+typedef struct chain
+{
+    const lis2de_dev_t *dev;
+    lis2de_twi_xfer_t xfer;
+    uint8_t value;
+    uint8_t readback;
+    uint8_t calls;
+    uint8_t err;
+} chain_t;
+
+static void
+twi_rig_init(test_rig_t *rig)
+{
+    test_rig_init(rig, 400000);
+    lis2de_twi_model_attach(&rig->sim_bus);
+    lis2de_twi_async_init();
+}
+
+static void
+run_to_idle(void)
+{
+    for (uint32_t steps = 0; steps < MAX_STEPS && lis2de_twi_async_busy(); steps++)
+    {
+        lis2de_twi_model_step();
+    }
+}
+
+static void
+record(void *user,
+       uint8_t err)
+{
+    chain_t *chain = user;
+
+    chain->calls++;
+    chain->err |= err;
+}
+
+// Write CTRL_REG1 and submit its read back from the completion callback
+static void
+chain_written(void *user,
+              uint8_t err)
+{
+    chain_t *chain = user;
+
+    record(user, err);
+    chain->err |= lis2de_twi_async_read_bytes(chain->dev, &chain->xfer, 0x20,
+                                              &chain->readback, 1,
+                                              record, chain);
+}
+
+static void
+test_transfer(void)
+{
+    test_rig_t rig;
+    lis2de_twi_xfer_t xfer;
+    chain_t chain = { 0 };
+    uint8_t regs[6];
+
+    twi_rig_init(&rig);
+
+    // Auto-increment read of CTRL_REG1..CTRL_REG6, one interrupt per action
+    CHECK_EQ(lis2de_twi_async_read_bytes(&rig.dev, &xfer, 0x20, regs,
+                                         sizeof(regs), record, &chain), 0);
+    CHECK(lis2de_twi_async_busy());
+    CHECK_EQ(lis2de_twi_async_submit(&xfer), E_LIS2DE_I2C_BUSY);
+    run_to_idle();
+    CHECK_EQ(chain.calls, 1);
+    CHECK_EQ(chain.err, 0);
+    for (uint8_t i = 0; i < sizeof(regs); i++)
+    {
+        CHECK_EQ(regs[i], rig.sim.regs[0x20 + i]);
+    }
+    // START, SLA+W, reg, REP_START, SLA+R, 6 bytes
+    CHECK_EQ(lis2de_twi_model.interrupts, 5 + sizeof(regs));
+    CHECK_EQ(rig.sim_bus.transactions, 1);
+    CHECK_EQ(rig.sim_bus.busy, 0);
+
+    // A device that is not there NAKs its address
+    rig.dev.addr = LIS2DE_ADDR_SA0_HIGH;
+    chain.calls = 0;
+    CHECK_EQ(lis2de_twi_async_read_bytes(&rig.dev, &xfer, 0x0F, regs, 1,
+                                         record, &chain), 0);
+    run_to_idle();
+    CHECK_EQ(chain.calls, 1);
+    CHECK_EQ(chain.err, E_LIS2DE_I2C_WRITE);
+    CHECK(!lis2de_twi_async_busy());
+}
+
+static void
+test_chained(void)
+{
+    test_rig_t rig;
+    lis2de_twi_xfer_t xfer;
+    chain_t chain = { 0 };
+
+    twi_rig_init(&rig);
+    chain.dev = &rig.dev;
+    chain.value = 0x57;
+
+    // The read is submitted from the callback, right after the STOP
+    CHECK_EQ(lis2de_twi_async_write_bytes(&rig.dev, &xfer, 0x20, &chain.value,
+                                          1, chain_written, &chain), 0);
+    run_to_idle();
+    CHECK_EQ(chain.calls, 2);
+    CHECK_EQ(chain.err, 0);
+    CHECK_EQ(chain.readback, 0x57);
+    CHECK_EQ(rig.sim.regs[0x20], 0x57);
+    CHECK_EQ(lis2de_twi_model.lost_starts, 0);
+    CHECK_EQ(rig.sim_bus.transactions, 2);
+}
+
+static void
+test_blocking(void)
+{
+    test_rig_t rig;
+    lis2de_data_t data;
+
+    twi_rig_init(&rig);
+    lis2de_init(&rig.dev, &lis2de_twi_async_bus, LIS2DE_ADDR_SA0_LOW);
+    lis2de_sim_set_waveform(&rig.sim, test_waveform, 0);
+
+    CHECK_EQ(lis2de_query_device_id(&rig.dev), LIS2DE_DEVICE_ID);
+    lis2de_set_data_rate_to_100hz(&rig.dev);
+    CHECK_EQ(rig.sim.regs[0x20] >> 4, 0b0101);
+    lis2de_sim_bus_advance(&rig.sim_bus, 10000000ULL);
+    data = lis2de_query_accel_data(&rig.dev);
+    CHECK(test_is_sample(&data, 0));
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+}
+
+static void
+test_recover(void)
+{
+    test_rig_t rig;
+
+    twi_rig_init(&rig);
+    lis2de_init(&rig.dev, &lis2de_twi_async_bus, LIS2DE_ADDR_SA0_LOW);
+    lis2de_set_bus_timeout(&rig.dev, 1000);
+
+    // The START never completes, the timeout clocks the slave free
+    lis2de_sim_bus_set_stuck(&rig.sim_bus, 1);
+    lis2de_query_device_id(&rig.dev);
+    CHECK_EQ(lis2de_query_error(&rig.dev), E_LIS2DE_I2C_TIMEOUT);
+    CHECK_EQ(rig.sim_bus.stuck, 0);
+    CHECK(!lis2de_twi_async_busy());
+    CHECK(lis2de_twi_model.scl && lis2de_twi_model.sda);
+
+    lis2de_clear_error(&rig.dev);
+    CHECK_EQ(lis2de_query_device_id(&rig.dev), LIS2DE_DEVICE_ID);
+    CHECK_EQ(lis2de_query_error(&rig.dev), 0);
+
+    // The bus ops recovery does the same on a bus that hung elsewhere
+    lis2de_sim_bus_set_stuck(&rig.sim_bus, 1);
+    lis2de_twi_async_bus.ops->recover(lis2de_twi_async_bus.ctx);
+    CHECK_EQ(rig.sim_bus.stuck, 0);
+}
+
+int
+main(void)
+{
+    test_transfer();
+    test_chained();
+    test_blocking();
+    test_recover();
+    TEST_END();
+}